@@ -0,0 +1,126 @@
+/***********************************************************************
+ * Header:
+ *    ALIGNED ALLOCATOR
+ * Summary:
+ *    An allocator whose buffers start on an Alignment-byte boundary:
+ *    64 for a cache line, 128 for the pair of lines the prefetcher
+ *    fetches together, 4096 for a page. std::allocator only promises
+ *    alignof(std::max_align_t), which is 16, so a 32-byte AVX load of
+ *    a custom::vector<float> straddles two cache lines half the time,
+ *    and the ends of two vectors that belong to two threads can share
+ *    a line. Every buffer here is also rounded up to a whole number of
+ *    Alignment bytes, so nothing else lives in its last line.
+ *
+ *       custom::aligned_vector<float, 64> v;    // (size_t)v.data() % 64 == 0
+ *
+ *    Buffers from two megabytes up are aligned to a 2MB huge page, and
+ *    on Linux we ask for transparent huge pages with
+ *    madvise(MADV_HUGEPAGE), so a scan or a random walk through them
+ *    needs one TLB entry per 2MB instead of one per 4KB. That is only
+ *    advice: the kernel may have huge pages turned off. The benchmark
+ *    shows which, in the dtlb_misses column of BenchAligned's
+ *    read/random rows with --counters on.
+ *
+ *    This will contain the class definition of:
+ *        aligned_allocator      : An allocator for aligned buffers
+ *        aligned_vector         : A custom::vector with aligned storage
+ * Author
+ *    Stephen Costigan, Alexander Dohms, Jonathan Colwell, Shaun Crook
+ ************************************************************************/
+
+#pragma once
+
+#include <cstddef>     // for size_t
+#include <new>         // for std::align_val_t
+#include <type_traits> // for std::true_type
+#include "vector.h"
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <sys/mman.h>  // for madvise
+#endif
+
+namespace custom
+{
+
+/*****************************************
+ * ALIGNED ALLOCATOR
+ * Stateless, so any two with the same Alignment are equal
+ ****************************************/
+template <class T, size_t Alignment = 64>
+class aligned_allocator
+{
+   static_assert(Alignment > 0 && (Alignment & (Alignment - 1)) == 0,
+                 "the alignment must be a power of two");
+   static_assert(Alignment >= alignof(T),
+                 "the alignment must be at least the alignment of T");
+
+public:
+   typedef T value_type;
+   typedef std::true_type is_always_equal;
+
+   // the Alignment is not a type, so allocator_traits cannot rebind us
+   template <class U>
+   struct rebind { typedef aligned_allocator<U, Alignment> other; };
+
+   static const size_t alignment = Alignment;
+
+   // buffers of at least this many bytes are aligned to a huge page
+   static const size_t hugePageSize = 2 << 20;
+
+   aligned_allocator() {}
+   template <class U>
+   aligned_allocator(const aligned_allocator<U, Alignment> &) {}
+
+   T * allocate(size_t num)
+   {
+      size_t align = alignmentOf(num);
+      void * p = ::operator new(bytesOf(num), std::align_val_t(align));
+#ifdef MADV_HUGEPAGE
+      if (isHuge(num))
+         madvise(p, bytesOf(num), MADV_HUGEPAGE);
+#endif
+      return (T *)p;
+   }
+
+   void deallocate(T * p, size_t num)
+   {
+      ::operator delete((void *)p, std::align_val_t(alignmentOf(num)));
+   }
+
+   static bool isHuge(size_t num)
+   {
+      return num * sizeof(T) >= hugePageSize;
+   }
+
+#ifdef DEBUG // make this visible to the unit tests
+public:
+#else
+private:
+#endif
+
+   static size_t alignmentOf(size_t num)
+   {
+      return isHuge(num) && hugePageSize > Alignment ? hugePageSize : Alignment;
+   }
+
+   // whole blocks of the alignment, so no one else shares our last line
+   static size_t bytesOf(size_t num)
+   {
+      size_t align = alignmentOf(num);
+      return (num * sizeof(T) + align - 1) / align * align;
+   }
+};
+
+template <class T, class U, size_t Alignment>
+bool operator == (const aligned_allocator<T, Alignment> &, const aligned_allocator<U, Alignment> &) { return true; }
+template <class T, class U, size_t Alignment>
+bool operator != (const aligned_allocator<T, Alignment> &, const aligned_allocator<U, Alignment> &) { return false; }
+
+/*****************************************
+ * ALIGNED VECTOR
+ * A custom::vector whose data is Alignment-byte aligned
+ ****************************************/
+template <class T, size_t Alignment = 64>
+using aligned_vector = vector<T, aligned_allocator<T, Alignment>>;
+
+} // namespace custom
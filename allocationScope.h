@@ -0,0 +1,225 @@
+/***********************************************************************
+ * Header:
+ *    ALLOCATION SCOPE
+ * Summary:
+ *    Counts every allocation made with global operator new, whatever
+ *    made it, while a scope is alive on this thread:
+ *
+ *       AllocationScope scope;
+ *       custom::priority_queue<int> pq(std::move(v));
+ *       assertUnit(scope.numAlloc() == 0);           // heapify allocates nothing
+ *
+ *    A scope has the number of allocations and deallocations, the
+ *    bytes allocated, the bytes allocated less the bytes freed (live),
+ *    and the most that ever was (peak). Scopes nest: an allocation
+ *    counts in every scope open on the thread that made it. What other
+ *    threads do is not counted, so tests running at the same time do
+ *    not see each other. The unit test assertions pause the counting,
+ *    so checking one count does not change the next.
+ *
+ *    The counting is done by replacing the global operator new and
+ *    operator delete, which a program may do only once. So it is opt
+ *    in: exactly one source file of a program defines
+ *    TRACK_ALLOCATIONS before it includes anything, and that file gets
+ *    the replacements. Without them a scope counts nothing, and
+ *    AllocationScope::installed() is false so a budget can tell.
+ *    Each block carries a small header with its size, so a tracked
+ *    program uses a little more memory than an untracked one.
+ *
+ *    This will contain the class definition of:
+ *        AllocationScope      : Allocation counts for a stretch of code
+ * Author
+ *    Stephen Costigan, Alexander Dohms, Jonathan Colwell, Shaun Crook
+ ************************************************************************/
+
+#pragma once
+
+#include <cstddef>   // for size_t
+
+/*************************************************************
+ * ALLOCATION SCOPE
+ * Allocations on this thread from construction to destruction.
+ * Scopes on a thread must end in the reverse order they began,
+ * which they do as local variables.
+ *************************************************************/
+class AllocationScope
+{
+public:
+   AllocationScope() : nAlloc(0), nDelete(0), nBytes(0), nLive(0), nPeak(0), outer(innermost())
+   {
+      innermost() = this;
+   }
+   ~AllocationScope()
+   {
+      innermost() = outer;
+   }
+   AllocationScope(const AllocationScope &) = delete;
+   AllocationScope & operator = (const AllocationScope &) = delete;
+
+   size_t    numAlloc()       const { return nAlloc;  }
+   size_t    numDelete()      const { return nDelete; }
+   size_t    bytesAllocated() const { return nBytes;  }
+   long long bytesLive()      const { return nLive;   } // less than 0 if older blocks were freed
+   long long bytesPeak()      const { return nPeak;   }
+
+   // nothing this thread allocates counts while one of these is alive,
+   // so a test can check a budget without its checking counting
+   class Pause
+   {
+   public:
+      Pause() : saved(innermost()) { innermost() = nullptr; }
+      ~Pause()                     { innermost() = saved;   }
+      Pause(const Pause &) = delete;
+      Pause & operator = (const Pause &) = delete;
+   private:
+      AllocationScope * saved;
+   };
+
+   // whether operator new has been replaced so scopes count anything
+   static bool & installed()
+   {
+      static bool isInstalled = false;
+      return isInstalled;
+   }
+
+   // called by the replacement operators only
+   static void allocated(size_t bytes)
+   {
+      for (AllocationScope * scope = innermost(); scope; scope = scope->outer)
+      {
+         scope->nAlloc++;
+         scope->nBytes += bytes;
+         scope->nLive += (long long)bytes;
+         if (scope->nLive > scope->nPeak)
+            scope->nPeak = scope->nLive;
+      }
+   }
+   static void freed(size_t bytes)
+   {
+      for (AllocationScope * scope = innermost(); scope; scope = scope->outer)
+      {
+         scope->nDelete++;
+         scope->nLive -= (long long)bytes;
+      }
+   }
+
+private:
+   size_t            nAlloc;
+   size_t            nDelete;
+   size_t            nBytes;
+   long long         nLive;
+   long long         nPeak;
+   AllocationScope * outer;   // the scope this one is inside, if any
+
+   // the most recent scope on this thread. A plain pointer, so it is
+   // safe to use from operator new at any point in a thread's life.
+   static AllocationScope *& innermost()
+   {
+      static thread_local AllocationScope * scope = nullptr;
+      return scope;
+   }
+};
+
+#ifdef TRACK_ALLOCATIONS
+
+#include <cstdlib>   // for std::malloc, std::free
+#include <cstdint>   // for uintptr_t, SIZE_MAX
+#include <new>       // for std::bad_alloc, std::align_val_t
+
+/*************************************************************
+ * The replacements. Every block starts with a header holding its
+ * size and where malloc() put it; the caller gets what follows.
+ * Every form is replaced, array, nothrow, sized, and aligned,
+ * rather than leaving some to the library: a sanitizer's versions
+ * of those would not call ours.
+ *************************************************************/
+namespace allocationScopeDetail
+{
+   struct Header
+   {
+      void * block;   // what malloc() returned
+      size_t size;    // what the caller asked for
+   };
+   const size_t headerSize = alignof(std::max_align_t) > sizeof(Header) ?
+                             alignof(std::max_align_t) : sizeof(Header);
+
+   // malloc() enough for size bytes aligned to align, and a header
+   inline void * allocate(size_t size, std::align_val_t alignment = std::align_val_t(alignof(std::max_align_t)))
+   {
+      size_t align = (size_t)alignment;
+      size_t extra = headerSize + (align > alignof(std::max_align_t) ? align : 0);
+      if (size > SIZE_MAX - extra)
+         throw std::bad_alloc();   // size + extra would wrap to a small block
+      void * block;
+      while ((block = std::malloc(size + extra)) == nullptr)
+      {
+         std::new_handler handler = std::get_new_handler();
+         if (!handler)
+            throw std::bad_alloc();
+         handler();
+      }
+      uintptr_t p = (uintptr_t)block + headerSize;
+      p = (p + align - 1) & ~(uintptr_t)(align - 1);
+      Header * header = (Header *)p - 1;
+      header->block = block;
+      header->size  = size;
+      AllocationScope::allocated(size);
+      return (void *)p;
+   }
+
+   inline void deallocate(void * p) noexcept
+   {
+      if (!p)
+         return;
+      Header * header = (Header *)p - 1;
+      AllocationScope::freed(header->size);
+      std::free(header->block);
+   }
+
+   const bool installed = (AllocationScope::installed() = true);
+}
+
+// new
+void * operator new  (size_t size)                           { return allocationScopeDetail::allocate(size);        }
+void * operator new[](size_t size)                           { return allocationScopeDetail::allocate(size);        }
+void * operator new  (size_t size, std::align_val_t align)   { return allocationScopeDetail::allocate(size, align); }
+void * operator new[](size_t size, std::align_val_t align)   { return allocationScopeDetail::allocate(size, align); }
+void * operator new  (size_t size, const std::nothrow_t &) noexcept
+{
+   try { return allocationScopeDetail::allocate(size); } catch (...) { return nullptr; }
+}
+void * operator new[](size_t size, const std::nothrow_t &) noexcept
+{
+   try { return allocationScopeDetail::allocate(size); } catch (...) { return nullptr; }
+}
+void * operator new  (size_t size, std::align_val_t align, const std::nothrow_t &) noexcept
+{
+   try { return allocationScopeDetail::allocate(size, align); } catch (...) { return nullptr; }
+}
+void * operator new[](size_t size, std::align_val_t align, const std::nothrow_t &) noexcept
+{
+   try { return allocationScopeDetail::allocate(size, align); } catch (...) { return nullptr; }
+}
+
+// delete: the header knows the size and the alignment, so every
+// form is the same
+void operator delete  (void * p) noexcept                                     { allocationScopeDetail::deallocate(p); }
+void operator delete[](void * p) noexcept                                     { allocationScopeDetail::deallocate(p); }
+void operator delete  (void * p, size_t) noexcept                             { allocationScopeDetail::deallocate(p); }
+void operator delete[](void * p, size_t) noexcept                             { allocationScopeDetail::deallocate(p); }
+void operator delete  (void * p, std::align_val_t) noexcept                   { allocationScopeDetail::deallocate(p); }
+void operator delete[](void * p, std::align_val_t) noexcept                   { allocationScopeDetail::deallocate(p); }
+void operator delete  (void * p, size_t, std::align_val_t) noexcept           { allocationScopeDetail::deallocate(p); }
+void operator delete[](void * p, size_t, std::align_val_t) noexcept           { allocationScopeDetail::deallocate(p); }
+void operator delete  (void * p, const std::nothrow_t &) noexcept             { allocationScopeDetail::deallocate(p); }
+void operator delete[](void * p, const std::nothrow_t &) noexcept             { allocationScopeDetail::deallocate(p); }
+void operator delete  (void * p, std::align_val_t, const std::nothrow_t &) noexcept
+{
+   allocationScopeDetail::deallocate(p);
+}
+void operator delete[](void * p, std::align_val_t, const std::nothrow_t &) noexcept
+{
+   allocationScopeDetail::deallocate(p);
+}
+
+#endif // TRACK_ALLOCATIONS
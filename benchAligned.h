@@ -0,0 +1,116 @@
+/***********************************************************************
+ * Header:
+ *    BENCH ALIGNED
+ * Summary:
+ *    What the alignment of a vector's buffer does to the SIMD
+ *    kernels and to the TLB. "scan" is simd::sum() over the whole
+ *    buffer at the best instruction set the CPU has, starting at:
+ *
+ *       aligned/64 : a cache line boundary, from aligned_vector
+ *       offset/16  : 16 bytes past one, all std::allocator promises;
+ *                    every other 32-byte load spans two lines
+ *       offset/4   : 4 bytes past one, as a vector<float> inside a
+ *                    struct may be
+ *       custom     : wherever custom::vector's std::allocator put it
+ *
+ *    "read/random" sums elements picked at random, which costs a TLB
+ *    miss each once the buffer is bigger than the TLB covers:
+ *
+ *       custom      : custom::vector, on 4KB pages
+ *       aligned/64  : aligned_vector, on 2MB pages from 2MB up if
+ *                     transparent huge pages are on
+ *
+ *    Run with --counters for the misses themselves: the dtlb_misses
+ *    column of the two read/random rows is the TLB misses per element,
+ *    and the difference in their ns_per_op at the big sizes is the
+ *    time those misses cost. ns_per_op is per element.
+ * Author
+ *    Stephen Costigan, Alexander Dohms, Jonathan Colwell, Shaun Crook
+ ************************************************************************/
+
+#pragma once
+
+#include "vector.h"
+#include "aligned_allocator.h"
+#include "simd.h"
+#include "benchmark.h"
+
+class BenchAligned : public Benchmark
+{
+public:
+   BenchAligned(size_t maxSize) : Benchmark("Aligned", maxSize) {}
+
+   void run()
+   {
+      custom::simd::set_level(custom::simd::supported());
+      for (size_t size : sizes())
+      {
+         runScan<int>  ("int",   size);
+         runScan<float>("float", size);
+         bench_random <custom::vector<int>>        ("custom",     size);
+         bench_random <custom::aligned_vector<int>>("aligned/64", size);
+      }
+   }
+
+private:
+
+   template <class T>
+   void runScan(const char * payload, size_t size)
+   {
+      // room to slide the elements up to a cache line past the start
+      custom::aligned_vector<T, 64> buffer;
+      buffer.resize(size + 64 / sizeof(T));
+      bench_scan(buffer.data(),                     size, "aligned/64", payload);
+      bench_scan(buffer.data() + 16 / sizeof(T),    size, "offset/16",  payload);
+      bench_scan(buffer.data() + 4 / sizeof(T),     size, "offset/4",   payload);
+
+      custom::vector<T> v;
+      v.resize(size);
+      bench_scan(v.data(), size, "custom", payload);
+   }
+
+   /***************************************
+    * SCAN
+    * simd::sum() over size elements from first
+    ***************************************/
+   template <class T>
+   void bench_scan(const T * first, size_t size, const char * container, const char * payload)
+   {
+      size_t num = rounds(size);
+      double ns = measure([&]()
+      {
+         for (size_t r = 0; r < num; r++)
+            keep(custom::simd::sum(first, first + size));
+      });
+      record("scan", container, payload, size, ns, num * size);
+   }
+
+   /***************************************
+    * RANDOM
+    * Sum as many elements as there are, picked at random
+    ***************************************/
+   template <class Vector>
+   void bench_random(const char * container, size_t size)
+   {
+      Vector v;
+      for (size_t i = 0; i < size; i++)
+         v.push_back(make<int>((unsigned int)i));
+
+      size_t num = rounds(size);
+      double ns = measure([&]()
+      {
+         unsigned long long index = 1;
+         for (size_t r = 0; r < num; r++)
+         {
+            long long total = 0;
+            for (size_t i = 0; i < size; i++)
+            {
+               index = index * 6364136223846793005ull + 1442695040888963407ull;
+               total += v[(size_t)((index >> 33) % size)];
+            }
+            keep(total);
+         }
+      });
+      record("read/random", container, "int", size, ns, num * size);
+   }
+};
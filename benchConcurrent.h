@@ -0,0 +1,191 @@
+/***********************************************************************
+ * Header:
+ *    BENCH CONCURRENT
+ * Summary:
+ *    Many ingest threads appending into one shared container, then
+ *    handing it to a priority queue, on:
+ *
+ *       custom/mutex : custom::vector behind a std::mutex
+ *       concurrent   : concurrent_vector, no lock
+ *
+ *    "push_back/N" is N threads appending --size elements between
+ *    them, thread start and join included; ns_per_op is per element,
+ *    so a row that scales stays flat as N doubles. "heapify" is
+ *    building the priority queue afterwards, freeze() included for
+ *    the concurrent_vector. Run with --threads 64 for the full sweep.
+ *
+ *    The same again with Spy, counting instead of timing: "moves/N"
+ *    is the moves per element of the N-thread append, and
+ *    "heapify_compares/N" and "heapify_moves/N" those of building the
+ *    queue, freeze() included. Spy::total() adds up the counts of every
+ *    ingest thread once they are joined. These rows have the count in
+ *    the value column.
+ * Author
+ *    Stephen Costigan, Alexander Dohms, Jonathan Colwell, Shaun Crook
+ ************************************************************************/
+
+#pragma once
+
+#include "vector.h"
+#include "concurrent_vector.h"
+#include "priority_queue.h"
+#include "benchmark.h"
+
+#include <mutex>    // for std::mutex
+#include <string>
+#include <thread>   // for std::thread
+#include <vector>
+
+class BenchConcurrent : public Benchmark
+{
+public:
+   BenchConcurrent(size_t maxSize, size_t maxThreads) :
+      Benchmark("Concurrent", maxSize), maxThreads(maxThreads) {}
+
+   void run()
+   {
+      size_t size = maxSize;
+      for (size_t numThreads : threadCounts(maxThreads))
+      {
+         bench_mutex(size, numThreads);
+         bench_concurrent(size, numThreads);
+         count_mutex(size, numThreads);
+         count_concurrent(size, numThreads);
+      }
+   }
+
+private:
+   size_t maxThreads;
+
+   static double numMoves()
+   {
+      return (double)(Spy::total(COPY_MOVE) + Spy::total(ASSIGN_MOVE));
+   }
+
+   // record the moves of the append, then heapify and record its cost
+   template <class Build>
+   void recordCounts(const char * container, size_t size, size_t numThreads, Build build)
+   {
+      std::string suffix = "/" + std::to_string(numThreads);
+      recordValue("moves" + suffix, container, "spy", size, numMoves() / (double)size);
+      Spy::resetTotal();
+      {
+         custom::priority_queue<Spy> pq(build());
+         keep(pq);
+      }
+      recordValue("heapify_compares" + suffix, container, "spy", size,
+                  (double)Spy::total(LESSTHAN) / (double)size);
+      recordValue("heapify_moves" + suffix, container, "spy", size, numMoves() / (double)size);
+   }
+
+   // run append(first, last) on numThreads threads, size elements between them
+   template <class Append>
+   static void onThreads(size_t size, size_t numThreads, Append append)
+   {
+      std::vector<std::thread> threads;
+      for (size_t t = 0; t < numThreads; t++)
+         threads.emplace_back(append, size * t / numThreads, size * (t + 1) / numThreads);
+      for (auto & thread : threads)
+         thread.join();
+   }
+
+   /***************************************
+    * MUTEX
+    * Every push_back() takes the lock
+    ***************************************/
+   void bench_mutex(size_t size, size_t numThreads)
+   {
+      custom::vector<int> v;
+      std::mutex m;
+      double ns = measure([&]()
+      {
+         v = custom::vector<int>();
+      }, [&]()
+      {
+         onThreads(size, numThreads, [&v, &m](size_t first, size_t last)
+         {
+            for (size_t i = first; i < last; i++)
+            {
+               int value = make<int>((unsigned int)(i * 2654435761u));
+               std::lock_guard<std::mutex> lock(m);
+               v.push_back(value);
+            }
+         });
+      });
+      record("push_back/" + std::to_string(numThreads), "custom/mutex", "int", size, ns, size);
+
+      // once: the elements are gone afterwards
+      ns = measure([]() {}, [&]()
+      {
+         custom::priority_queue<int> pq(std::move(v));
+         keep(pq);
+      }, 1);
+      record("heapify/" + std::to_string(numThreads), "custom/mutex", "int", size, ns, size);
+   }
+
+   /***************************************
+    * CONCURRENT
+    * No lock: each push_back() claims its own index
+    ***************************************/
+   void bench_concurrent(size_t size, size_t numThreads)
+   {
+      custom::concurrent_vector<int> v;
+      double ns = measure([&]()
+      {
+         v.clear();
+      }, [&]()
+      {
+         onThreads(size, numThreads, [&v](size_t first, size_t last)
+         {
+            for (size_t i = first; i < last; i++)
+               v.push_back(make<int>((unsigned int)(i * 2654435761u)));
+         });
+      });
+      record("push_back/" + std::to_string(numThreads), "concurrent", "int", size, ns, size);
+
+      // once: the elements are gone afterwards
+      ns = measure([]() {}, [&]()
+      {
+         custom::priority_queue<int> pq(v.freeze());
+         keep(pq);
+      }, 1);
+      record("heapify/" + std::to_string(numThreads), "concurrent", "int", size, ns, size);
+   }
+
+   /***************************************
+    * COUNT MUTEX
+    * The mutex append and its heapify, with Spy
+    ***************************************/
+   void count_mutex(size_t size, size_t numThreads)
+   {
+      custom::vector<Spy> v;
+      std::mutex m;
+      Spy::resetTotal();
+      onThreads(size, numThreads, [&v, &m](size_t first, size_t last)
+      {
+         for (size_t i = first; i < last; i++)
+         {
+            Spy value = make<Spy>((unsigned int)(i * 2654435761u));
+            std::lock_guard<std::mutex> lock(m);
+            v.push_back(std::move(value));
+         }
+      });
+      recordCounts("custom/mutex", size, numThreads, [&v]() { return std::move(v); });
+   }
+
+   /***************************************
+    * COUNT CONCURRENT
+    * The lock-free append and its heapify, with Spy
+    ***************************************/
+   void count_concurrent(size_t size, size_t numThreads)
+   {
+      custom::concurrent_vector<Spy> v;
+      Spy::resetTotal();
+      onThreads(size, numThreads, [&v](size_t first, size_t last)
+      {
+         for (size_t i = first; i < last; i++)
+            v.push_back(make<Spy>((unsigned int)(i * 2654435761u)));
+      });
+      recordCounts("concurrent", size, numThreads, [&v]() { return v.freeze(); });
+   }
+};
@@ -0,0 +1,107 @@
+/***********************************************************************
+ * Header:
+ *    BENCH COW
+ * Summary:
+ *    What taking snapshots of a priority queue costs the thread that
+ *    keeps changing it, on:
+ *
+ *       custom     : priority_queue on custom::vector; a copy is deep
+ *       custom/cow : cow_priority_queue; a copy shares the buffer and
+ *                    the next push() or pop() clones it
+ *
+ *    "snapshot" is the time to make one copy, which is how long a
+ *    monitor holds the writer's lock. "mutate/every_N" is the time of
+ *    one push() and pop() pair when a snapshot is taken every N pairs
+ *    and held until the next one, copies and clones included.
+ * Author
+ *    Stephen Costigan, Alexander Dohms, Jonathan Colwell, Shaun Crook
+ ************************************************************************/
+
+#pragma once
+
+#include "priority_queue.h"
+#include "cow_vector.h"
+#include "benchmark.h"
+
+#include <algorithm>  // for std::min
+#include <string>
+
+class BenchCow : public Benchmark
+{
+public:
+   BenchCow(size_t maxSize) : Benchmark("Cow", maxSize) {}
+
+   void run()
+   {
+      for (size_t size : sizes())
+      {
+         runQueue <custom::priority_queue<int>>    ("custom",     size);
+         runQueue <custom::cow_priority_queue<int>>("custom/cow", size);
+      }
+   }
+
+private:
+
+   template <class PQueue>
+   void runQueue(const char * container, size_t size)
+   {
+      bench_snapshot<PQueue>(container, size);
+      for (size_t period = 1; period <= 1000; period *= 10)
+         bench_mutate<PQueue>(container, size, period);
+   }
+
+   template <class PQueue>
+   static void fill(PQueue & pq, size_t size)
+   {
+      for (size_t i = 0; i < size; i++)
+         pq.push(make<int>((unsigned int)(i * 2654435761u)));
+   }
+
+   /***************************************
+    * SNAPSHOT
+    * Copy a queue of size items
+    ***************************************/
+   template <class PQueue>
+   void bench_snapshot(const char * container, size_t size)
+   {
+      PQueue pq;
+      fill(pq, size);
+      size_t num = rounds(size);
+      double ns = measure([&]()
+      {
+         for (size_t r = 0; r < num; r++)
+         {
+            PQueue snapshot(pq);
+            keep(snapshot);
+         }
+      });
+      record("snapshot", container, "int", size, ns, num);
+   }
+
+   /***************************************
+    * MUTATE
+    * push() and pop() pairs with a snapshot every period of them
+    ***************************************/
+   template <class PQueue>
+   void bench_mutate(const char * container, size_t size, size_t period)
+   {
+      // a few hundred thousand elements copied, at most a million pairs
+      size_t numSnapshots = std::max<size_t>(1, std::min<size_t>((1 << 18) / size, (1 << 20) / period));
+      size_t num = numSnapshots * period;
+      PQueue pq;
+      fill(pq, size);
+      double ns = measure([&]()
+      {
+         PQueue snapshot;
+         for (size_t r = 0; r < num; r++)
+         {
+            if (r % period == 0)
+               snapshot = pq;
+            pq.push(make<int>((unsigned int)(r * 40503u)));
+            pq.pop();
+         }
+         keep(snapshot);
+      });
+      record("mutate/every_" + std::to_string(period), container, "int", size, ns, num);
+   }
+};
@@ -0,0 +1,88 @@
+/***********************************************************************
+ * Header:
+ *    BENCH GROWTH
+ * Summary:
+ *    The latency of every single push_back(), not the average. Each
+ *    growth policy, the incremental vector, and std::vector fill an
+ *    empty vector one element at a time while every call is timed
+ *    into a latency_histogram. The rows are percentiles: ns_per_op
+ *    of "push_back/p99" is the 99th percentile latency in ns.
+ *
+ *    The mean hides the one push_back() in n that moves everything;
+ *    "push_back/max" does not.
+ * Author
+ *    Stephen Costigan, Alexander Dohms, Jonathan Colwell, Shaun Crook
+ ************************************************************************/
+
+#pragma once
+
+#include "vector.h"
+#include "incremental_vector.h"
+#include "latency.h"     // for latency_histogram
+#include "benchmark.h"
+
+#include <vector>
+
+class BenchGrowth : public Benchmark
+{
+public:
+   BenchGrowth(size_t maxSize) : Benchmark("Growth", maxSize) {}
+
+   void run()
+   {
+      runPayload<int>();
+      runPayload<Payload64>();
+   }
+
+private:
+
+   template <class T>
+   void runPayload()
+   {
+      typedef std::allocator<T> A;
+      for (size_t size : sizes())
+      {
+         bench_latency <custom::vector<T, A, custom::default_instrument, custom::growth::factor_2>>
+            ("custom/x2", payloadName<T>(), size);
+         bench_latency <custom::vector<T, A, custom::default_instrument, custom::growth::factor_1_5>>
+            ("custom/x1.5", payloadName<T>(), size);
+         bench_latency <custom::vector<T, A, custom::default_instrument, custom::growth::page_rounded<>>>
+            ("custom/page", payloadName<T>(), size);
+         bench_latency <custom::incremental_vector<T>>
+            ("incremental", payloadName<T>(), size);
+         bench_latency <std::vector<T>>
+            ("std", payloadName<T>(), size);
+      }
+   }
+
+   /***************************************
+    * LATENCY
+    * Time each push_back() of filling a vector to size,
+    * enough times over to see at least a million calls
+    ***************************************/
+   template <class Vector>
+   void bench_latency(const char * container, const char * payload, size_t size)
+   {
+      typedef typename Vector::value_type T;
+      size_t num = rounds(size);
+      custom::latency_histogram histogram;
+      for (size_t r = 0; r < num; r++)
+      {
+         Vector v;
+         for (size_t i = 0; i < size; i++)
+         {
+            T t = make<T>((unsigned int)i);
+            uint64_t begin = custom::steady_clock_source::now();
+            v.push_back(t);
+            uint64_t end = custom::steady_clock_source::now();
+            histogram.record(end - begin);
+         }
+         keep(v);
+      }
+
+      record("push_back/p50",   container, payload, size, (double)histogram.percentile(50.0), 1);
+      record("push_back/p99",   container, payload, size, (double)histogram.percentile(99.0), 1);
+      record("push_back/p99.9", container, payload, size, (double)histogram.percentile(99.9), 1);
+      record("push_back/max",   container, payload, size, (double)histogram.max(),            1);
+   }
+};
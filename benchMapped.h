@@ -0,0 +1,105 @@
+/***********************************************************************
+ * Header:
+ *    BENCH MAPPED
+ * Summary:
+ *    Sequential and random access to the elements of:
+ *
+ *       custom          : custom::vector, on the heap
+ *       mapped          : mapped_vector, in a temporary file
+ *       mapped/advised  : mapped_vector, told what is coming with
+ *                         advise(sequential) or advise(random)
+ *
+ *    "fill" is push_back() to size, "read/sequential" sums every
+ *    element in order, and "read/random" sums as many elements
+ *    picked at random. ns_per_op is per element. On a machine with
+ *    enough RAM the file stays in the page cache; run with --size
+ *    past the RAM to see the disk.
+ * Author
+ *    Stephen Costigan, Alexander Dohms, Jonathan Colwell, Shaun Crook
+ ************************************************************************/
+
+#pragma once
+
+#include "vector.h"
+#include "mapped_vector.h"
+#include "benchmark.h"
+
+#ifdef CUSTOM_HAS_MMAP
+
+class BenchMapped : public Benchmark
+{
+public:
+   BenchMapped(size_t maxSize) : Benchmark("Mapped", maxSize) {}
+
+   void run()
+   {
+      typedef custom::mapped_vector<int>::advice advice;
+      for (size_t size : sizes())
+      {
+         bench_access <custom::vector<int>>       ("custom",         size, advice::normal, advice::normal);
+         bench_access <custom::mapped_vector<int>>("mapped",         size, advice::normal, advice::normal);
+         bench_access <custom::mapped_vector<int>>("mapped/advised", size, advice::sequential, advice::random);
+      }
+   }
+
+private:
+
+   typedef custom::mapped_vector<int>::advice advice;
+
+   // only a mapped_vector takes advice
+   static void advise(custom::vector<int> &, advice) {}
+   static void advise(custom::mapped_vector<int> & v, advice a) { v.advise(a); }
+
+   /***************************************
+    * ACCESS
+    * Fill a vector, then read it in order and at random
+    ***************************************/
+   template <class Vector>
+   void bench_access(const char * container, size_t size, advice sequential, advice random)
+   {
+      Vector v;
+      double ns = measure([&]()
+      {
+         v.clear();
+      }, [&]()
+      {
+         advise(v, sequential);
+         for (size_t i = 0; i < size; i++)
+            v.push_back(make<int>((unsigned int)i));
+      }, 1);
+      record("fill", container, "int", size, ns, size);
+
+      size_t num = rounds(size);
+      ns = measure([&]()
+      {
+         advise(v, sequential);
+         for (size_t r = 0; r < num; r++)
+         {
+            long long total = 0;
+            for (size_t i = 0; i < size; i++)
+               total += v[i];
+            keep(total);
+         }
+      });
+      record("read/sequential", container, "int", size, ns, num * size);
+
+      ns = measure([&]()
+      {
+         advise(v, random);
+         unsigned long long index = 1;
+         for (size_t r = 0; r < num; r++)
+         {
+            long long total = 0;
+            for (size_t i = 0; i < size; i++)
+            {
+               index = index * 6364136223846793005ull + 1442695040888963407ull;
+               total += v[(size_t)((index >> 33) % size)];
+            }
+            keep(total);
+         }
+      });
+      record("read/random", container, "int", size, ns, num * size);
+   }
+};
+
+#endif // CUSTOM_HAS_MMAP
@@ -0,0 +1,132 @@
+/***********************************************************************
+ * Header:
+ *    BENCH MEMORY
+ * Summary:
+ *    Benchmarks for the memory resources. Each "request" builds and
+ *    throws away a handful of vectors and a priority queue, the way
+ *    our request handlers do, with the memory coming from:
+ *
+ *       heap   : std::allocator, so every reserve() is a malloc()
+ *       arena  : one arena_resource, reset() after each request
+ *       pool   : this thread's pool_resource
+ *
+ *    "request/N" runs the same requests on N threads at once, which
+ *    is where a contended global heap shows up.
+ * Author
+ *    Stephen Costigan, Alexander Dohms, Jonathan Colwell, Shaun Crook
+ ************************************************************************/
+
+#pragma once
+
+#include "memory_resource.h"
+#include "priority_queue.h"
+#include "vector.h"
+#include "benchmark.h"
+
+#include <string>
+#include <thread>   // for std::thread
+#include <vector>
+
+class BenchMemory : public Benchmark
+{
+public:
+   BenchMemory(size_t maxSize, size_t maxThreads) :
+      Benchmark("Memory", maxSize < 10000 ? maxSize : 10000), maxThreads(maxThreads) {}
+
+   void run()
+   {
+      for (size_t size : sizes())
+         for (size_t numThreads : threadCounts(maxThreads))
+         {
+            bench_request(size, numThreads, "heap");
+            bench_request(size, numThreads, "arena");
+            bench_request(size, numThreads, "pool");
+         }
+   }
+
+private:
+   size_t maxThreads;
+
+   /***************************************
+    * HANDLE
+    * One request: a few containers of about size elements,
+    * grown one element at a time, used, and destroyed
+    ***************************************/
+   template <class Vector, class PQueue, class Alloc>
+   static long long handle(size_t size, unsigned int seed, const Alloc & alloc)
+   {
+      Vector ids(alloc);
+      Vector scores(alloc);
+      for (size_t i = 0; i < size; i++)
+      {
+         ids.push_back(int(i));
+         scores.push_back(make<int>((unsigned int)(i + seed) * 2654435761u));
+      }
+
+      PQueue best(alloc);
+      for (size_t i = 0; i < size; i++)
+         best.push(scores[i]);
+
+      long long sum = 0;
+      for (size_t i = 0; i < size / 10 + 1 && !best.empty(); i++)
+      {
+         sum += best.top();
+         best.pop();
+      }
+      keep(sum);
+      return sum + ids.size();
+   }
+
+   // numRequests requests, all on this thread
+   static void handleMany(size_t size, size_t numRequests, const char * resource)
+   {
+      std::string name(resource);
+      if (name == "heap")
+      {
+         std::allocator<int> alloc;
+         for (size_t r = 0; r < numRequests; r++)
+            handle<custom::vector<int>, custom::priority_queue<int>>(size, (unsigned int)r, alloc);
+      }
+      else if (name == "arena")
+      {
+         custom::pmr::arena_resource arena(size * sizeof(int) * 8);
+         for (size_t r = 0; r < numRequests; r++)
+         {
+            handle<custom::pmr::vector<int>, custom::pmr::priority_queue<int>>(
+               size, (unsigned int)r, std::pmr::polymorphic_allocator<int>(&arena));
+            arena.reset();
+         }
+      }
+      else
+      {
+         std::pmr::polymorphic_allocator<int> alloc(custom::pmr::thread_local_pool());
+         for (size_t r = 0; r < numRequests; r++)
+            handle<custom::pmr::vector<int>, custom::pmr::priority_queue<int>>(size, (unsigned int)r, alloc);
+      }
+   }
+
+   /***************************************
+    * REQUEST
+    * Handle many requests on numThreads threads
+    ***************************************/
+   void bench_request(size_t size, size_t numThreads, const char * resource)
+   {
+      size_t num = rounds(size * 4);
+      double ns = measure([&]()
+      {
+         if (numThreads == 1)
+            handleMany(size, num, resource);
+         else
+         {
+            std::vector<std::thread> threads;
+            for (size_t t = 0; t < numThreads; t++)
+               threads.emplace_back(handleMany, size, num, resource);
+            for (auto & thread : threads)
+               thread.join();
+         }
+      });
+      std::string name = numThreads == 1 ? std::string("request") :
+                                           "request/" + std::to_string(numThreads);
+      record(name, resource, "int", size, ns, num * numThreads);
+   }
+};
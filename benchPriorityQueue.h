@@ -0,0 +1,256 @@
+/***********************************************************************
+ * Header:
+ *    BENCH PRIORITY QUEUE
+ * Summary:
+ *    Benchmarks for the priority queue, each run against
+ *    std::priority_queue
+ *
+ *    Built with -DTRACK_ALLOCATIONS, there are also rows counting
+ *    instead of timing, from an AllocationScope: "allocs/push" and
+ *    "peak_bytes/push" are the allocations and the most bytes held
+ *    at once, per element, filling a heap one push() at a time, and
+ *    "allocs/heapify" is the allocations per element of building
+ *    it from a full container. The count is in the value column.
+ * Author
+ *    Stephen Costigan, Alexander Dohms, Jonathan Colwell, Shaun Crook
+ ************************************************************************/
+
+#pragma once
+
+#include "priority_queue.h"
+#include "benchmark.h"
+#include "allocationScope.h"
+
+#include <functional>  // for std::less
+#include <queue>       // for std::priority_queue
+#include <string>
+#include <vector>
+
+class BenchPQueue : public Benchmark
+{
+public:
+   BenchPQueue(size_t maxSize, size_t maxThreads) :
+      Benchmark("PQueue", maxSize), maxThreads(maxThreads) {}
+
+   void run()
+   {
+      runPayload<int>();
+      runPayload<Payload64>();
+      runPayload<std::string>();
+      runPayload<Spy>();
+      bench_heapify_scaling();
+   }
+
+private:
+   size_t maxThreads;
+
+   // every benchmark, for one payload, for both priority queues
+   template <class T>
+   void runPayload()
+   {
+      for (size_t size : sizes())
+      {
+         std::vector<T> source;
+         source.reserve(size);
+         for (size_t i = 0; i < size; i++)
+            source.push_back(make<T>((unsigned int)(i * 2654435761u)));
+
+         bench_push   <custom::priority_queue<T>>("custom", source);
+         bench_push   <std::priority_queue<T>>   ("std",    source);
+         bench_pop    <custom::priority_queue<T>>("custom", source);
+         bench_pop    <std::priority_queue<T>>   ("std",    source);
+         bench_top    <custom::priority_queue<T>>("custom", source);
+         bench_top    <std::priority_queue<T>>   ("std",    source);
+         bench_pushPop<custom::priority_queue<T>>("custom", source);
+         bench_pushPop<std::priority_queue<T>>   ("std",    source);
+         bench_heapify<custom::priority_queue<T>, custom::vector<T>>("custom", source);
+         bench_heapify<std::priority_queue<T>,    std::vector<T>>   ("std",    source);
+         if (AllocationScope::installed())
+         {
+            count_allocations<custom::priority_queue<T>, custom::vector<T>>("custom", source);
+            count_allocations<std::priority_queue<T>,    std::vector<T>>   ("std",    source);
+         }
+      }
+   }
+
+   // the two heaps are built from their containers differently
+   template <class T>
+   static custom::priority_queue<T> build(custom::vector<T> && v)
+   {
+      return custom::priority_queue<T>(std::move(v));
+   }
+   template <class T>
+   static std::priority_queue<T> build(std::vector<T> && v)
+   {
+      return std::priority_queue<T>(std::less<T>(), std::move(v));
+   }
+
+   /***************************************
+    * PUSH
+    * Fill an empty heap one element at a time
+    ***************************************/
+   template <class PQueue, class T>
+   void bench_push(const char * container, const std::vector<T> & source)
+   {
+      size_t size = source.size();
+      size_t num = rounds(size);
+      double ns = measure([&]()
+      {
+         for (size_t r = 0; r < num; r++)
+         {
+            PQueue pq;
+            for (size_t i = 0; i < size; i++)
+               pq.push(source[i]);
+            keep(pq);
+         }
+      });
+      record("push", container, payloadName<T>(), size, ns, size * num);
+   }
+
+   /***************************************
+    * POP
+    * Empty a full heap one element at a time
+    ***************************************/
+   template <class PQueue, class T>
+   void bench_pop(const char * container, const std::vector<T> & source)
+   {
+      size_t size = source.size();
+      size_t num = rounds(size);
+      std::vector<PQueue> full;
+      double ns = measure([&]()
+      {
+         full.clear();
+         for (size_t r = 0; r < num; r++)
+            full.emplace_back(source.begin(), source.end());
+      }, [&]()
+      {
+         for (size_t r = 0; r < num; r++)
+            while (!full[r].empty())
+               full[r].pop();
+      });
+      record("pop", container, payloadName<T>(), size, ns, size * num);
+   }
+
+   /***************************************
+    * TOP
+    * Read the largest element over and over
+    ***************************************/
+   template <class PQueue, class T>
+   void bench_top(const char * container, const std::vector<T> & source)
+   {
+      size_t size = source.size();
+      size_t num = rounds(size);
+      PQueue pq(source.begin(), source.end());
+      double ns = measure([&]()
+      {
+         for (size_t r = 0; r < num; r++)
+            for (size_t i = 0; i < size; i++)
+               keep(pq.top());
+      });
+      record("top", container, payloadName<T>(), size, ns, size * num);
+   }
+
+   /***************************************
+    * PUSH POP
+    * A full heap in steady state: push one, pop one
+    ***************************************/
+   template <class PQueue, class T>
+   void bench_pushPop(const char * container, const std::vector<T> & source)
+   {
+      size_t size = source.size();
+      size_t num = rounds(size);
+      PQueue pq(source.begin(), source.end());
+      double ns = measure([&]()
+      {
+         for (size_t r = 0; r < num; r++)
+            for (size_t i = 0; i < size; i++)
+            {
+               pq.push(source[i]);
+               pq.pop();
+            }
+         keep(pq);
+      });
+      record("push_pop", container, payloadName<T>(), size, ns, size * num);
+   }
+
+   /***************************************
+    * HEAPIFY
+    * Build a heap from a full container all at once
+    ***************************************/
+   template <class PQueue, class Container, class T>
+   void bench_heapify(const char * container, const std::vector<T> & source)
+   {
+      size_t size = source.size();
+      size_t num = rounds(size);
+      std::vector<Container> loaded(num);
+      double ns = measure([&]()
+      {
+         for (size_t r = 0; r < num; r++)
+         {
+            loaded[r] = Container();
+            for (size_t i = 0; i < size; i++)
+               loaded[r].push_back(source[i]);
+         }
+      }, [&]()
+      {
+         for (size_t r = 0; r < num; r++)
+            keep(build(std::move(loaded[r])));
+      });
+      record("heapify", container, payloadName<T>(), size, ns, size * num);
+   }
+
+   /***************************************
+    * COUNT ALLOCATIONS
+    * What push() and heapify cost the heap, in allocations
+    * and bytes rather than time
+    ***************************************/
+   template <class PQueue, class Container, class T>
+   void count_allocations(const char * container, const std::vector<T> & source)
+   {
+      size_t size = source.size();
+      {
+         AllocationScope scope;
+         PQueue pq;
+         for (size_t i = 0; i < size; i++)
+            pq.push(source[i]);
+         keep(pq);
+         recordValue("allocs/push", container, payloadName<T>(), size,
+                     (double)scope.numAlloc() / (double)size);
+         recordValue("peak_bytes/push", container, payloadName<T>(), size,
+                     (double)scope.bytesPeak() / (double)size);
+      }
+
+      Container loaded;
+      for (size_t i = 0; i < size; i++)
+         loaded.push_back(source[i]);
+      AllocationScope scope;
+      keep(build(std::move(loaded)));
+      recordValue("allocs/heapify", container, payloadName<T>(), size,
+                  (double)scope.numAlloc() / (double)size);
+   }
+
+   /***************************************
+    * HEAPIFY SCALING
+    * Build a heap from a loaded vector with 1, 2, 4 ... maxThreads
+    * workers. Compare "heapify/1" against "heapify/N" for the speedup.
+    ***************************************/
+   void bench_heapify_scaling()
+   {
+      size_t num = maxSize;
+      for (size_t numThreads : threadCounts(maxThreads))
+      {
+         custom::vector<int> v;
+         double ns = measure([&]()
+         {
+            v = custom::vector<int>();
+            v.reserve(num);
+            for (size_t i = 0; i < num; i++)
+               v.push_back(make<int>((unsigned int)(i * 2654435761u)));
+         }, [&]()
+         {
+            custom::priority_queue<int> pq(custom::execution::par.threads(numThreads), std::move(v));
+         });
+         record("heapify/" + std::to_string(numThreads), "custom", "int", num, ns, num);
+      }
+   }
+};
@@ -0,0 +1,91 @@
+/***********************************************************************
+ * Header:
+ *    BENCH SEGMENTED
+ * Summary:
+ *    What filling a container one push_back() at a time costs in
+ *    memory and in the worst push_back(), on:
+ *
+ *       custom    : custom::vector, which doubles its buffer
+ *       segmented : custom::segmented_vector, which adds a chunk
+ *       std       : std::vector
+ *       std/deque : std::deque, the standard's chunked container
+ *
+ *    "peak_bytes" rows hold the most bytes the container ever had
+ *    from its allocator while filling, in the value column; a
+ *    doubling vector peaks at the old buffer plus the new one. The
+ *    "push_back/p99" and "push_back/max" rows are latencies in ns.
+ * Author
+ *    Stephen Costigan, Alexander Dohms, Jonathan Colwell, Shaun Crook
+ ************************************************************************/
+
+#pragma once
+
+#include "vector.h"
+#include "segmented_vector.h"
+#include "latency.h"     // for latency_histogram
+#include "benchmark.h"
+
+#include <deque>
+#include <vector>
+
+class BenchSegmented : public Benchmark
+{
+public:
+   BenchSegmented(size_t maxSize) : Benchmark("Segmented", maxSize) {}
+
+   void run()
+   {
+      runPayload<int>();
+      runPayload<Payload64>();
+   }
+
+private:
+
+   template <class T>
+   void runPayload()
+   {
+      typedef PeakAllocator<T> A;
+      for (size_t size : sizes())
+      {
+         bench_fill <custom::vector<T, A>>                                        ("custom",    payloadName<T>(), size);
+         bench_fill <custom::segmented_vector<T, custom::segmented_chunk_size<T>::value, A>>
+                                                                                    ("segmented", payloadName<T>(), size);
+         bench_fill <std::vector<T, A>>                                           ("std",       payloadName<T>(), size);
+         bench_fill <std::deque<T, A>>                                            ("std/deque", payloadName<T>(), size);
+      }
+   }
+
+   /***************************************
+    * FILL
+    * Time each push_back() of filling a container to size,
+    * enough times over to see at least a million calls, and
+    * note the peak of the allocator's bytes while doing so
+    ***************************************/
+   template <class Container>
+   void bench_fill(const char * container, const char * payload, size_t size)
+   {
+      typedef typename Container::value_type T;
+      typedef PeakAllocator<T> A;
+      size_t num = rounds(size);
+      custom::latency_histogram histogram;
+      A::bytesLive() = 0;
+      A::bytesPeak() = 0;
+      for (size_t r = 0; r < num; r++)
+      {
+         Container c;
+         for (size_t i = 0; i < size; i++)
+         {
+            T t = make<T>((unsigned int)i);
+            uint64_t begin = custom::steady_clock_source::now();
+            c.push_back(t);
+            uint64_t end = custom::steady_clock_source::now();
+            histogram.record(end - begin);
+         }
+         keep(c);
+      }
+
+      recordValue("peak_bytes", container, payload, size, (double)A::bytesPeak());
+      record("push_back/p99", container, payload, size, (double)histogram.percentile(99.0), 1);
+      record("push_back/max", container, payload, size, (double)histogram.max(),            1);
+   }
+};
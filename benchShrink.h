@@ -0,0 +1,105 @@
+/***********************************************************************
+ * Header:
+ *    BENCH SHRINK
+ * Summary:
+ *    A soak test of a queue that sees bursts and then sits nearly
+ *    idle. Each cycle pushes --size elements into a priority queue
+ *    and pops all but one percent of them, on:
+ *
+ *       custom             : a priority_queue on custom::vector, which
+ *                            keeps its biggest buffer
+ *       custom/auto_shrink : on a vector with growth::auto_shrink,
+ *                            which halves its buffer as it empties
+ *
+ *    Before the first cycle, and after the burst and after the drain
+ *    of every cycle, we record the bytes the process has resident
+ *    ("rss/start", "rss/burst_N", "rss/idle_N", from /proc/self/statm,
+ *    so Linux only), and after each burst and drain the bytes the
+ *    queue has from its allocator ("live_bytes/burst_N",
+ *    "live_bytes/idle_N"). These are in the value column. How much of
+ *    a freed buffer the RSS gets back is up to malloc(). "cycle" is
+ *    the time of a whole cycle per element pushed, the price of the
+ *    reallocations.
+ * Author
+ *    Stephen Costigan, Alexander Dohms, Jonathan Colwell, Shaun Crook
+ ************************************************************************/
+
+#pragma once
+
+#include "vector.h"
+#include "growth.h"
+#include "priority_queue.h"
+#include "benchmark.h"
+
+#include <chrono>   // for std::chrono::steady_clock
+#include <fstream>  // for std::ifstream
+#include <string>
+
+#ifdef __linux__
+#include <unistd.h> // for sysconf
+#endif
+
+class BenchShrink : public Benchmark
+{
+public:
+   BenchShrink(size_t maxSize) : Benchmark("Shrink", maxSize) {}
+
+   void run()
+   {
+      typedef PeakAllocator<Payload64> A;
+      typedef custom::vector<Payload64, A>                        Keeping;
+      typedef custom::vector<Payload64, A, custom::default_instrument,
+                             custom::growth::auto_shrink<>>       Shrinking;
+      bench_soak <custom::priority_queue<Payload64, Keeping>>   ("custom",             maxSize);
+      bench_soak <custom::priority_queue<Payload64, Shrinking>> ("custom/auto_shrink", maxSize);
+   }
+
+private:
+
+   static const int numCycles = 4;
+
+   // resident bytes of this process, or 0 where we cannot tell
+   static double rss()
+   {
+#ifdef __linux__
+      std::ifstream statm("/proc/self/statm");
+      size_t pagesTotal = 0;
+      size_t pagesResident = 0;
+      if (statm >> pagesTotal >> pagesResident)
+         return (double)pagesResident * (double)sysconf(_SC_PAGESIZE);
+#endif
+      return 0.0;
+   }
+
+   /***************************************
+    * SOAK
+    * Burst to size, drain to one percent, a few times over
+    ***************************************/
+   template <class PQueue>
+   void bench_soak(const char * container, size_t size)
+   {
+      recordValue("rss/start", container, payloadName<Payload64>(), size, rss());
+      double nsTotal = 0.0;
+      PQueue pq;
+      for (int cycle = 1; cycle <= numCycles; cycle++)
+      {
+         std::string suffix = "_" + std::to_string(cycle);
+         auto begin = std::chrono::steady_clock::now();
+         for (size_t i = 0; i < size; i++)
+            pq.push(make<Payload64>((unsigned int)(i * 2654435761u)));
+         nsTotal += std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - begin).count();
+         recordValue("rss/burst" + suffix, container, payloadName<Payload64>(), size, rss());
+         recordValue("live_bytes/burst" + suffix, container, payloadName<Payload64>(), size,
+                     (double)PeakAllocator<Payload64>::bytesLive());
+
+         begin = std::chrono::steady_clock::now();
+         while (pq.size() > size / 100)
+            pq.pop();
+         nsTotal += std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - begin).count();
+         recordValue("rss/idle" + suffix, container, payloadName<Payload64>(), size, rss());
+         recordValue("live_bytes/idle" + suffix, container, payloadName<Payload64>(), size,
+                     (double)PeakAllocator<Payload64>::bytesLive());
+      }
+      record("cycle", container, payloadName<Payload64>(), size, nsTotal, size * numCycles);
+   }
+};
@@ -0,0 +1,164 @@
+/***********************************************************************
+ * Header:
+ *    BENCH SIMD
+ * Summary:
+ *    Benchmarks for the bulk algorithms of simd.h over a full
+ *    custom::vector of int, uint64_t, float, and double:
+ *
+ *       simd/avx2   : the AVX2 kernels, if the CPU has AVX2
+ *       simd/sse4.2 : the SSE4.2 kernels, if the CPU has SSE4.2
+ *       scalar      : the plain loops simd.h falls back to
+ *       std         : std::find, std::count, std::max_element,
+ *                     std::accumulate, std::fill
+ *
+ *    find looks for a value that is not there, so every row scans the
+ *    whole vector. ns_per_op is per element.
+ * Author
+ *    Stephen Costigan, Alexander Dohms, Jonathan Colwell, Shaun Crook
+ ************************************************************************/
+
+#pragma once
+
+#include "vector.h"
+#include "simd.h"
+#include "benchmark.h"
+
+#include <algorithm>  // for std::find
+#include <cstdint>    // for uint64_t
+#include <numeric>    // for std::accumulate
+
+class BenchSimd : public Benchmark
+{
+public:
+   BenchSimd(size_t maxSize) : Benchmark("Simd", maxSize) {}
+
+   void run()
+   {
+      runType<int>     ("int");
+      runType<uint64_t>("uint64");
+      runType<float>   ("float");
+      runType<double>  ("double");
+      custom::simd::set_level(custom::simd::supported());
+   }
+
+private:
+
+   template <class T>
+   void runType(const char * payload)
+   {
+      using custom::simd::isa;
+      for (size_t size : sizes())
+      {
+         custom::vector<T> v;
+         for (size_t i = 0; i < size; i++)
+            v.push_back(T(i % 1000));
+
+         if (custom::simd::supported() >= isa::avx2)
+            bench_simd(v, isa::avx2, "simd/avx2", payload);
+         if (custom::simd::supported() >= isa::sse42)
+            bench_simd(v, isa::sse42, "simd/sse4.2", payload);
+         bench_simd(v, isa::scalar, "scalar", payload);
+         bench_std(v, payload);
+      }
+   }
+
+   /***************************************
+    * SIMD
+    * Each algorithm at one instruction set
+    ***************************************/
+   template <class T>
+   void bench_simd(custom::vector<T> & v, custom::simd::isa level,
+                   const char * container, const char * payload)
+   {
+      custom::simd::set_level(level);
+      size_t size = v.size();
+      size_t num = rounds(size);
+
+      double ns = measure([&]()
+      {
+         for (size_t r = 0; r < num; r++)
+            keep(custom::simd::find(v, T(1001)));
+      });
+      record("find", container, payload, size, ns, num * size);
+
+      ns = measure([&]()
+      {
+         for (size_t r = 0; r < num; r++)
+            keep(custom::simd::count(v, T(7)));
+      });
+      record("count", container, payload, size, ns, num * size);
+
+      ns = measure([&]()
+      {
+         for (size_t r = 0; r < num; r++)
+            keep(custom::simd::max(v));
+      });
+      record("max", container, payload, size, ns, num * size);
+
+      ns = measure([&]()
+      {
+         for (size_t r = 0; r < num; r++)
+            keep(custom::simd::sum(v));
+      });
+      record("sum", container, payload, size, ns, num * size);
+
+      ns = measure([&]()
+      {
+         for (size_t r = 0; r < num; r++)
+         {
+            custom::simd::fill(v, T(r));
+            keep(v);
+         }
+      });
+      record("fill", container, payload, size, ns, num * size);
+   }
+
+   /***************************************
+    * STD
+    * The same with the standard algorithms
+    ***************************************/
+   template <class T>
+   void bench_std(custom::vector<T> & v, const char * payload)
+   {
+      size_t size = v.size();
+      size_t num = rounds(size);
+
+      double ns = measure([&]()
+      {
+         for (size_t r = 0; r < num; r++)
+            keep(std::find(v.begin(), v.end(), T(1001)));
+      });
+      record("find", "std", payload, size, ns, num * size);
+
+      ns = measure([&]()
+      {
+         for (size_t r = 0; r < num; r++)
+            keep(std::count(v.begin(), v.end(), T(7)));
+      });
+      record("count", "std", payload, size, ns, num * size);
+
+      ns = measure([&]()
+      {
+         for (size_t r = 0; r < num; r++)
+            keep(*std::max_element(v.begin(), v.end()));
+      });
+      record("max", "std", payload, size, ns, num * size);
+
+      ns = measure([&]()
+      {
+         for (size_t r = 0; r < num; r++)
+            keep(std::accumulate(v.begin(), v.end(), T(0)));
+      });
+      record("sum", "std", payload, size, ns, num * size);
+
+      ns = measure([&]()
+      {
+         for (size_t r = 0; r < num; r++)
+         {
+            std::fill(v.begin(), v.end(), T(r));
+            keep(v);
+         }
+      });
+      record("fill", "std", payload, size, ns, num * size);
+   }
+};
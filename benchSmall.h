@@ -0,0 +1,106 @@
+/***********************************************************************
+ * Header:
+ *    BENCH SMALL
+ * Summary:
+ *    Benchmarks for short-lived priority queues of 1 to 64 items, the
+ *    size of a typical per-connection queue. Each "queue" is built,
+ *    filled, emptied, and destroyed on:
+ *
+ *       custom      : priority_queue on custom::vector
+ *       custom/small: small_priority_queue with 16 items inline
+ *       std         : std::priority_queue on std::vector
+ *
+ *    The "queue/allocs" rows count allocator calls instead of time:
+ *    their value column is the number of allocations per queue.
+ * Author
+ *    Stephen Costigan, Alexander Dohms, Jonathan Colwell, Shaun Crook
+ ************************************************************************/
+
+#pragma once
+
+#include "priority_queue.h"
+#include "small_vector.h"
+#include "benchmark.h"
+
+#include <functional>  // for std::less
+#include <memory>      // for std::allocator
+#include <queue>       // for std::priority_queue
+#include <vector>
+
+/*************************************************************
+ * COUNTING ALLOCATOR
+ * std::allocator that counts how often it is called
+ *************************************************************/
+template <class T>
+struct CountingAllocator : std::allocator<T>
+{
+   typedef T value_type;
+   template <class U> struct rebind { typedef CountingAllocator<U> other; };
+
+   CountingAllocator() {}
+   template <class U>
+   CountingAllocator(const CountingAllocator<U> &) {}
+
+   T * allocate(size_t num)
+   {
+      numAllocate()++;
+      return std::allocator<T>::allocate(num);
+   }
+
+   static size_t & numAllocate()
+   {
+      static size_t num = 0;
+      return num;
+   }
+};
+
+class BenchSmall : public Benchmark
+{
+public:
+   BenchSmall() : Benchmark("Small", 64) {}
+
+   void run()
+   {
+      typedef CountingAllocator<int> A;
+      for (size_t size = 1; size <= 64; size *= 2)
+      {
+         bench_queue <custom::priority_queue<int, custom::vector<int, A>>>    ("custom",       size);
+         bench_queue <custom::priority_queue<int, custom::small_vector<int, 16, A>>>
+                                                                               ("custom/small", size);
+         bench_queue <std::priority_queue<int, std::vector<int, A>>>          ("std",          size);
+      }
+   }
+
+private:
+
+   /***************************************
+    * QUEUE
+    * Make a queue, push size items, pop them all
+    ***************************************/
+   template <class PQueue>
+   void bench_queue(const char * container, size_t size)
+   {
+      size_t num = rounds(size);
+      size_t numAllocate = 0;
+      double ns = measure([&]()
+      {
+         CountingAllocator<int>::numAllocate() = 0;
+      }, [&]()
+      {
+         for (size_t r = 0; r < num; r++)
+         {
+            PQueue pq;
+            for (size_t i = 0; i < size; i++)
+               pq.push(make<int>((unsigned int)(i * 2654435761u + r)));
+            while (!pq.empty())
+            {
+               keep(pq.top());
+               pq.pop();
+            }
+         }
+         numAllocate = CountingAllocator<int>::numAllocate();
+      });
+      record(     "queue",        container, "int", size, ns, num);
+      recordValue("queue/allocs", container, "int", size, (double)numAllocate / (double)num);
+   }
+};
@@ -0,0 +1,173 @@
+/***********************************************************************
+ * Header:
+ *    BENCH VECTOR
+ * Summary:
+ *    Benchmarks for the vector, each run against std::vector
+ * Author
+ *    Stephen Costigan, Alexander Dohms, Jonathan Colwell, Shaun Crook
+ ************************************************************************/
+
+#pragma once
+
+#include "vector.h"
+#include "mmap_allocator.h"
+#include "benchmark.h"
+
+#include <vector>
+
+class BenchVector : public Benchmark
+{
+public:
+   BenchVector(size_t maxSize) : Benchmark("Vector", maxSize) {}
+
+   void run()
+   {
+      runPayload<int>();
+      runPayload<Payload64>();
+      runPayload<std::string>();
+      runPayload<Spy>();
+
+      for (size_t size : sizes())
+      {
+         bench_grow <custom::vector<int>>                                ("custom",      size);
+         bench_grow <custom::vector<int, custom::mmap_allocator<int>>>   ("custom/mmap", size);
+         bench_grow <std::vector<int>>                                   ("std",         size);
+      }
+   }
+
+private:
+
+   // every benchmark, for one payload, for both vectors
+   template <class T>
+   void runPayload()
+   {
+      for (size_t size : sizes())
+      {
+         std::vector<T> source;
+         source.reserve(size);
+         for (size_t i = 0; i < size; i++)
+            source.push_back(make<T>((unsigned int)(i * 2654435761u)));
+
+         bench_pushback <custom::vector<T>>("custom", source);
+         bench_pushback <std::vector<T>>   ("std",    source);
+         bench_reserve  <custom::vector<T>>("custom", source);
+         bench_reserve  <std::vector<T>>   ("std",    source);
+         bench_copy     <custom::vector<T>>("custom", source);
+         bench_copy     <std::vector<T>>   ("std",    source);
+         bench_iterate  <custom::vector<T>>("custom", source);
+         bench_iterate  <std::vector<T>>   ("std",    source);
+      }
+   }
+
+   /***************************************
+    * PUSH BACK
+    * Grow from empty one element at a time
+    ***************************************/
+   template <class Vector, class T>
+   void bench_pushback(const char * container, const std::vector<T> & source)
+   {
+      size_t size = source.size();
+      size_t num = rounds(size);
+      double ns = measure([&]()
+      {
+         for (size_t r = 0; r < num; r++)
+         {
+            Vector v;
+            for (size_t i = 0; i < size; i++)
+               v.push_back(source[i]);
+            keep(v);
+         }
+      });
+      record("push_back", container, payloadName<T>(), size, ns, size * num);
+   }
+
+   /***************************************
+    * RESERVE
+    * Reserve once, then push_back without growing
+    ***************************************/
+   template <class Vector, class T>
+   void bench_reserve(const char * container, const std::vector<T> & source)
+   {
+      size_t size = source.size();
+      size_t num = rounds(size);
+      double ns = measure([&]()
+      {
+         for (size_t r = 0; r < num; r++)
+         {
+            Vector v;
+            v.reserve(size);
+            for (size_t i = 0; i < size; i++)
+               v.push_back(source[i]);
+            keep(v);
+         }
+      });
+      record("reserve", container, payloadName<T>(), size, ns, size * num);
+   }
+
+   /***************************************
+    * COPY
+    * Copy-construct a full vector
+    ***************************************/
+   template <class Vector, class T>
+   void bench_copy(const char * container, const std::vector<T> & source)
+   {
+      size_t size = source.size();
+      size_t num = rounds(size);
+      Vector full;
+      for (size_t i = 0; i < size; i++)
+         full.push_back(source[i]);
+      double ns = measure([&]()
+      {
+         for (size_t r = 0; r < num; r++)
+         {
+            Vector v(full);
+            keep(v);
+         }
+      });
+      record("copy", container, payloadName<T>(), size, ns, size * num);
+   }
+
+   /***************************************
+    * GROW
+    * Double the capacity of a full vector of ints, once.
+    * ns_per_op is the time of that one reallocation.
+    ***************************************/
+   template <class Vector>
+   void bench_grow(const char * container, size_t size)
+   {
+      Vector v;
+      double ns = measure([&]()
+      {
+         v = Vector();
+         v.reserve(size);
+         for (size_t i = 0; i < size; i++)
+            v.push_back(int(i));
+      }, [&]()
+      {
+         v.reserve(size * 2);
+         keep(v);
+      });
+      record("grow", container, "int", size, ns, 1);
+   }
+
+   /***************************************
+    * ITERATE
+    * Walk from begin() to end(), touching each element
+    ***************************************/
+   template <class Vector, class T>
+   void bench_iterate(const char * container, const std::vector<T> & source)
+   {
+      size_t size = source.size();
+      size_t num = rounds(size);
+      Vector full;
+      for (size_t i = 0; i < size; i++)
+         full.push_back(source[i]);
+      double ns = measure([&]()
+      {
+         for (size_t r = 0; r < num; r++)
+            for (auto it = full.begin(); it != full.end(); ++it)
+               keep(*it);
+      });
+      record("iterate", container, payloadName<T>(), size, ns, size * num);
+   }
+};
@@ -0,0 +1,87 @@
+/***********************************************************************
+ * Source:
+ *    Benchmark
+ * Summary:
+ *    Driver for the benchmarks. This is a separate program from the
+ *    unit tests; build it with optimizations on:
+ *
+ *       g++ -O2 -std=c++17 -pthread benchmark.cpp -o benchmark
+ *       ./benchmark --size 100000000 --threads 16 > results.csv
+ *       ./benchmark --format json > results.json
+ *       ./benchmark --counters on > counters.csv
+ *
+ *    Build it with -DTRACK_ALLOCATIONS as well to replace operator new
+ *    and add the allocation rows (see allocationScope.h). That slows
+ *    every allocation a little, so it is left out of timing runs.
+ *
+ *    Every container benchmark sweeps the sizes 10, 100, ... --size.
+ * Author
+ *    Stephen Costigan, Alexander Dohms, Jonathan Colwell, Shaun Crook
+ ************************************************************************/
+
+#include <cstdlib>   // for std::strtoull
+#include <cstring>   // for std::strcmp
+#include <iostream>
+
+#include "benchVector.h"         // for the vector benchmarks
+#include "benchPriorityQueue.h"  // for the priority queue benchmarks
+#include "benchMemory.h"         // for the memory resource benchmarks
+#include "benchGrowth.h"         // for the push_back latency benchmarks
+#include "benchSmall.h"          // for the small priority queue benchmarks
+#include "benchSimd.h"           // for the simd algorithm benchmarks
+#include "benchCow.h"            // for the copy-on-write snapshot benchmarks
+#include "benchSegmented.h"      // for the segmented vector benchmarks
+#include "benchMapped.h"         // for the file-backed vector benchmarks
+#include "benchAligned.h"        // for the aligned storage benchmarks
+#include "benchConcurrent.h"     // for the concurrent append benchmarks
+#include "benchShrink.h"         // for the burst-then-idle soak
+
+/**********************************************************************
+ * MAIN
+ * Parse the few command line options and run every benchmark
+ ***********************************************************************/
+int main(int argc, char ** argv)
+{
+   size_t maxSize    = 1000000;
+   size_t maxThreads = custom::thread_pool::defaultConcurrency();
+
+   for (int i = 1; i + 1 < argc; i += 2)
+   {
+      if (std::strcmp(argv[i], "--size") == 0)
+         maxSize = std::strtoull(argv[i + 1], nullptr, 10);
+      else if (std::strcmp(argv[i], "--threads") == 0)
+         maxThreads = std::strtoull(argv[i + 1], nullptr, 10);
+      else if (std::strcmp(argv[i], "--format") == 0 && std::strcmp(argv[i + 1], "json") == 0)
+         Benchmark::format() = Benchmark::JSON;
+      else if (std::strcmp(argv[i], "--format") == 0 && std::strcmp(argv[i + 1], "csv") == 0)
+         Benchmark::format() = Benchmark::CSV;
+      else if (std::strcmp(argv[i], "--counters") == 0 && std::strcmp(argv[i + 1], "on") == 0)
+         Benchmark::counters() = true;
+      else if (std::strcmp(argv[i], "--counters") == 0 && std::strcmp(argv[i + 1], "off") == 0)
+         Benchmark::counters() = false;
+      else
+      {
+         std::cerr << "usage: " << argv[0]
+                   << " [--size n] [--threads n] [--format csv|json] [--counters on|off]\n";
+         return 1;
+      }
+   }
+
+   Benchmark::header();
+   BenchVector(maxSize).run();
+   BenchPQueue(maxSize, maxThreads).run();
+   BenchMemory(maxSize, maxThreads).run();
+   BenchGrowth(maxSize).run();
+   BenchSmall().run();
+   BenchSimd(maxSize).run();
+   BenchCow(maxSize).run();
+   BenchSegmented(maxSize).run();
+#ifdef CUSTOM_HAS_MMAP
+   BenchMapped(maxSize).run();
+#endif
+   BenchAligned(maxSize).run();
+   BenchConcurrent(maxSize, maxThreads).run();
+   BenchShrink(maxSize).run();
+
+   return 0;
+}
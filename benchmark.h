@@ -0,0 +1,334 @@
+/***********************************************************************
+ * Header:
+ *    BENCHMARK
+ * Summary:
+ *    The base class to all the benchmark classes. It times a body of
+ *    code and writes one line per measurement to std::cout so the
+ *    results can be collected by a script. The default is CSV:
+ *
+ *       suite,name,container,payload,size,ns_per_op,items_per_sec,value
+ *
+ *    or, with --format json, one JSON object per line with the same
+ *    fields. A timed row leaves value empty. A row that counts
+ *    something else, allocations or bytes or moves, has the count in
+ *    value and leaves ns_per_op and items_per_sec empty (null in
+ *    JSON); its name says what was counted. With --counters on, each
+ *    timed row also has the hardware counters per operation of its
+ *    fastest run (see perfCounters.h):
+ *
+ *       ...,value,cycles,instructions,l1d_misses,llc_misses,
+ *           dtlb_misses,branch_misses
+ *
+ *    A counter the machine does not have is left empty (null in JSON),
+ *    as is every counter of a row that was not timed by measure().
+ *
+ *    This also has the payload types every benchmark is run against:
+ *    int, a 64-byte struct, std::string, and Spy, and an allocator
+ *    that counts the bytes a container holds.
+ * Author
+ *    Stephen Costigan, Alexander Dohms, Jonathan Colwell, Shaun Crook
+ ************************************************************************/
+
+#pragma once
+
+#include <chrono>    // for std::chrono::steady_clock
+#include <cmath>     // for std::isnan, std::floor
+#include <iostream>  // for std::cout
+#include <limits>    // for std::numeric_limits
+#include <memory>    // for std::allocator
+#include <string>    // for std::string
+#include <vector>    // for std::vector
+#include "spy.h"     // for the Spy payload
+#include "perfCounters.h" // for --counters
+
+/*************************************************************
+ * PAYLOAD 64
+ * A 64-byte element ordered by its first field
+ *************************************************************/
+struct Payload64
+{
+   long long key;
+   long long pad[7];
+
+   bool operator <  (const Payload64 & rhs) const { return key < rhs.key;  }
+   bool operator == (const Payload64 & rhs) const { return key == rhs.key; }
+};
+
+/*************************************************************
+ * MAKE
+ * The i'th value of each payload type. The strings are too long
+ * for the small string optimization, so every copy allocates.
+ *************************************************************/
+template <class T> T make(unsigned int i);
+template <> inline int make<int>(unsigned int i) { return int(i); }
+template <> inline Payload64 make<Payload64>(unsigned int i)
+{
+   Payload64 p = {};
+   p.key = i;
+   return p;
+}
+template <> inline std::string make<std::string>(unsigned int i)
+{
+   std::string s = std::to_string(i);
+   return std::string(24 - s.size(), '0') + s;
+}
+template <> inline Spy make<Spy>(unsigned int i) { return Spy(int(i)); }
+
+template <class T> const char * payloadName();
+template <> inline const char * payloadName<int>()         { return "int";       }
+template <> inline const char * payloadName<Payload64>()   { return "payload64"; }
+template <> inline const char * payloadName<std::string>() { return "string";    }
+template <> inline const char * payloadName<Spy>()         { return "spy";       }
+
+/*************************************************************
+ * PEAK ALLOCATOR
+ * std::allocator that remembers the most bytes it had out at once
+ *************************************************************/
+template <class T>
+struct PeakAllocator : std::allocator<T>
+{
+   typedef T value_type;
+   template <class U> struct rebind { typedef PeakAllocator<U> other; };
+
+   PeakAllocator() {}
+   template <class U>
+   PeakAllocator(const PeakAllocator<U> &) {}
+
+   T * allocate(size_t num)
+   {
+      bytesLive() += num * sizeof(T);
+      if (bytesLive() > bytesPeak())
+         bytesPeak() = bytesLive();
+      return std::allocator<T>::allocate(num);
+   }
+   void deallocate(T * p, size_t num)
+   {
+      bytesLive() -= num * sizeof(T);
+      std::allocator<T>::deallocate(p, num);
+   }
+
+   static size_t & bytesLive() { static size_t bytes = 0; return bytes; }
+   static size_t & bytesPeak() { static size_t bytes = 0; return bytes; }
+};
+
+/*************************************************************
+ * BENCHMARK
+ *************************************************************/
+class Benchmark
+{
+public:
+   enum Format { CSV, JSON };
+
+   Benchmark(const char * suite, size_t maxSize) : suite(suite), maxSize(maxSize), haveCounts(false) {}
+
+   // how the results are written, set once from the command line
+   static Format & format()
+   {
+      static Format f = CSV;
+      return f;
+   }
+
+   // whether to read the hardware counters, set once from the command line
+   static bool & counters()
+   {
+      static bool enabled = false;
+      return enabled;
+   }
+
+   // print the column names once, before any suite runs
+   static void header()
+   {
+      if (counters() && !perf().any())
+         std::cerr << "no hardware counters here (not Linux, no PMU, or "
+                      "perf_event_paranoid); their columns are left empty\n";
+      if (format() != CSV)
+         return;
+      std::cout << "suite,name,container,payload,size,ns_per_op,items_per_sec,value";
+      if (counters())
+         for (int e = 0; e < PerfCounters::NUM_EVENTS; e++)
+            std::cout << ',' << PerfCounters::name(PerfCounters::Event(e));
+      std::cout << '\n';
+   }
+
+protected:
+   const char * suite;     // name of the benchmark class
+   size_t       maxSize;   // do not run any sweep past this size
+
+   // the counters of the fastest run of the last measure(), for record()
+   double counts[PerfCounters::NUM_EVENTS];
+   bool   haveCounts;
+
+   // opened the first time they are wanted, and shared by every suite
+   static PerfCounters & perf()
+   {
+      static PerfCounters p;
+      return p;
+   }
+
+   /*************************************************************
+    * SIZES
+    * 10, 100, 1000 ... up to maxSize
+    *************************************************************/
+   std::vector<size_t> sizes() const
+   {
+      std::vector<size_t> s;
+      for (size_t size = 10; size <= maxSize; size *= 10)
+         s.push_back(size);
+      return s;
+   }
+
+   /*************************************************************
+    * THREAD COUNTS
+    * 1, 2, 4 ... and maxThreads itself, even when it is not a
+    * power of two: 1, 2, 3 for 3; 1, 2, 4, 6 for 6
+    *************************************************************/
+   static std::vector<size_t> threadCounts(size_t maxThreads)
+   {
+      std::vector<size_t> counts;
+      for (size_t numThreads = 1; numThreads < maxThreads; numThreads *= 2)
+         counts.push_back(numThreads);
+      counts.push_back(maxThreads < 1 ? 1 : maxThreads);
+      return counts;
+   }
+
+   /*************************************************************
+    * ROUNDS
+    * How many times to repeat an n-element body so that even the
+    * small sizes run long enough to be measured.
+    *************************************************************/
+   static size_t rounds(size_t size)
+   {
+      const size_t minOps = 1 << 20;
+      return size >= minOps ? 1 : minOps / size;
+   }
+
+   /*************************************************************
+    * KEEP
+    * Pretend to use a value so the optimizer cannot delete the
+    * code that computed it.
+    *************************************************************/
+   template <class T>
+   static void keep(const T & value)
+   {
+#if defined(__GNUC__) || defined(__clang__)
+      asm volatile("" : : "r"(&value) : "memory");
+#else
+      static const void * volatile sink;
+      sink = &value;
+#endif
+   }
+
+   /*************************************************************
+    * MEASURE
+    * Run the body numRepeat times and return the fastest run in
+    * nanoseconds. The fastest run is the one least disturbed by
+    * the rest of the machine. The setup is run before each
+    * repetition but is not timed. With --counters, the counters
+    * of the fastest run are kept for the next record().
+    *************************************************************/
+   template <class Setup, class Body>
+   double measure(Setup setup, Body body, int numRepeat = 3)
+   {
+      double best = 0.0;
+      for (int i = 0; i < numRepeat; i++)
+      {
+         setup();
+         if (counters())
+            perf().start();
+         auto begin = std::chrono::steady_clock::now();
+         body();
+         auto end = std::chrono::steady_clock::now();
+         if (counters())
+            perf().stop();
+         double ns = (double)std::chrono::duration_cast<std::chrono::nanoseconds>(end - begin).count();
+         if (i == 0 || ns < best)
+         {
+            best = ns;
+            for (int e = 0; counters() && e < PerfCounters::NUM_EVENTS; e++)
+               counts[e] = perf().read(PerfCounters::Event(e));
+         }
+      }
+      haveCounts = counters();
+      return best;
+   }
+
+   template <class Body>
+   double measure(Body body, int numRepeat = 3)
+   {
+      return measure([]() {}, body, numRepeat);
+   }
+
+   /*************************************************************
+    * RECORD
+    * Write one measurement: numOps operations took ns nanoseconds
+    *************************************************************/
+   void record(const std::string & name, const char * container, const char * payload,
+               size_t size, double ns, size_t numOps)
+   {
+      double nsPerOp = numOps ? ns / (double)numOps : 0.0;
+      double itemsPerSec = ns > 0.0 ? (double)numOps * 1.0e9 / ns : 0.0;
+      write(name, container, payload, size, nsPerOp, itemsPerSec, empty(), numOps);
+      haveCounts = false;
+   }
+
+   /*************************************************************
+    * RECORD VALUE
+    * Write one thing that is not a time: a count, or bytes
+    *************************************************************/
+   void recordValue(const std::string & name, const char * container, const char * payload,
+                    size_t size, double value)
+   {
+      write(name, container, payload, size, empty(), empty(), value, 0);
+   }
+
+private:
+   // a column with nothing in it
+   static double empty() { return std::numeric_limits<double>::quiet_NaN(); }
+
+   // one column, the name first for JSON; empty is null there. Whole
+   // numbers, like a count of bytes, are written in full.
+   static void writeField(const char * name, double x)
+   {
+      if (format() == CSV)
+         std::cout << ',';
+      else
+         std::cout << ",\"" << name << "\":";
+      if (std::isnan(x))
+         std::cout << (format() == JSON ? "null" : "");
+      else if (x == std::floor(x) && std::fabs(x) < 1.0e15)
+         std::cout << (long long)x;
+      else
+         std::cout << x;
+   }
+
+   void write(const std::string & name, const char * container, const char * payload,
+              size_t size, double nsPerOp, double itemsPerSec, double value, size_t numOps)
+   {
+      if (format() == CSV)
+         std::cout << suite     << ','
+                   << name      << ','
+                   << container << ','
+                   << payload   << ','
+                   << size;
+      else
+         std::cout << "{\"suite\":\""     << suite
+                   << "\",\"name\":\""      << name
+                   << "\",\"container\":\"" << container
+                   << "\",\"payload\":\""   << payload
+                   << "\",\"size\":"        << size;
+      writeField("ns_per_op",     nsPerOp);
+      writeField("items_per_sec", itemsPerSec);
+      writeField("value",         value);
+
+      // the counters per operation, if measure() has any for us
+      for (int e = 0; counters() && e < PerfCounters::NUM_EVENTS; e++)
+      {
+         bool have = haveCounts && numOps && counts[e] >= 0.0;
+         writeField(PerfCounters::name(PerfCounters::Event(e)),
+                    have ? counts[e] / (double)numOps : empty());
+      }
+
+      std::cout << (format() == CSV ? "\n" : "}\n");
+      std::cout.flush();
+   }
+};
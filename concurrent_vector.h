@@ -0,0 +1,231 @@
+/***********************************************************************
+ * Header:
+ *    CONCURRENT VECTOR
+ * Summary:
+ *    An append-only vector that many threads may push_back() onto at
+ *    once without a lock. Each push_back() claims the next index with
+ *    one compare-and-swap on the size and moves the element into it.
+ *    The elements live in segments of 16, 32, 64, ... elements
+ *    found through a fixed table of segment pointers, so growing is
+ *    adding a segment: nothing is ever copied or moved, and a
+ *    reference to an element stays good while other threads append.
+ *
+ *       custom::concurrent_vector<Record> records;
+ *       // on each ingest thread
+ *       records.push_back(parse(line));
+ *       // once they have all been joined
+ *       custom::priority_queue<Record> pq(records.freeze());
+ *
+ *    freeze() moves the elements into one contiguous custom::vector,
+ *    ready to be heapified, and leaves the concurrent_vector empty.
+ *
+ *    Any thread may read an element once the push_back() that made it
+ *    has returned and the reader has synchronized with that thread
+ *    (joined it, taken a lock it released, read an atomic it wrote).
+ *    size() counts every claimed index, including elements another
+ *    thread is still building. clear(), freeze(), and destruction must
+ *    not race with anything.
+ *
+ *    T's move constructor must not throw: push_back() builds the element
+ *    first and only moves it in after claiming a slot, so a throw can
+ *    never leave a hole.
+ *
+ *    This will contain the class definition of:
+ *        concurrent_vector      : A lock-free append-only vector
+ * Author
+ *    Stephen Costigan, Alexander Dohms, Jonathan Colwell, Shaun Crook
+ ************************************************************************/
+
+#pragma once
+
+#include <cassert>
+#include <atomic>       // for std::atomic
+#include <memory>       // for std::allocator_traits
+#include <type_traits>  // for std::is_nothrow_move_constructible
+#include <utility>      // for std::move
+#include "vector.h"     // for freeze()
+
+namespace custom
+{
+
+/*****************************************
+ * CONCURRENT VECTOR
+ * Segment k holds firstSize << k elements, starting at
+ * index firstSize * (2^k - 1). Segments are only added,
+ * until clear(), and never move.
+ ****************************************/
+template <typename T, typename A = std::allocator<T>>
+class concurrent_vector
+{
+   static_assert(std::is_nothrow_move_constructible<T>::value,
+                 "a concurrent_vector moves each element into a claimed slot, which must not throw");
+   typedef std::allocator_traits<A> traits;
+
+   static const size_t firstShift  = 4;
+   static const size_t firstSize   = size_t(1) << firstShift;
+   static const size_t numSegments = sizeof(size_t) * 8 - firstShift;
+
+public:
+   typedef T      value_type;
+   typedef A      allocator_type;
+   typedef size_t size_type;
+
+   //
+   // Construct
+   //
+
+   concurrent_vector() : concurrent_vector(A()) {}
+   explicit concurrent_vector(const A & a) : numElements(0), alloc(a)
+   {
+      for (size_t k = 0; k < numSegments; k++)
+         segments[k].store(nullptr, std::memory_order_relaxed);
+   }
+   concurrent_vector(const concurrent_vector &) = delete;
+   concurrent_vector & operator = (const concurrent_vector &) = delete;
+   ~concurrent_vector()
+   {
+      clear();
+   }
+
+   A get_allocator() const { return alloc; }
+
+   //
+   // Access
+   //
+
+         T & operator [] (size_t index)       { return *slot(index); }
+   const T & operator [] (size_t index) const { return *slot(index); }
+
+   //
+   // Insert
+   //
+
+   // safe to call from any number of threads at once.
+   // Returns the index of the new element.
+   size_t push_back(const T & t) { return emplace_back(t);            }
+   size_t push_back(T && t)      { return emplace_back(std::move(t)); }
+
+   template <class ... Args>
+   size_t emplace_back(Args&& ... args)
+   {
+      T t(std::forward<Args>(args)...);
+      size_t index = claim();
+      traits::construct(alloc, slot(index), std::move(t));
+      return index;
+   }
+
+   // make room for newCapacity elements; also safe from any thread
+   void reserve(size_t newCapacity)
+   {
+      for (size_t k = 0; k < numSegments && segmentBegin(k) < newCapacity; k++)
+         segment(k);
+   }
+
+   //
+   // Remove
+   //
+
+   // destroy every element and free every segment. Not concurrent.
+   void clear()
+   {
+      size_t num = size();
+      for (size_t i = 0; i < num; i++)
+         traits::destroy(alloc, slot(i));
+      for (size_t k = 0; k < numSegments; k++)
+      {
+         T * p = segments[k].load(std::memory_order_relaxed);
+         if (p)
+            traits::deallocate(alloc, p, segmentSize(k));
+         segments[k].store(nullptr, std::memory_order_relaxed);
+      }
+      numElements.store(0, std::memory_order_relaxed);
+   }
+
+   // move the elements, in order, into one contiguous vector and
+   // leave this one empty. Not concurrent.
+   custom::vector<T> freeze()
+   {
+      custom::vector<T> v;
+      size_t num = size();
+      v.reserve(num);
+      for (size_t i = 0; i < num; i++)
+         v.push_back(std::move(*slot(i)));
+      clear();
+      return v;
+   }
+
+   //
+   // Status
+   //
+
+   size_t size()     const { return numElements.load(std::memory_order_acquire); }
+   bool   empty()    const { return size() == 0;                                 }
+   size_t capacity() const
+   {
+      size_t k = 0;
+      while (k < numSegments && segments[k].load(std::memory_order_acquire))
+         k++;
+      return segmentBegin(k);
+   }
+
+#ifdef DEBUG // make this visible to the unit tests
+public:
+#else
+private:
+#endif
+
+   // which segment holds index: the top bit of index + firstSize
+   static size_t segmentOf(size_t index)
+   {
+      unsigned long long j = (index + firstSize) >> firstShift;
+#if defined(__GNUC__) || defined(__clang__)
+      return sizeof(j) * 8 - 1 - __builtin_clzll(j);
+#else
+      size_t k = 0;
+      while (j >>= 1)
+         k++;
+      return k;
+#endif
+   }
+   static size_t segmentBegin(size_t k) { return firstSize * ((size_t(1) << k) - 1); }
+   static size_t segmentSize(size_t k)  { return firstSize << k;                     }
+
+   T * slot(size_t index) const
+   {
+      size_t k = segmentOf(index);
+      return segments[k].load(std::memory_order_acquire) + (index - segmentBegin(k));
+   }
+
+   // segment k, allocating it if no one has. When two threads race
+   // to allocate it, the loser frees its copy and takes the winner's.
+   T * segment(size_t k)
+   {
+      T * p = segments[k].load(std::memory_order_acquire);
+      if (p)
+         return p;
+      T * pNew = traits::allocate(alloc, segmentSize(k));
+      if (segments[k].compare_exchange_strong(p, pNew, std::memory_order_acq_rel,
+                                                       std::memory_order_acquire))
+         return pNew;
+      traits::deallocate(alloc, pNew, segmentSize(k));
+      return p;
+   }
+
+   // the next free index. Its segment exists before the index is ours,
+   // so a bad_alloc leaves nothing claimed and unbuilt.
+   size_t claim()
+   {
+      size_t index = numElements.load(std::memory_order_relaxed);
+      do
+         segment(segmentOf(index));
+      while (!numElements.compare_exchange_weak(index, index + 1, std::memory_order_acq_rel,
+                                                                  std::memory_order_relaxed));
+      return index;
+   }
+
+   std::atomic<T *>    segments[numSegments];
+   std::atomic<size_t> numElements;   // claimed, not necessarily built yet
+   A                   alloc;
+};
+
+} // namespace custom
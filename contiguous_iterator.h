@@ -0,0 +1,104 @@
+/***********************************************************************
+ * Header:
+ *    CONTIGUOUS ITERATOR
+ * Summary:
+ *    The iterator for any container that keeps its elements in one
+ *    array. It is a thin wrapper around a pointer that supports
+ *    everything a pointer does, so std::sort, std::lower_bound,
+ *    std::make_heap, and the parallel algorithms all take their
+ *    fastest path. In C++20 it is a contiguous_iterator too, so a
+ *    container that uses it converts to std::span.
+ *
+ *    contiguous_iterator<T> is the iterator and
+ *    contiguous_iterator<const T> is the const_iterator; the first
+ *    converts to the second.
+ *
+ *    This will contain the class definition of:
+ *        contiguous_iterator    : A random-access iterator over an array
+ * Author
+ *    Stephen Costigan, Alexander Dohms, Jonathan Colwell, Shaun Crook
+ ************************************************************************/
+
+#pragma once
+
+#include <cstddef>      // for std::ptrdiff_t
+#include <iterator>     // for std::random_access_iterator_tag
+#include <type_traits>  // for std::remove_cv
+
+namespace custom
+{
+
+/**************************************************
+ * CONTIGUOUS ITERATOR
+ * An iterator through an array of U
+ *************************************************/
+template <typename U>
+class contiguous_iterator
+{
+public:
+   typedef std::random_access_iterator_tag        iterator_category;
+#if __cplusplus >= 202002L
+   typedef std::contiguous_iterator_tag           iterator_concept;
+#endif
+   typedef typename std::remove_cv<U>::type       value_type;
+   typedef std::ptrdiff_t                         difference_type;
+   typedef U *                                    pointer;
+   typedef U &                                    reference;
+
+   // constructors, destructors, and assignment operator
+   contiguous_iterator()      : p(nullptr) {}
+   contiguous_iterator(U * p) : p(p)       {}
+
+   // an iterator converts to a const_iterator, not the other way
+   template <typename V, typename = typename std::enable_if<std::is_convertible<V *, U *>::value>::type>
+   contiguous_iterator(const contiguous_iterator<V> & rhs) : p(rhs.p) {}
+
+   // dereference operator
+   U & operator *  ()                       const { return *p;       }
+   U * operator -> ()                       const { return p;        }
+   U & operator [] (difference_type offset) const { return p[offset]; }
+
+   // prefix and postfix increment
+   contiguous_iterator & operator ++ ()    { ++p; return *this;                          }
+   contiguous_iterator   operator ++ (int) { contiguous_iterator i(*this); ++p; return i; }
+
+   // prefix and postfix decrement
+   contiguous_iterator & operator -- ()    { --p; return *this;                          }
+   contiguous_iterator   operator -- (int) { contiguous_iterator i(*this); --p; return i; }
+
+   // jump
+   contiguous_iterator & operator += (difference_type offset)      { p += offset; return *this;               }
+   contiguous_iterator & operator -= (difference_type offset)      { p -= offset; return *this;               }
+   contiguous_iterator   operator +  (difference_type offset) const { return contiguous_iterator(p + offset); }
+   contiguous_iterator   operator -  (difference_type offset) const { return contiguous_iterator(p - offset); }
+   friend contiguous_iterator operator + (difference_type offset, const contiguous_iterator & it)
+   {
+      return contiguous_iterator(it.p + offset);
+   }
+
+   // distance, comparisons: any mix of const and non-const
+   template <typename V>
+   difference_type operator -  (const contiguous_iterator<V> & rhs) const { return p - rhs.p;  }
+   template <typename V>
+   bool operator == (const contiguous_iterator<V> & rhs) const { return p == rhs.p; }
+   template <typename V>
+   bool operator != (const contiguous_iterator<V> & rhs) const { return p != rhs.p; }
+   template <typename V>
+   bool operator <  (const contiguous_iterator<V> & rhs) const { return p <  rhs.p; }
+   template <typename V>
+   bool operator >  (const contiguous_iterator<V> & rhs) const { return p >  rhs.p; }
+   template <typename V>
+   bool operator <= (const contiguous_iterator<V> & rhs) const { return p <= rhs.p; }
+   template <typename V>
+   bool operator >= (const contiguous_iterator<V> & rhs) const { return p >= rhs.p; }
+
+#ifdef DEBUG // make this visible to the unit tests
+public:
+#else
+private:
+#endif
+   template <typename V> friend class contiguous_iterator;
+   U * p;
+};
+
+} // namespace custom
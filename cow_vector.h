@@ -0,0 +1,387 @@
+/***********************************************************************
+ * Header:
+ *    COW VECTOR
+ * Summary:
+ *    A vector whose copies share one reference-counted buffer. Copying
+ *    a cow_vector, or a priority queue on one, is O(1) no matter how
+ *    big it is; the buffer is cloned only when someone writes to it
+ *    while someone else still holds it. Reading never clones.
+ *
+ *    This is for taking snapshots of a container that one thread is
+ *    busy changing:
+ *
+ *       custom::cow_priority_queue<Job> pq;       // the worker's queue
+ *       ...
+ *       custom::cow_priority_queue<Job> snapshot; // the monitor's copy
+ *       {
+ *          std::lock_guard<std::mutex> lock(m);   // the worker's lock
+ *          snapshot = pq;                         // O(1)
+ *       }
+ *       inspect(snapshot);                        // no lock needed
+ *
+ *    The copy itself must be made under whatever lock the writer holds,
+ *    as with any container, but it only holds that lock for as long as
+ *    an atomic increment. Afterwards the snapshot and the original are
+ *    independent: the reference count is atomic, and the writer clones
+ *    the buffer before its first change.
+ *
+ *    A non-const operator[], begin(), end(), front(), or back() counts
+ *    as a write, since the caller could write through it. Read through
+ *    a const reference when you only mean to look.
+ *
+ *    This will contain the class definition of:
+ *        cow_vector             : A copy-on-write vector
+ * Author
+ *    Stephen Costigan, Alexander Dohms, Jonathan Colwell, Shaun Crook
+ ************************************************************************/
+
+#pragma once
+
+#include <cassert>
+#include <algorithm>         // for std::max
+#include <atomic>            // for std::atomic
+#include <cstring>           // for std::memcpy
+#include <initializer_list>  // for std::initializer_list
+#include <memory>            // for std::allocator_traits
+#include <new>               // for placement new
+#include <type_traits>       // for std::is_trivially_copyable
+#include <utility>           // for std::move_if_noexcept
+#include "contiguous_iterator.h"
+
+namespace custom
+{
+
+/*****************************************
+ * COW VECTOR
+ * Every copy has its own data, numCapacity, and numElements,
+ * but they all point at the same elements and the same count
+ * of owners. unique remembers that we saw ourselves as the
+ * only owner, so only the first write reads the atomic count.
+ ****************************************/
+template <typename T, typename A = std::allocator<T>>
+class cow_vector
+{
+   typedef std::allocator_traits<A> traits;
+   typedef std::atomic<size_t> counter;
+   typedef typename traits::template rebind_alloc<counter> counter_allocator;
+   typedef std::allocator_traits<counter_allocator>        counter_traits;
+
+public:
+   typedef T                              value_type;
+   typedef A                              allocator_type;
+   typedef size_t                         size_type;
+   typedef contiguous_iterator<T>         iterator;
+   typedef contiguous_iterator<const T>   const_iterator;
+
+   //
+   // Construct
+   //
+
+   cow_vector() : cow_vector(A()) {}
+   explicit cow_vector(const A & a) :
+      data(nullptr), numCapacity(0), numElements(0), refs(nullptr), unique(false), alloc(a) {}
+   cow_vector(size_t num, const T & t, const A & a = A()) : cow_vector(a)
+   {
+      reserve(num);
+      for (size_t i = 0; i < num; i++)
+         push_back(t);
+   }
+   cow_vector(const std::initializer_list<T> & l, const A & a = A()) : cow_vector(a)
+   {
+      reserve(l.size());
+      for (const T & t : l)
+         push_back(t);
+   }
+   cow_vector(const cow_vector & rhs) : cow_vector(rhs.alloc)
+   {
+      share(rhs);
+   }
+   cow_vector(cow_vector && rhs) : cow_vector(rhs.alloc)
+   {
+      steal(rhs);
+   }
+   cow_vector(const cow_vector & rhs, const A & a) : cow_vector(a)
+   {
+      *this = rhs;
+   }
+   cow_vector(cow_vector && rhs, const A & a) : cow_vector(a)
+   {
+      *this = std::move(rhs);
+   }
+   ~cow_vector()
+   {
+      release();
+   }
+
+   //
+   // Assign
+   //
+
+   // share rhs's buffer; the allocators must agree on who frees it
+   cow_vector & operator = (const cow_vector & rhs)
+   {
+      if (refs != nullptr && refs == rhs.refs)
+         return *this;
+      if (alloc == rhs.alloc)
+      {
+         release();
+         share(rhs);
+      }
+      else
+      {
+         clear();
+         reserve(rhs.size());
+         for (const T & t : rhs)
+            push_back(t);
+      }
+      return *this;
+   }
+   cow_vector & operator = (cow_vector && rhs)
+   {
+      if (this == &rhs)
+         return *this;
+      if (alloc == rhs.alloc)
+      {
+         release();
+         steal(rhs);
+      }
+      else
+      {
+         *this = static_cast<const cow_vector &>(rhs);
+         rhs.release();
+      }
+      return *this;
+   }
+   void swap(cow_vector & rhs)
+   {
+      assert(alloc == rhs.alloc);
+      std::swap(data,        rhs.data);
+      std::swap(numCapacity, rhs.numCapacity);
+      std::swap(numElements, rhs.numElements);
+      std::swap(refs,        rhs.refs);
+      std::swap(unique,      rhs.unique);
+   }
+
+   A get_allocator() const { return alloc; }
+
+   //
+   // Iterator
+   //
+
+   iterator       begin()        { write(); return iterator(data);               }
+   iterator       end()          { write(); return iterator(data + numElements); }
+   const_iterator begin()  const { return const_iterator(data);                  }
+   const_iterator end()    const { return const_iterator(data + numElements);    }
+   const_iterator cbegin() const { return begin();                               }
+   const_iterator cend()   const { return end();                                 }
+
+   //
+   // Access
+   //
+
+         T & operator [] (size_t index)       { write(); return data[index];       }
+   const T & operator [] (size_t index) const { return data[index];                }
+         T & front()                          { write(); return data[0];           }
+   const T & front()                    const { return data[0];                    }
+         T & back()                           { write(); return data[numElements - 1]; }
+   const T & back()                     const { return data[numElements - 1];      }
+
+   //
+   // Insert
+   //
+
+   void push_back(const T & t) { emplace_back(t);            }
+   void push_back(T && t)      { emplace_back(std::move(t)); }
+
+   template <class ... Args>
+   T & emplace_back(Args&& ... args)
+   {
+      if (!writable(numElements + 1))
+      {
+         // the args may be one of our elements: build it before moving house
+         T t(std::forward<Args>(args)...);
+         own(numElements + 1);
+         traits::construct(alloc, data + numElements, std::move(t));
+      }
+      else
+         traits::construct(alloc, data + numElements, std::forward<Args>(args)...);
+      return data[numElements++];
+   }
+
+   void reserve(size_t newCapacity)
+   {
+      if (newCapacity > numCapacity)
+         own(newCapacity);
+   }
+
+   void resize(size_t newElements)
+   {
+      own(std::max(newElements, numCapacity));
+      while (numElements > newElements)
+         traits::destroy(alloc, data + --numElements);
+      for (; numElements < newElements; numElements++)
+         traits::construct(alloc, data + numElements);
+   }
+
+   //
+   // Remove
+   //
+
+   void pop_back()
+   {
+      if (numElements > 0)
+      {
+         write();
+         traits::destroy(alloc, data + --numElements);
+      }
+   }
+
+   // a shared buffer is let go of, not cloned and then emptied
+   void clear()
+   {
+      if (!writable(0))
+         release();
+      else
+         while (numElements > 0)
+            traits::destroy(alloc, data + --numElements);
+   }
+
+   //
+   // Status
+   //
+
+   size_t size()      const { return numElements;                }
+   size_t capacity()  const { return numCapacity;                }
+   bool   empty()     const { return numElements == 0;           }
+   size_t use_count() const { return refs ? refs->load(std::memory_order_acquire) : 0; }
+   bool   is_shared() const { return use_count() > 1;            }
+
+#ifdef DEBUG // make this visible to the unit tests
+public:
+#else
+private:
+#endif
+
+   // about to hand out a non-const reference
+   void write()
+   {
+      if (!unique)
+         own(numCapacity);
+   }
+
+   // one more owner of rhs's buffer. Neither of us is its only owner now.
+   void share(const cow_vector & rhs)
+   {
+      data        = rhs.data;
+      numCapacity = rhs.numCapacity;
+      numElements = rhs.numElements;
+      refs        = rhs.refs;
+      unique      = false;
+      if (refs)
+         refs->fetch_add(1, std::memory_order_relaxed);
+      if (rhs.unique)
+         rhs.unique = false;
+   }
+
+   // rhs's buffer, and rhs's place as its owner
+   void steal(cow_vector & rhs)
+   {
+      data        = rhs.data;
+      numCapacity = rhs.numCapacity;
+      numElements = rhs.numElements;
+      refs        = rhs.refs;
+      unique      = rhs.unique;
+      rhs.data        = nullptr;
+      rhs.numCapacity = rhs.numElements = 0;
+      rhs.refs        = nullptr;
+      rhs.unique      = false;
+   }
+
+   // one less owner; the last one out destroys the buffer
+   void release()
+   {
+      if (refs && refs->fetch_sub(1, std::memory_order_acq_rel) == 1)
+      {
+         for (size_t i = 0; i < numElements; i++)
+            traits::destroy(alloc, data + i);
+         traits::deallocate(alloc, data, numCapacity);
+         counter_allocator counterAlloc(alloc);
+         refs->~counter();
+         counter_traits::deallocate(counterAlloc, refs, 1);
+      }
+      data        = nullptr;
+      numCapacity = numElements = 0;
+      refs        = nullptr;
+      unique      = false;
+   }
+
+   // can we write to our buffer, with room for minCapacity, as it is?
+   // Once we are its only owner we stay so until someone copies us.
+   bool writable(size_t minCapacity)
+   {
+      if (!refs || numCapacity < minCapacity)
+         return false;
+      if (!unique)
+         unique = refs->load(std::memory_order_acquire) == 1;
+      return unique;
+   }
+
+   // become the only owner of a buffer with room for minCapacity: clone
+   // the elements if someone else holds them, else move them if we must grow
+   void own(size_t minCapacity)
+   {
+      if (writable(minCapacity) || (!refs && minCapacity == 0))
+         return;
+
+      size_t newCapacity = numCapacity;
+      if (minCapacity > newCapacity)
+         newCapacity = std::max(minCapacity, newCapacity * 2);
+
+      counter_allocator counterAlloc(alloc);
+      counter * refsNew = counter_traits::allocate(counterAlloc, 1);
+      T * dataNew = nullptr;
+      size_t i = 0;
+      try
+      {
+         dataNew = traits::allocate(alloc, newCapacity);
+         if (std::is_trivially_copyable<T>::value)
+         {
+            if (numElements)
+               std::memcpy((void *)dataNew, (const void *)data, numElements * sizeof(T));
+         }
+         else if (is_shared())
+            for (; i < numElements; i++)
+               traits::construct(alloc, dataNew + i, static_cast<const T &>(data[i]));
+         else
+            for (; i < numElements; i++)
+               traits::construct(alloc, dataNew + i, std::move_if_noexcept(data[i]));
+      }
+      catch (...)
+      {
+         while (i > 0)
+            traits::destroy(alloc, dataNew + --i);
+         if (dataNew)
+            traits::deallocate(alloc, dataNew, newCapacity);
+         counter_traits::deallocate(counterAlloc, refsNew, 1);
+         throw;
+      }
+
+      ::new ((void *)refsNew) counter(1);
+      size_t num = numElements;
+      release();
+      data        = dataNew;
+      numCapacity = newCapacity;
+      numElements = num;
+      refs        = refsNew;
+      unique      = true;
+   }
+
+   T *          data;
+   size_t       numCapacity;
+   size_t       numElements;
+   counter *    refs;      // how many vectors share data; nullptr if no data
+   mutable bool unique;    // copying from us clears it
+   A            alloc;
+};
+
+} // namespace custom
@@ -0,0 +1,56 @@
+/***********************************************************************
+ * Header:
+ *    EXECUTION
+ * Summary:
+ *    Execution policies for the bulk operations on our containers,
+ *    modeled after std::execution::seq and std::execution::par.
+ *    Unlike the standard ones, the parallel policy carries the
+ *    number of worker threads to use.
+ *
+ *    This will contain the definition of:
+ *        execution::sequenced_policy : Run on the calling thread
+ *        execution::parallel_policy  : Run on a pool of workers
+ * Author
+ *    Stephen Costigan, Alexander Dohms, Jonathan Colwell, Shaun Crook
+ ************************************************************************/
+
+#pragma once
+
+#include "thread_pool.h"   // for thread_pool::defaultConcurrency()
+
+namespace custom
+{
+namespace execution
+{
+
+/*****************************************
+ * SEQUENCED POLICY
+ * Do all the work on the calling thread
+ ****************************************/
+struct sequenced_policy
+{
+};
+
+/*****************************************
+ * PARALLEL POLICY
+ * Split the work across numThreads workers. A policy with
+ * zero threads means "one per hardware thread."
+ ****************************************/
+struct parallel_policy
+{
+   size_t numThreads;
+
+   // par.threads(4) gives a policy pinned to four workers
+   parallel_policy threads(size_t num) const { return parallel_policy{ num }; }
+
+   size_t concurrency() const
+   {
+      return numThreads == 0 ? thread_pool::defaultConcurrency() : numThreads;
+   }
+};
+
+constexpr sequenced_policy seq{};
+constexpr parallel_policy  par{ 0 };
+
+} // namespace execution
+} // namespace custom
@@ -0,0 +1,111 @@
+/***********************************************************************
+ * Header:
+ *    GROWTH
+ * Summary:
+ *    Growth policies: how much bigger a vector's buffer gets when
+ *    push_back() finds it full. The vector calls
+ *
+ *       Growth::next(capacity, sizeof(T))
+ *
+ *    and gets back the new capacity, which is always more than the
+ *    old one.
+ *
+ *    A factor of 2 does the fewest reallocations. A factor of 1.5
+ *    wastes less memory and lets the allocator reuse the space freed
+ *    by earlier buffers. page_rounded makes big buffers a whole
+ *    number of pages, since the memory is there anyway.
+ *
+ *    A policy may also say when to give memory back. If it has
+ *
+ *       Growth::shrink(capacity, size, sizeof(T))
+ *
+ *    the vector calls it after every pop_back() and moves into a
+ *    buffer of the capacity it returns, if that is smaller. None of
+ *    the policies above have one, so by default a vector keeps its
+ *    biggest buffer until shrink_to_fit(). auto_shrink halves the
+ *    buffer once it is less than a quarter full. Halving leaves it
+ *    less than half full, so the size has to double before the next
+ *    push_back() grows it again: pushing and popping around one size
+ *    never reallocates back and forth.
+ *
+ *    This will contain the definition of:
+ *        growth::factor         : Multiply the capacity by Num / Den
+ *        growth::factor_2       : Double (the default)
+ *        growth::factor_1_5     : Grow by half
+ *        growth::page_rounded   : Another policy, rounded up to a page
+ *        growth::auto_shrink    : Another policy, and halve when sparse
+ * Author
+ *    Stephen Costigan, Alexander Dohms, Jonathan Colwell, Shaun Crook
+ ************************************************************************/
+
+#pragma once
+
+#include <cstddef>   // for size_t
+
+namespace custom
+{
+namespace growth
+{
+
+/*****************************************
+ * FACTOR
+ * capacity * Num / Den, but always at least one more
+ ****************************************/
+template <size_t Num, size_t Den>
+struct factor
+{
+   static_assert(Num > Den, "a growth factor must be more than one");
+
+   static size_t next(size_t capacity, size_t /* sizeOfT */)
+   {
+      size_t grown = capacity / Den * Num + capacity % Den * Num / Den;
+      return grown > capacity ? grown : capacity + 1;
+   }
+};
+
+typedef factor<2, 1> factor_2;
+typedef factor<3, 2> factor_1_5;
+
+/*****************************************
+ * PAGE ROUNDED
+ * Grow the way Base does, then, once the buffer is a page or
+ * more, round it up to fill its last page
+ ****************************************/
+template <class Base = factor_2, size_t PageSize = 4096>
+struct page_rounded
+{
+   static size_t next(size_t capacity, size_t sizeOfT)
+   {
+      size_t grown = Base::next(capacity, sizeOfT);
+      size_t bytes = grown * sizeOfT;
+      if (bytes < PageSize)
+         return grown;
+      bytes = (bytes + PageSize - 1) / PageSize * PageSize;
+      return bytes / sizeOfT;
+   }
+};
+
+/*****************************************
+ * AUTO SHRINK
+ * Grow the way Base does. Halve the capacity when fewer than
+ * a quarter of it is used, but never below MinBytes, where
+ * the memory is not worth a reallocation.
+ ****************************************/
+template <class Base = factor_2, size_t MinBytes = 4096>
+struct auto_shrink
+{
+   static size_t next(size_t capacity, size_t sizeOfT)
+   {
+      return Base::next(capacity, sizeOfT);
+   }
+
+   static size_t shrink(size_t capacity, size_t size, size_t sizeOfT)
+   {
+      if (size >= capacity / 4 || capacity / 2 * sizeOfT < MinBytes)
+         return capacity;
+      return capacity / 2;
+   }
+};
+
+} // namespace growth
+} // namespace custom
@@ -0,0 +1,196 @@
+/***********************************************************************
+ * Header:
+ *    INCREMENTAL VECTOR
+ * Summary:
+ *    A vector for code that cannot afford one slow push_back(). When
+ *    custom::vector fills up, the push_back() that noticed moves every
+ *    element to the new buffer, so one call out of many is O(n).
+ *
+ *    This one keeps the old buffer around after it grows. Each later
+ *    push_back() moves a few elements from the old buffer to the new
+ *    one, just enough that the move is finished by the time the new
+ *    buffer is full. No push_back() ever moves more than a handful of
+ *    elements, so the worst case is O(1) instead of O(n).
+ *
+ *    The price is a branch in operator[]: while a move is going on,
+ *    an element can be in either buffer.
+ *
+ *    This will contain the class definition of:
+ *        incremental_vector     : A vector with de-amortized growth
+ * Author
+ *    Stephen Costigan, Alexander Dohms, Jonathan Colwell, Shaun Crook
+ ************************************************************************/
+
+#pragma once
+
+#include <cassert>
+#include <memory>    // for std::allocator_traits
+#include <utility>   // for std::move_if_noexcept
+#include "growth.h"  // for growth::factor_2
+
+namespace custom
+{
+
+/*****************************************
+ * INCREMENTAL VECTOR
+ * Elements [0, numMigrated) and [numOld, numElements) are in
+ * data; elements [numMigrated, numOld) are still in dataOld.
+ ****************************************/
+template <typename T, typename A = std::allocator<T>, typename Growth = growth::factor_2>
+class incremental_vector
+{
+   typedef std::allocator_traits<A> traits;
+
+public:
+   typedef T      value_type;
+   typedef A      allocator_type;
+   typedef size_t size_type;
+
+   //
+   // Construct
+   //
+
+   incremental_vector() : incremental_vector(A()) {}
+   explicit incremental_vector(const A & a) :
+      data(nullptr), numCapacity(0), numElements(0),
+      dataOld(nullptr), numOldCapacity(0), numOld(0), numMigrated(0),
+      numPerPush(0), alloc(a) {}
+   incremental_vector(const incremental_vector &) = delete;
+   incremental_vector & operator = (const incremental_vector &) = delete;
+   ~incremental_vector()
+   {
+      clear();
+      if (data)
+         traits::deallocate(alloc, data, numCapacity);
+   }
+
+   //
+   // Access
+   //
+
+   T & operator [] (size_t index)
+   {
+      return (index >= numMigrated && index < numOld) ? dataOld[index] : data[index];
+   }
+   const T & operator [] (size_t index) const
+   {
+      return (index >= numMigrated && index < numOld) ? dataOld[index] : data[index];
+   }
+   T & back() { return (*this)[numElements - 1]; }
+
+   //
+   // Insert
+   //
+
+   void push_back(const T & t) { emplace_back(t);            }
+   void push_back(T && t)      { emplace_back(std::move(t)); }
+
+   template <class ... Args>
+   T & emplace_back(Args&& ... args)
+   {
+      if (numElements == numCapacity)
+         grow();
+
+      // the args may be in dataOld, so build first and migrate after
+      traits::construct(alloc, data + numElements, std::forward<Args>(args)...);
+      numElements++;
+      migrate(numPerPush);
+      return data[numElements - 1];
+   }
+
+   //
+   // Remove
+   //
+
+   void pop_back()
+   {
+      assert(numElements > 0);
+      size_t index = --numElements;
+      if (index >= numMigrated && index < numOld)
+      {
+         traits::destroy(alloc, dataOld + index);
+         numOld = index;
+         if (numMigrated == numOld)
+            finishMigration();
+      }
+      else
+         traits::destroy(alloc, data + index);
+   }
+
+   void clear()
+   {
+      while (numElements > 0)
+         pop_back();
+   }
+
+   //
+   // Status
+   //
+
+   size_t size()      const { return numElements;         }
+   size_t capacity()  const { return numCapacity;         }
+   bool   empty()     const { return numElements == 0;    }
+   bool   migrating() const { return dataOld != nullptr;  }   // is there an old buffer?
+
+#ifdef DEBUG // make this visible to the unit tests
+public:
+#else
+private:
+#endif
+
+   // start a new buffer, leaving the elements where they are for now
+   void grow()
+   {
+      migrate(numOld);   // the last move always finishes first
+      assert(!migrating());
+
+      size_t newCapacity = Growth::next(numCapacity, sizeof(T));
+      T * dataNew = traits::allocate(alloc, newCapacity);
+
+      dataOld = data;
+      numOldCapacity = numCapacity;
+      numOld = numElements;
+      numMigrated = 0;
+      data = dataNew;
+      numCapacity = newCapacity;
+
+      // move numOld elements in the (newCapacity - numOld) pushes before the next grow()
+      size_t room = newCapacity - numOld;
+      numPerPush = (numOld + room - 1) / room;
+      if (numOld == 0)
+         finishMigration();
+   }
+
+   // move up to num elements from the old buffer to the new one
+   void migrate(size_t num)
+   {
+      for (; num > 0 && numMigrated < numOld; num--, numMigrated++)
+      {
+         traits::construct(alloc, data + numMigrated, std::move_if_noexcept(dataOld[numMigrated]));
+         traits::destroy(alloc, dataOld + numMigrated);
+      }
+      if (migrating() && numMigrated == numOld)
+         finishMigration();
+   }
+
+   // everything is in the new buffer: free the old one
+   void finishMigration()
+   {
+      if (dataOld)
+         traits::deallocate(alloc, dataOld, numOldCapacity);
+      dataOld = nullptr;
+      numOldCapacity = numOld = numMigrated = 0;
+   }
+
+   T *    data;             // the new buffer, where everything will be
+   size_t numCapacity;
+   size_t numElements;
+   T *    dataOld;          // the buffer being emptied, or nullptr
+   size_t numOldCapacity;
+   size_t numOld;           // elements [numMigrated, numOld) are still in dataOld
+   size_t numMigrated;
+   size_t numPerPush;       // elements to move on each push_back()
+   A      alloc;
+};
+
+} // namespace custom
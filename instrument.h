@@ -0,0 +1,169 @@
+/***********************************************************************
+ * Header:
+ *    INSTRUMENT
+ * Summary:
+ *    Instrumentation policies for vector and priority_queue. The Spy
+ *    can only count what a Spy does; these count what the container
+ *    does, whatever the element type is.
+ *
+ *    The containers inherit from the policy, so the empty default
+ *    policy takes no space and every hook compiles to nothing.
+ *    Build with -DINSTRUMENT to make the counting policy the default
+ *    everywhere without touching any code.
+ *
+ *    This will contain the definition of:
+ *        instrument_stats       : What was counted
+ *        instrument::none       : Count nothing (the default)
+ *        instrument::counting   : Count into this container's own stats
+ *        instrument::is_policy  : Whether a class is one of these policies
+ *        instrument::statsOf    : stats() of any container, zeros if it has none
+ * Author
+ *    Stephen Costigan, Alexander Dohms, Jonathan Colwell, Shaun Crook
+ ************************************************************************/
+
+#pragma once
+
+#include <atomic>    // for std::atomic
+#include <cstddef>   // for size_t
+#include <type_traits> // for std::true_type
+
+namespace custom
+{
+
+/*****************************************
+ * INSTRUMENT STATS
+ * The numbers reported by stats()
+ ****************************************/
+struct instrument_stats
+{
+   size_t compares;        // calls to operator< made by the container
+   size_t moves;           // elements copied or moved by the container
+   size_t siftLevels;      // levels an element travelled in the heap
+   size_t reallocations;   // times the buffer was replaced
+};
+
+namespace instrument
+{
+
+/*****************************************
+ * NONE
+ * Every hook is empty and inlined away
+ ****************************************/
+class none
+{
+protected:
+   void onCompare()                  {}
+   void onMove(size_t = 1)           {}
+   void onSift(size_t = 1)           {}
+   void onReallocate()               {}
+
+   instrument_stats getStats() const { return instrument_stats{ 0, 0, 0, 0 }; }
+   void resetStats()                 {}
+};
+
+/*****************************************
+ * COUNTING
+ * Every hook bumps a counter belonging to this one container.
+ * The counters are relaxed atomics: a parallel heapify calls
+ * the hooks from every worker at once, and only the totals matter.
+ ****************************************/
+class counting
+{
+public:
+   counting() { resetStats(); }
+
+   // a copy of a container starts counting from zero
+   counting(const counting &)               { resetStats(); }
+   counting & operator = (const counting &) { return *this; }
+
+protected:
+   void onCompare()                  { bump(compares);           }
+   void onMove(size_t num = 1)       { bump(moves, num);         }
+   void onSift(size_t num = 1)       { bump(siftLevels, num);    }
+   void onReallocate()               { bump(reallocations);      }
+
+   instrument_stats getStats() const
+   {
+      return instrument_stats{ compares.load(std::memory_order_relaxed),
+                               moves.load(std::memory_order_relaxed),
+                               siftLevels.load(std::memory_order_relaxed),
+                               reallocations.load(std::memory_order_relaxed) };
+   }
+   void resetStats()
+   {
+      compares.store(0, std::memory_order_relaxed);
+      moves.store(0, std::memory_order_relaxed);
+      siftLevels.store(0, std::memory_order_relaxed);
+      reallocations.store(0, std::memory_order_relaxed);
+   }
+
+private:
+   std::atomic<size_t> compares;
+   std::atomic<size_t> moves;
+   std::atomic<size_t> siftLevels;
+   std::atomic<size_t> reallocations;
+
+   static void bump(std::atomic<size_t> & counter, size_t num = 1)
+   {
+      counter.fetch_add(num, std::memory_order_relaxed);
+   }
+};
+
+/*****************************************
+ * IS POLICY
+ * Whether a class is an instrument policy rather
+ * than a container. A policy of your own says so
+ * with a specialization of its own.
+ ****************************************/
+template <class Policy>
+struct is_policy : std::false_type {};
+template <>
+struct is_policy <none> : std::true_type {};
+template <>
+struct is_policy <counting> : std::true_type {};
+
+/*****************************************
+ * STATS OF
+ * The stats of a container, or zeros for a container
+ * (like std::vector) that does not keep any
+ ****************************************/
+template <class Container>
+auto statsOf(const Container & c, int) -> decltype(c.stats())
+{
+   return c.stats();
+}
+template <class Container>
+instrument_stats statsOf(const Container &, long)
+{
+   return instrument_stats{ 0, 0, 0, 0 };
+}
+template <class Container>
+instrument_stats statsOf(const Container & c)
+{
+   return statsOf(c, 0);
+}
+
+template <class Container>
+auto resetStatsOf(Container & c, int) -> decltype(c.reset_stats())
+{
+   c.reset_stats();
+}
+template <class Container>
+void resetStatsOf(Container &, long)
+{
+}
+template <class Container>
+void resetStatsOf(Container & c)
+{
+   resetStatsOf(c, 0);
+}
+
+} // namespace instrument
+
+#ifdef INSTRUMENT
+typedef instrument::counting default_instrument;
+#else
+typedef instrument::none     default_instrument;
+#endif // INSTRUMENT
+
+} // namespace custom
@@ -0,0 +1,411 @@
+/***********************************************************************
+ * Header:
+ *    LATENCY
+ * Summary:
+ *    Record how long each push(), pop(), and top() takes so the rare
+ *    slow one (a push() that has to reallocate the whole container)
+ *    shows up in the tail percentiles instead of hiding in the mean.
+ *
+ *    The histogram is log-linear like HdrHistogram: every power of two
+ *    is split into 32 linear sub-buckets, so any recorded value is
+ *    reported within about 3% of what it really was, from 1ns to
+ *    centuries, in a fixed 15K table.
+ *
+ *    A histogram has one writer. Give each thread its own and merge()
+ *    them, or add() them to a latency_collector, when it is time to look.
+ *
+ *    This will contain the class definition of:
+ *        latency_histogram      : Log-linear histogram of nanoseconds
+ *        latency_collector      : Thread-safe sum of many histograms
+ *        steady_clock_source    : Timestamps from std::chrono::steady_clock
+ *        tsc_clock_source       : Timestamps from the x86 rdtsc instruction
+ *        timed_priority_queue   : priority_queue that records its latencies
+ * Author
+ *    Stephen Costigan, Alexander Dohms, Jonathan Colwell, Shaun Crook
+ ************************************************************************/
+
+#pragma once
+
+#include <cassert>
+#include <chrono>    // for std::chrono::steady_clock
+#include <cstdint>   // for uint64_t
+#include <mutex>     // for std::mutex
+#include <ostream>   // for std::ostream
+#include "priority_queue.h"
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>  // for __rdtsc
+#define CUSTOM_HAS_TSC
+#elif defined(_M_X64) || defined(_M_IX86)
+#include <intrin.h>     // for __rdtsc
+#define CUSTOM_HAS_TSC
+#endif
+
+namespace custom
+{
+
+/*****************************************
+ * LATENCY HISTOGRAM
+ * Counts of nanosecond values in log-linear buckets
+ ****************************************/
+class latency_histogram
+{
+public:
+   latency_histogram() { reset(); }
+
+   //
+   // Record
+   //
+
+   void record(uint64_t ns)
+   {
+      buckets[indexOf(ns)]++;
+      numValues++;
+      sum += ns;
+      if (ns < valueMin)
+         valueMin = ns;
+      if (ns > valueMax)
+         valueMax = ns;
+   }
+   void merge(const latency_histogram & rhs);
+   void reset();
+
+   //
+   // Query
+   //
+
+   uint64_t count() const { return numValues;                         }
+   uint64_t min()   const { return numValues ? valueMin : 0;          }
+   uint64_t max()   const { return valueMax;                          }
+   double   mean()  const { return numValues ? (double)sum / numValues : 0.0; }
+   uint64_t percentile(double p) const;
+
+   //
+   // Report
+   //
+
+   void dump_text(std::ostream & out) const;
+   void dump_json(std::ostream & out) const;
+
+#ifdef DEBUG // make this visible to the unit tests
+public:
+#else
+private:
+#endif
+
+   // 32 sub-buckets per power of two
+   static const int      subBits    = 5;
+   static const uint64_t subCount   = uint64_t(1) << subBits;
+   static const size_t   numBuckets = 2 * subCount + (64 - subBits - 1) * subCount;
+
+   // which bucket holds this value
+   static size_t indexOf(uint64_t ns)
+   {
+      if (ns < 2 * subCount)
+         return (size_t)ns;
+      int exponent = log2(ns) - subBits;           // at least 1
+      uint64_t sub = ns >> exponent;               // [subCount, 2 * subCount)
+      return (size_t)(2 * subCount + (exponent - 1) * subCount + (sub - subCount));
+   }
+
+   // the smallest value that lands in this bucket
+   static uint64_t lowestOf(size_t index)
+   {
+      if (index < 2 * subCount)
+         return index;
+      int exponent = (int)((index - 2 * subCount) / subCount) + 1;
+      uint64_t sub = (index - 2 * subCount) % subCount + subCount;
+      return sub << exponent;
+   }
+
+   // the largest value that lands in this bucket
+   static uint64_t highestOf(size_t index)
+   {
+      return index + 1 < numBuckets ? lowestOf(index + 1) - 1 : UINT64_MAX;
+   }
+
+   static int log2(uint64_t value)
+   {
+      int bits = 0;
+      while (value >>= 1)
+         bits++;
+      return bits;
+   }
+
+   uint64_t buckets[numBuckets];
+   uint64_t numValues;
+   uint64_t sum;
+   uint64_t valueMin;
+   uint64_t valueMax;
+};
+
+/*****************************************
+ * LATENCY HISTOGRAM :: RESET
+ ****************************************/
+inline void latency_histogram :: reset()
+{
+   for (size_t i = 0; i < numBuckets; i++)
+      buckets[i] = 0;
+   numValues = 0;
+   sum = 0;
+   valueMin = UINT64_MAX;
+   valueMax = 0;
+}
+
+/*****************************************
+ * LATENCY HISTOGRAM :: MERGE
+ * Add every value recorded in rhs to this histogram
+ ****************************************/
+inline void latency_histogram :: merge(const latency_histogram & rhs)
+{
+   for (size_t i = 0; i < numBuckets; i++)
+      buckets[i] += rhs.buckets[i];
+   numValues += rhs.numValues;
+   sum += rhs.sum;
+   if (rhs.valueMin < valueMin)
+      valueMin = rhs.valueMin;
+   if (rhs.valueMax > valueMax)
+      valueMax = rhs.valueMax;
+}
+
+/*****************************************
+ * LATENCY HISTOGRAM :: PERCENTILE
+ * The value that p percent (0..100) of the recordings are at or
+ * below. Like HdrHistogram, this reports the top of the bucket,
+ * but never more than the largest value actually recorded.
+ ****************************************/
+inline uint64_t latency_histogram :: percentile(double p) const
+{
+   if (numValues == 0)
+      return 0;
+   if (p < 0.0)
+      p = 0.0;
+   if (p > 100.0)
+      p = 100.0;
+
+   // the rank of the value we are after, counting from one
+   uint64_t rank = (uint64_t)(p / 100.0 * (double)numValues + 0.5);
+   if (rank == 0)
+      rank = 1;
+
+   uint64_t seen = 0;
+   for (size_t i = 0; i < numBuckets; i++)
+   {
+      seen += buckets[i];
+      if (seen >= rank)
+      {
+         uint64_t value = highestOf(i);
+         return value < valueMax ? value : valueMax;
+      }
+   }
+   return valueMax;
+}
+
+/*****************************************
+ * LATENCY HISTOGRAM :: DUMP TEXT
+ * A table of the usual percentiles, one per line
+ ****************************************/
+inline void latency_histogram :: dump_text(std::ostream & out) const
+{
+   static const double ps[] = { 50.0, 90.0, 99.0, 99.9, 99.99, 100.0 };
+   out << "count " << count() << "\n"
+       << "min   " << min()   << " ns\n"
+       << "mean  " << mean()  << " ns\n";
+   for (double p : ps)
+      out << "p" << p << "\t" << percentile(p) << " ns\n";
+}
+
+/*****************************************
+ * LATENCY HISTOGRAM :: DUMP JSON
+ * The summary plus every non-empty bucket as [low, high, count]
+ ****************************************/
+inline void latency_histogram :: dump_json(std::ostream & out) const
+{
+   out << "{\"count\":" << count()
+       << ",\"min\":"   << min()
+       << ",\"max\":"   << max()
+       << ",\"mean\":"  << mean()
+       << ",\"p50\":"   << percentile(50.0)
+       << ",\"p90\":"   << percentile(90.0)
+       << ",\"p99\":"   << percentile(99.0)
+       << ",\"p99.9\":" << percentile(99.9)
+       << ",\"p99.99\":" << percentile(99.99)
+       << ",\"buckets\":[";
+   bool first = true;
+   for (size_t i = 0; i < numBuckets; i++)
+      if (buckets[i])
+      {
+         out << (first ? "" : ",")
+             << "[" << lowestOf(i) << "," << highestOf(i) << "," << buckets[i] << "]";
+         first = false;
+      }
+   out << "]}";
+}
+
+/*****************************************
+ * LATENCY COLLECTOR
+ * Worker threads add() their histograms as they finish;
+ * snapshot() is the merge of everything added so far.
+ ****************************************/
+class latency_collector
+{
+public:
+   void add(const latency_histogram & h)
+   {
+      std::lock_guard<std::mutex> guard(lock);
+      total.merge(h);
+   }
+
+   latency_histogram snapshot() const
+   {
+      std::lock_guard<std::mutex> guard(lock);
+      return total;
+   }
+
+private:
+   mutable std::mutex lock;
+   latency_histogram  total;
+};
+
+/*****************************************
+ * STEADY CLOCK SOURCE
+ * Portable, about 20ns a reading
+ ****************************************/
+struct steady_clock_source
+{
+   static uint64_t now()
+   {
+      return (uint64_t)std::chrono::duration_cast<std::chrono::nanoseconds>(
+         std::chrono::steady_clock::now().time_since_epoch()).count();
+   }
+   static uint64_t toNanoseconds(uint64_t ticks) { return ticks; }
+};
+
+#ifdef CUSTOM_HAS_TSC
+/*****************************************
+ * TSC CLOCK SOURCE
+ * A few nanoseconds a reading. Assumes an invariant TSC, which
+ * every x86 of the last decade has. The tick rate is measured
+ * against steady_clock the first time it is needed.
+ ****************************************/
+struct tsc_clock_source
+{
+   static uint64_t now() { return __rdtsc(); }
+
+   static uint64_t toNanoseconds(uint64_t ticks)
+   {
+      return (uint64_t)((double)ticks * nsPerTick());
+   }
+
+   static double nsPerTick()
+   {
+      static const double rate = calibrate();
+      return rate;
+   }
+
+private:
+   static double calibrate()
+   {
+      uint64_t nsBegin = steady_clock_source::now();
+      uint64_t ticksBegin = __rdtsc();
+      while (steady_clock_source::now() - nsBegin < 10000000)   // 10ms
+         ;
+      uint64_t nsEnd = steady_clock_source::now();
+      uint64_t ticksEnd = __rdtsc();
+      return (double)(nsEnd - nsBegin) / (double)(ticksEnd - ticksBegin);
+   }
+};
+#endif // CUSTOM_HAS_TSC
+
+/*****************************************
+ * TIMED PRIORITY QUEUE
+ * A priority_queue that times every push(), pop(), and top()
+ ****************************************/
+template <class T, class Queue = custom::priority_queue<T>, class Clock = steady_clock_source>
+class timed_priority_queue
+{
+public:
+
+   //
+   // Insert and remove
+   //
+
+   void push(const T & t)
+   {
+      uint64_t begin = Clock::now();
+      pq.push(t);
+      latencyPush.record(Clock::toNanoseconds(Clock::now() - begin));
+   }
+   void push(T && t)
+   {
+      uint64_t begin = Clock::now();
+      pq.push(std::move(t));
+      latencyPush.record(Clock::toNanoseconds(Clock::now() - begin));
+   }
+   void pop()
+   {
+      uint64_t begin = Clock::now();
+      pq.pop();
+      latencyPop.record(Clock::toNanoseconds(Clock::now() - begin));
+   }
+   const T & top()
+   {
+      uint64_t begin = Clock::now();
+      const T & t = pq.top();
+      latencyTop.record(Clock::toNanoseconds(Clock::now() - begin));
+      return t;
+   }
+
+   //
+   // Status
+   //
+
+   size_t size()  const { return pq.size();  }
+   bool   empty() const { return pq.empty(); }
+   const Queue & queue() const { return pq; }
+
+   //
+   // Latency
+   //
+
+   const latency_histogram & push_latency() const { return latencyPush; }
+   const latency_histogram & pop_latency()  const { return latencyPop;  }
+   const latency_histogram & top_latency()  const { return latencyTop;  }
+
+   void reset_latency()
+   {
+      latencyPush.reset();
+      latencyPop.reset();
+      latencyTop.reset();
+   }
+
+   // {"push":{...},"pop":{...},"top":{...}}
+   void dump_json(std::ostream & out) const
+   {
+      out << "{\"push\":";
+      latencyPush.dump_json(out);
+      out << ",\"pop\":";
+      latencyPop.dump_json(out);
+      out << ",\"top\":";
+      latencyTop.dump_json(out);
+      out << "}";
+   }
+
+   void dump_text(std::ostream & out) const
+   {
+      out << "push\n";
+      latencyPush.dump_text(out);
+      out << "pop\n";
+      latencyPop.dump_text(out);
+      out << "top\n";
+      latencyTop.dump_text(out);
+   }
+
+private:
+   Queue             pq;
+   latency_histogram latencyPush;
+   latency_histogram latencyPop;
+   latency_histogram latencyTop;
+};
+
+} // namespace custom
@@ -0,0 +1,413 @@
+/***********************************************************************
+ * Header:
+ *    MAPPED VECTOR
+ * Summary:
+ *    A vector that lives in a file instead of in memory. The file is
+ *    mapped with mmap(), so the elements are read and written like any
+ *    array and the operating system pages them in and out: a vector of
+ *    tens of gigabytes only needs as much RAM as the part being used.
+ *
+ *       custom::mapped_vector<Record> v("records.bin");
+ *       v.advise(custom::mapped_vector<Record>::advice::sequential);
+ *       for (size_t i = 0; i < n; i++)
+ *          v.push_back(make(i));
+ *       v.sync();              // on the disk now, not just in the cache
+ *
+ *    Opening the same file again gets the same elements back. Without
+ *    a file name the vector lives in a nameless temporary file, which
+ *    is what a priority queue on one gets:
+ *
+ *       custom::priority_queue<Event, custom::mapped_vector<Event>> pq;
+ *
+ *    The file starts with one page of header: a check that the file is
+ *    ours and the element size and count. The elements start on the
+ *    second page. Growing the file is ftruncate() and, on Linux,
+ *    mremap(); elsewhere the file is mapped again and then the old
+ *    mapping dropped, so a failure leaves the vector as it was.
+ *
+ *    T must be trivially copyable: its bytes are all that is saved.
+ *    There is no mapped_vector without mmap() (Windows).
+ *
+ *    This will contain the class definition of:
+ *        mapped_vector          : A vector in a memory-mapped file
+ * Author
+ *    Stephen Costigan, Alexander Dohms, Jonathan Colwell, Shaun Crook
+ ************************************************************************/
+
+#pragma once
+
+#include "mmap_allocator.h"  // for CUSTOM_HAS_MMAP and CUSTOM_HAS_MREMAP
+
+#ifdef CUSTOM_HAS_MMAP
+
+#include <cassert>
+#include <algorithm>         // for std::max
+#include <cerrno>            // for errno
+#include <cstdint>           // for uint64_t
+#include <cstdlib>           // for std::getenv
+#include <cstring>           // for std::memcpy
+#include <initializer_list>  // for std::initializer_list
+#include <new>               // for placement new
+#include <stdexcept>         // for std::runtime_error
+#include <string>
+#include <system_error>      // for std::system_error
+#include <type_traits>       // for std::is_trivially_copyable
+#include <fcntl.h>           // for open
+#include <sys/stat.h>        // for fstat
+#include <unistd.h>          // for ftruncate, close, sysconf
+#include "contiguous_iterator.h"
+
+namespace custom
+{
+
+/*****************************************
+ * MAPPED VECTOR
+ * base is the whole mapping: the header page, then the
+ * elements at data. numCapacity is how many fit in the file.
+ ****************************************/
+template <typename T>
+class mapped_vector
+{
+   static_assert(std::is_trivially_copyable<T>::value,
+                 "a mapped_vector only keeps the bytes of its elements");
+
+   // the first page of the file
+   struct header
+   {
+      uint64_t magic;
+      uint64_t sizeOfT;
+      uint64_t numElements;
+   };
+   static const uint64_t magicNumber = 0x43555354564d4150ull;   // "CUSTVMAP"
+
+public:
+   typedef T                              value_type;
+   typedef size_t                         size_type;
+   typedef contiguous_iterator<T>         iterator;
+   typedef contiguous_iterator<const T>   const_iterator;
+
+   // how the vector is about to be used, for the page cache
+   enum class advice { normal, sequential, random, willneed };
+
+   //
+   // Construct
+   //
+
+   // the temporary file is made by the first reserve() or push_back()
+   mapped_vector() :
+      fd(-1), base(nullptr), numBytes(0), data(nullptr),
+      numCapacity(0), numElements(0), hint(advice::normal) {}
+   explicit mapped_vector(const std::string & path) : mapped_vector()
+   {
+      open(path);
+   }
+   mapped_vector(const std::initializer_list<T> & l) : mapped_vector()
+   {
+      reserve(l.size());
+      for (const T & t : l)
+         push_back(t);
+   }
+   mapped_vector(const mapped_vector & rhs) : mapped_vector()
+   {
+      *this = rhs;
+   }
+   mapped_vector(mapped_vector && rhs) : mapped_vector()
+   {
+      swap(rhs);
+   }
+   ~mapped_vector()
+   {
+      close();
+   }
+
+   //
+   // Assign
+   //
+
+   // the elements, not the file
+   mapped_vector & operator = (const mapped_vector & rhs)
+   {
+      if (this != &rhs)
+      {
+         clear();
+         reserve(rhs.numElements);
+         if (rhs.numElements)
+            std::memcpy((void *)data, (const void *)rhs.data, rhs.numElements * sizeof(T));
+         numElements = rhs.numElements;
+      }
+      return *this;
+   }
+   mapped_vector & operator = (mapped_vector && rhs)
+   {
+      if (this != &rhs)
+      {
+         close();
+         swap(rhs);
+      }
+      return *this;
+   }
+   void swap(mapped_vector & rhs)
+   {
+      std::swap(fd,          rhs.fd);
+      std::swap(base,        rhs.base);
+      std::swap(numBytes,    rhs.numBytes);
+      std::swap(data,        rhs.data);
+      std::swap(numCapacity, rhs.numCapacity);
+      std::swap(numElements, rhs.numElements);
+      std::swap(hint,        rhs.hint);
+   }
+
+   //
+   // Iterator
+   //
+
+   iterator       begin()        { return iterator(data);                     }
+   iterator       end()          { return iterator(data + numElements);       }
+   const_iterator begin()  const { return const_iterator(data);               }
+   const_iterator end()    const { return const_iterator(data + numElements); }
+   const_iterator cbegin() const { return begin();                            }
+   const_iterator cend()   const { return end();                              }
+
+   //
+   // Access
+   //
+
+         T & operator [] (size_t index)       { return data[index];           }
+   const T & operator [] (size_t index) const { return data[index];           }
+         T & front()                          { return data[0];               }
+   const T & front()                    const { return data[0];               }
+         T & back()                           { return data[numElements - 1]; }
+   const T & back()                     const { return data[numElements - 1]; }
+
+   //
+   // Insert
+   //
+
+   void push_back(const T & t) { emplace_back(t); }
+
+   template <class ... Args>
+   T & emplace_back(Args&& ... args)
+   {
+      if (numElements == numCapacity)
+      {
+         // the args may be one of our elements: build it before remapping
+         T t(std::forward<Args>(args)...);
+         reserve(std::max<size_t>(numCapacity * 2, 1));
+         ::new ((void *)(data + numElements)) T(t);
+      }
+      else
+         ::new ((void *)(data + numElements)) T(std::forward<Args>(args)...);
+      return data[numElements++];
+   }
+
+   void reserve(size_t newCapacity)
+   {
+      if (newCapacity > numCapacity)
+         remap(pageSize() + newCapacity * sizeof(T));
+   }
+
+   void resize(size_t newElements)
+   {
+      reserve(newElements);
+      for (; numElements < newElements; numElements++)
+         ::new ((void *)(data + numElements)) T();
+      numElements = newElements;
+   }
+
+   //
+   // Remove
+   //
+
+   // trivially copyable means trivially destructible: nothing to destroy
+   void pop_back() { if (numElements) numElements--; }
+   void clear()    { numElements = 0;                }
+
+   // give the file back all but the pages the elements need
+   void shrink_to_fit()
+   {
+      if (base)
+         remap(pageSize() + std::max<size_t>(numElements, 1) * sizeof(T));
+   }
+
+   //
+   // Status
+   //
+
+   size_t size()     const { return numElements;      }
+   size_t capacity() const { return numCapacity;      }
+   bool   empty()    const { return numElements == 0; }
+
+   //
+   // File
+   //
+
+   // tell the kernel how we are about to read, so it can read ahead or not
+   void advise(advice a)
+   {
+      hint = a;
+      applyAdvice();
+   }
+
+   // write the elements and the count to the disk and wait for it
+   void sync()
+   {
+      if (!base)
+         return;
+      writeHeader();
+      if (msync(base, numBytes, MS_SYNC) != 0)
+         throw std::system_error(errno, std::generic_category(), "mapped_vector: msync");
+   }
+
+#ifdef DEBUG // make this visible to the unit tests
+public:
+#else
+private:
+#endif
+
+   static size_t pageSize()
+   {
+      static size_t size = (size_t)sysconf(_SC_PAGESIZE);
+      return size;
+   }
+
+   static size_t roundToPage(size_t bytes)
+   {
+      return (bytes + pageSize() - 1) / pageSize() * pageSize();
+   }
+
+   // a nameless file in $TMPDIR, gone as soon as we close it
+   static int openTemporary()
+   {
+      const char * dir = std::getenv("TMPDIR");
+      std::string path = std::string(dir && *dir ? dir : "/tmp") + "/mapped_vector.XXXXXX";
+      int fd = mkstemp(&path[0]);
+      if (fd < 0)
+         throw std::system_error(errno, std::generic_category(), "mapped_vector: mkstemp");
+      unlink(path.c_str());
+      return fd;
+   }
+
+   // open and map the file: a new file gets its header, an old one
+   // gives its elements back
+   void open(const std::string & path)
+   {
+      fd = ::open(path.c_str(), O_RDWR | O_CREAT, 0644);
+      if (fd < 0)
+         throw std::system_error(errno, std::generic_category(), "mapped_vector: open " + path);
+
+      try
+      {
+         struct stat st;
+         if (fstat(fd, &st) != 0)
+            throw std::system_error(errno, std::generic_category(), "mapped_vector: fstat");
+         size_t bytesFile = (size_t)st.st_size;
+         remap(bytesFile > pageSize() ? bytesFile : pageSize() + pageSize());
+         header * h = (header *)base;
+         if (bytesFile == 0)
+            writeHeader();
+         else if (h->magic != magicNumber || h->sizeOfT != sizeof(T) ||
+                  h->numElements > numCapacity)
+            throw std::runtime_error("mapped_vector: the file does not hold this type");
+         else
+            numElements = (size_t)h->numElements;
+      }
+      catch (...)
+      {
+         close();
+         throw;
+      }
+   }
+
+   // make the file bytes long, rounded up to a page, and map all of it
+   void remap(size_t bytes)
+   {
+      if (fd < 0)
+         fd = openTemporary();
+      bytes = roundToPage(bytes);
+      if (ftruncate(fd, (off_t)bytes) != 0)
+         throw std::system_error(errno, std::generic_category(), "mapped_vector: ftruncate");
+
+      // the old mapping stays until the new one is made, so a failure
+      // leaves the vector as it was
+      void * p = MAP_FAILED;
+      bool remapped = false;
+#ifdef CUSTOM_HAS_MREMAP
+      if (base)
+      {
+         p = mremap(base, numBytes, bytes, MREMAP_MAYMOVE);
+         remapped = true;
+      }
+#endif
+      if (!remapped)
+         p = mmap(nullptr, bytes, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+      if (p == MAP_FAILED)
+      {
+         int error = errno;
+         if (base && ftruncate(fd, (off_t)numBytes) != 0)
+         {
+            // the old mapping is past the end of the file now: drop it
+            munmap(base, numBytes);
+            base = nullptr;
+            data = nullptr;
+            numBytes = numCapacity = numElements = 0;
+         }
+         throw std::system_error(error, std::generic_category(), "mapped_vector: mmap");
+      }
+      if (base && !remapped)
+         munmap(base, numBytes);
+
+      base = (char *)p;
+      numBytes = bytes;
+      data = (T *)(base + pageSize());
+      numCapacity = (numBytes - pageSize()) / sizeof(T);
+      if (numElements > numCapacity)
+         numElements = numCapacity;
+      applyAdvice();
+   }
+
+   void applyAdvice()
+   {
+      if (!base)
+         return;
+      int flag = hint == advice::sequential ? MADV_SEQUENTIAL :
+                 hint == advice::random     ? MADV_RANDOM     :
+                 hint == advice::willneed   ? MADV_WILLNEED   : MADV_NORMAL;
+      madvise(base, numBytes, flag);
+   }
+
+   void writeHeader()
+   {
+      header * h = (header *)base;
+      h->magic = magicNumber;
+      h->sizeOfT = sizeof(T);
+      h->numElements = numElements;
+   }
+
+   // save the count, unmap, and close; the data is in the page cache
+   void close()
+   {
+      if (base)
+      {
+         writeHeader();
+         munmap(base, numBytes);
+      }
+      if (fd >= 0)
+         ::close(fd);
+      fd = -1;
+      base = nullptr;
+      data = nullptr;
+      numBytes = numCapacity = numElements = 0;
+   }
+
+   int    fd;
+   char * base;          // the header page, then the elements
+   size_t numBytes;      // of the mapping and the file
+   T *    data;
+   size_t numCapacity;
+   size_t numElements;
+   advice hint;
+};
+
+} // namespace custom
+
+#endif // CUSTOM_HAS_MMAP
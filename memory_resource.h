@@ -0,0 +1,310 @@
+/***********************************************************************
+ * Header:
+ *    MEMORY RESOURCE
+ * Summary:
+ *    Two std::pmr::memory_resource classes for the many short-lived
+ *    vectors and priority queues built while handling one request.
+ *    Give a container a std::pmr::polymorphic_allocator pointing at
+ *    one of these (custom::pmr::vector and custom::pmr::priority_queue
+ *    do exactly that) and reserve() never touches the global heap.
+ *
+ *    arena_resource is a bump allocator: allocating is an add and a
+ *    compare, freeing does nothing, and reset() throws away
+ *    everything at once at the end of the request while keeping the
+ *    memory for the next one.
+ *
+ *    pool_resource keeps a free list for each power-of-two size from
+ *    8 to 4096 bytes so a freed buffer is handed straight to the next
+ *    request of the same size. It takes no locks: each thread uses its
+ *    own, from thread_local_pool(), and memory must be freed on the
+ *    thread that allocated it.
+ *
+ *    This will contain the class definition of:
+ *        pmr::arena_resource     : Monotonic bump allocator with reset()
+ *        pmr::pool_resource      : Unsynchronized size-class free lists
+ *        pmr::thread_local_pool  : This thread's pool_resource
+ * Author
+ *    Stephen Costigan, Alexander Dohms, Jonathan Colwell, Shaun Crook
+ ************************************************************************/
+
+#pragma once
+
+#include <cassert>
+#include <cstddef>          // for std::max_align_t
+#include <memory>           // for std::align
+#include <memory_resource>  // for std::pmr::memory_resource
+
+namespace custom
+{
+namespace pmr
+{
+
+/*****************************************
+ * ARENA RESOURCE
+ * Hand out memory by bumping a pointer through a chunk.
+ * When the chunk runs out, get one twice as big from upstream.
+ * Not thread-safe: one arena per request.
+ ****************************************/
+class arena_resource : public std::pmr::memory_resource
+{
+public:
+   explicit arena_resource(size_t initialSize = 4096,
+                           std::pmr::memory_resource * upstream = std::pmr::get_default_resource()) :
+      upstream(upstream), chunks(nullptr), buffer(nullptr), bufferSize(0),
+      next(nullptr), last(nullptr), nextSize(initialSize ? initialSize : 64),
+      numAllocated(0), numReserved(0)
+   {
+   }
+
+   // start in memory the caller owns, often on the stack
+   arena_resource(void * buffer, size_t size,
+                  std::pmr::memory_resource * upstream = std::pmr::get_default_resource()) :
+      upstream(upstream), chunks(nullptr), buffer((char *)buffer), bufferSize(size),
+      next((char *)buffer), last((char *)buffer + size), nextSize(size ? size * 2 : 64),
+      numAllocated(0), numReserved(0)
+   {
+   }
+
+   arena_resource(const arena_resource &) = delete;
+   arena_resource & operator = (const arena_resource &) = delete;
+   ~arena_resource() { release(); }
+
+   //
+   // Free
+   //
+
+   // forget every allocation but keep the biggest chunk for next time
+   void reset()
+   {
+      if (chunks)
+      {
+         freeChunks(chunks->next);
+         chunks->next = nullptr;
+         next = (char *)(chunks + 1);
+         last = (char *)chunks + chunks->size;
+         numReserved = chunks->size;
+      }
+      else
+      {
+         next = buffer;
+         last = buffer + bufferSize;
+      }
+      numAllocated = 0;
+   }
+
+   // forget every allocation and give every chunk back to upstream
+   void release()
+   {
+      freeChunks(chunks);
+      chunks = nullptr;
+      numReserved = 0;
+      reset();
+   }
+
+   //
+   // Status
+   //
+
+   size_t bytes_allocated() const { return numAllocated; }   // handed out since reset()
+   size_t bytes_reserved()  const { return numReserved;  }   // held from upstream
+   std::pmr::memory_resource * upstream_resource() const { return upstream; }
+
+protected:
+   void * do_allocate(size_t bytes, size_t alignment) override
+   {
+      void * p = next;
+      size_t space = last - next;
+      if (!std::align(alignment, bytes, p, space))
+      {
+         grow(bytes + alignment);
+         p = next;
+         space = last - next;
+         p = std::align(alignment, bytes, p, space);
+         assert(p);
+      }
+      next = (char *)p + bytes;
+      numAllocated += bytes;
+      return p;
+   }
+
+   // the memory comes back all at once in reset()
+   void do_deallocate(void *, size_t, size_t) override {}
+
+   bool do_is_equal(const std::pmr::memory_resource & rhs) const noexcept override
+   {
+      return this == &rhs;
+   }
+
+private:
+   // every chunk starts with one of these
+   struct chunk
+   {
+      chunk * next;
+      size_t  size;       // including this header
+   };
+
+   // get a new chunk with room for at least bytes
+   void grow(size_t bytes)
+   {
+      size_t size = nextSize;
+      while (size < bytes + sizeof(chunk))
+         size *= 2;
+
+      chunk * c = (chunk *)upstream->allocate(size, alignof(std::max_align_t));
+      c->next = chunks;
+      c->size = size;
+      chunks = c;
+
+      next = (char *)(c + 1);
+      last = (char *)c + size;
+      nextSize = size * 2;
+      numReserved += size;
+   }
+
+   void freeChunks(chunk * c)
+   {
+      while (c)
+      {
+         chunk * cNext = c->next;
+         upstream->deallocate(c, c->size, alignof(std::max_align_t));
+         c = cNext;
+      }
+   }
+
+   std::pmr::memory_resource * upstream;
+   chunk * chunks;            // newest (biggest) first
+   char *  buffer;            // the caller's buffer, if any
+   size_t  bufferSize;
+   char *  next;              // the next free byte
+   char *  last;              // one past the end of the current chunk
+   size_t  nextSize;          // how big the next chunk will be
+   size_t  numAllocated;
+   size_t  numReserved;
+};
+
+/*****************************************
+ * POOL RESOURCE
+ * A free list for every power-of-two size class. Anything
+ * bigger than the largest class, or more aligned than
+ * max_align_t, goes straight to upstream.
+ * Not thread-safe: use thread_local_pool().
+ ****************************************/
+class pool_resource : public std::pmr::memory_resource
+{
+public:
+   static const size_t minBlock   = 8;
+   static const size_t maxBlock   = 4096;
+   static const size_t numClasses = 10;      // 8, 16, ... 4096
+   static const size_t chunkSize  = 64 * 1024;
+
+   explicit pool_resource(std::pmr::memory_resource * upstream = std::pmr::new_delete_resource()) :
+      upstream(upstream), chunks(nullptr), numReserved(0)
+   {
+      for (size_t i = 0; i < numClasses; i++)
+         freeList[i] = nullptr;
+   }
+
+   pool_resource(const pool_resource &) = delete;
+   pool_resource & operator = (const pool_resource &) = delete;
+   ~pool_resource() { release(); }
+
+   // give every chunk back to upstream, even ones still in use
+   void release()
+   {
+      while (chunks)
+      {
+         chunk * cNext = chunks->next;
+         upstream->deallocate(chunks, chunkSize, alignof(std::max_align_t));
+         chunks = cNext;
+      }
+      for (size_t i = 0; i < numClasses; i++)
+         freeList[i] = nullptr;
+      numReserved = 0;
+   }
+
+   size_t bytes_reserved() const { return numReserved; }   // held from upstream
+   std::pmr::memory_resource * upstream_resource() const { return upstream; }
+
+   // which free list serves this request, or numClasses for none
+   static size_t classOf(size_t bytes, size_t alignment)
+   {
+      if (bytes > maxBlock || alignment > alignof(std::max_align_t))
+         return numClasses;
+      size_t index = 0;
+      for (size_t size = minBlock; size < bytes || size < alignment; size *= 2)
+         index++;
+      return index;
+   }
+   static size_t sizeOf(size_t index) { return minBlock << index; }
+
+protected:
+   void * do_allocate(size_t bytes, size_t alignment) override
+   {
+      size_t index = classOf(bytes, alignment);
+      if (index == numClasses)
+         return upstream->allocate(bytes, alignment);
+
+      if (freeList[index] == nullptr)
+         refill(index);
+      block * b = freeList[index];
+      freeList[index] = b->next;
+      return b;
+   }
+
+   void do_deallocate(void * p, size_t bytes, size_t alignment) override
+   {
+      size_t index = classOf(bytes, alignment);
+      if (index == numClasses)
+         return upstream->deallocate(p, bytes, alignment);
+
+      block * b = (block *)p;
+      b->next = freeList[index];
+      freeList[index] = b;
+   }
+
+   bool do_is_equal(const std::pmr::memory_resource & rhs) const noexcept override
+   {
+      return this == &rhs;
+   }
+
+private:
+   struct block { block * next; };
+   struct chunk { chunk * next; };
+
+   // carve a new chunk into blocks of one size class. The header
+   // takes one whole block so every block keeps the chunk's alignment.
+   void refill(size_t index)
+   {
+      size_t size = sizeOf(index);
+      chunk * c = (chunk *)upstream->allocate(chunkSize, alignof(std::max_align_t));
+      c->next = chunks;
+      chunks = c;
+      numReserved += chunkSize;
+
+      size_t first = size < sizeof(chunk) ? sizeof(chunk) : size;
+      for (size_t offset = chunkSize - size; offset >= first; offset -= size)
+      {
+         block * b = (block *)((char *)c + offset);
+         b->next = freeList[index];
+         freeList[index] = b;
+      }
+   }
+
+   std::pmr::memory_resource * upstream;
+   chunk * chunks;
+   block * freeList[numClasses];
+   size_t  numReserved;
+};
+
+/*****************************************
+ * THREAD LOCAL POOL
+ * Each thread's own pool_resource, freed when the thread ends
+ ****************************************/
+inline pool_resource * thread_local_pool()
+{
+   static thread_local pool_resource pool;
+   return &pool;
+}
+
+} // namespace pmr
+} // namespace custom
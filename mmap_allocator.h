@@ -0,0 +1,120 @@
+/***********************************************************************
+ * Header:
+ *    MMAP ALLOCATOR
+ * Summary:
+ *    An allocator for very large vectors. Small buffers come from
+ *    std::allocator as usual; anything from one megabyte up is mapped
+ *    straight from the operating system with mmap().
+ *
+ *    The point is reallocate(): on Linux a mapped buffer is grown with
+ *    mremap(), which moves page table entries instead of copying
+ *    bytes, so doubling a 4GB vector of trivially relocatable elements
+ *    costs about as much as doubling a 4MB one. custom::vector finds
+ *    reallocate() by itself:
+ *
+ *       custom::vector<int, custom::mmap_allocator<int>> v;
+ *
+ *    Where there is no mmap() (Windows) everything comes from
+ *    std::allocator; where there is no mremap() (macOS) reallocate()
+ *    says no and the vector copies.
+ *
+ *    This will contain the class definition of:
+ *        mmap_allocator         : std::allocator, with mmap() for big buffers
+ * Author
+ *    Stephen Costigan, Alexander Dohms, Jonathan Colwell, Shaun Crook
+ ************************************************************************/
+
+#pragma once
+
+#include <cstddef>     // for size_t
+#include <memory>      // for std::allocator
+#include <new>         // for std::bad_alloc
+#include <type_traits> // for std::true_type
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <sys/mman.h>  // for mmap, munmap, mremap
+#define CUSTOM_HAS_MMAP
+#if defined(__linux__) && defined(MREMAP_MAYMOVE)
+#define CUSTOM_HAS_MREMAP
+#endif
+#endif
+
+namespace custom
+{
+
+/*****************************************
+ * MMAP ALLOCATOR
+ * Stateless, so any two are equal and a vector can
+ * always hand its buffer to another vector
+ ****************************************/
+template <class T>
+class mmap_allocator
+{
+public:
+   typedef T value_type;
+   typedef std::true_type is_always_equal;
+
+   // buffers of at least this many bytes are mapped
+   static const size_t threshold = 1 << 20;
+
+   mmap_allocator() {}
+   template <class U>
+   mmap_allocator(const mmap_allocator<U> &) {}
+
+   T * allocate(size_t num)
+   {
+#ifdef CUSTOM_HAS_MMAP
+      if (isMapped(num))
+      {
+         void * p = mmap(nullptr, num * sizeof(T), PROT_READ | PROT_WRITE,
+                         MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+         if (p == MAP_FAILED)
+            throw std::bad_alloc();
+         return (T *)p;
+      }
+#endif
+      return std::allocator<T>().allocate(num);
+   }
+
+   void deallocate(T * p, size_t num)
+   {
+#ifdef CUSTOM_HAS_MMAP
+      if (isMapped(num))
+      {
+         munmap((void *)p, num * sizeof(T));
+         return;
+      }
+#endif
+      std::allocator<T>().deallocate(p, num);
+   }
+
+   // grow or shrink a buffer from allocate(), keeping its bytes. Returns
+   // nullptr, and leaves p alone, if that cannot be done without a copy.
+   T * reallocate(T * p, size_t oldNum, size_t newNum)
+   {
+#ifdef CUSTOM_HAS_MREMAP
+      if (isMapped(oldNum) && isMapped(newNum))
+      {
+         void * pNew = mremap((void *)p, oldNum * sizeof(T), newNum * sizeof(T), MREMAP_MAYMOVE);
+         return pNew == MAP_FAILED ? nullptr : (T *)pNew;
+      }
+#endif
+      return nullptr;
+   }
+
+   static bool isMapped(size_t num)
+   {
+#ifdef CUSTOM_HAS_MMAP
+      return num * sizeof(T) >= threshold;
+#else
+      return false;
+#endif
+   }
+};
+
+template <class T, class U>
+bool operator == (const mmap_allocator<T> &, const mmap_allocator<U> &) { return true; }
+template <class T, class U>
+bool operator != (const mmap_allocator<T> &, const mmap_allocator<U> &) { return false; }
+
+} // namespace custom
@@ -0,0 +1,185 @@
+/***********************************************************************
+ * Header:
+ *    PERF COUNTERS
+ * Summary:
+ *    The hardware performance counters of this process, through the
+ *    Linux perf_event_open() system call. The benchmarks turn them on
+ *    with --counters to say why something is slow, not just that it
+ *    is: per operation, how many
+ *
+ *       cycles         : CPU cycles
+ *       instructions   : instructions retired
+ *       l1d_misses     : L1 data cache read misses
+ *       llc_misses     : last level cache misses
+ *       dtlb_misses    : data TLB read misses
+ *       branch_misses  : mispredicted branches
+ *
+ *    Each counter is opened on its own, so a CPU or a kernel that has
+ *    some of them and not others still gives the rest. Where there are
+ *    none at all (not Linux, a container that blocks the call, a VM
+ *    with no PMU, perf_event_paranoid too high) every counter is
+ *    simply unavailable and read() says so; nothing fails.
+ *
+ *    Only user-space work is counted, for this thread and the threads
+ *    it starts after the counters are opened. When the kernel has more
+ *    counters open than the PMU can hold it takes turns, and read()
+ *    scales the count up by the share of the time it was running.
+ *
+ *    This will contain the class definition of:
+ *        PerfCounters       : A set of hardware counters
+ * Author
+ *    Stephen Costigan, Alexander Dohms, Jonathan Colwell, Shaun Crook
+ ************************************************************************/
+
+#pragma once
+
+#include <cstring>   // for std::memset
+
+#ifdef __linux__
+#include <linux/perf_event.h>  // for perf_event_attr
+#include <sys/ioctl.h>         // for ioctl
+#include <sys/syscall.h>       // for SYS_perf_event_open
+#include <unistd.h>            // for syscall, read, close
+#endif
+
+/*************************************************************
+ * PERF COUNTERS
+ * Open every counter we can; start() and stop() around the
+ * code of interest, then read() each one.
+ *************************************************************/
+class PerfCounters
+{
+public:
+   enum Event { CYCLES, INSTRUCTIONS, L1D_MISSES, LLC_MISSES, DTLB_MISSES, BRANCH_MISSES,
+                NUM_EVENTS };
+
+   static const char * name(Event event)
+   {
+      static const char * names[NUM_EVENTS] =
+      {
+         "cycles", "instructions", "l1d_misses", "llc_misses", "dtlb_misses", "branch_misses"
+      };
+      return names[event];
+   }
+
+   PerfCounters()
+   {
+      for (int e = 0; e < NUM_EVENTS; e++)
+         fds[e] = open(Event(e));
+   }
+   ~PerfCounters()
+   {
+#ifdef __linux__
+      for (int e = 0; e < NUM_EVENTS; e++)
+         if (fds[e] >= 0)
+            close(fds[e]);
+#endif
+   }
+   PerfCounters(const PerfCounters &) = delete;
+   PerfCounters & operator = (const PerfCounters &) = delete;
+
+   bool available(Event event) const { return fds[event] >= 0; }
+   bool any() const
+   {
+      for (int e = 0; e < NUM_EVENTS; e++)
+         if (available(Event(e)))
+            return true;
+      return false;
+   }
+
+   // zero the counters and start counting
+   void start()
+   {
+#ifdef __linux__
+      for (int e = 0; e < NUM_EVENTS; e++)
+         if (fds[e] >= 0)
+         {
+            ioctl(fds[e], PERF_EVENT_IOC_RESET, 0);
+            ioctl(fds[e], PERF_EVENT_IOC_ENABLE, 0);
+         }
+#endif
+   }
+
+   // stop counting; the counts stay until the next start()
+   void stop()
+   {
+#ifdef __linux__
+      for (int e = 0; e < NUM_EVENTS; e++)
+         if (fds[e] >= 0)
+            ioctl(fds[e], PERF_EVENT_IOC_DISABLE, 0);
+#endif
+   }
+
+   // the count between start() and stop(), or -1.0 if we have none
+   double read(Event event) const
+   {
+#ifdef __linux__
+      // value, time enabled, time running
+      unsigned long long values[3] = { 0, 0, 0 };
+      if (fds[event] < 0 || ::read(fds[event], values, sizeof(values)) != (ssize_t)sizeof(values))
+         return -1.0;
+      if (values[2] == 0)
+         return values[1] == 0 ? 0.0 : -1.0;
+      return (double)values[0] * ((double)values[1] / (double)values[2]);
+#else
+      (void)event;
+      return -1.0;
+#endif
+   }
+
+private:
+   int fds[NUM_EVENTS];   // -1 for a counter we could not open
+
+   // a file descriptor for one counter, disabled, or -1
+   static int open(Event event)
+   {
+#ifdef __linux__
+      perf_event_attr attr;
+      std::memset(&attr, 0, sizeof(attr));
+      attr.size           = sizeof(attr);
+      attr.disabled       = 1;
+      attr.inherit        = 1;
+      attr.exclude_kernel = 1;
+      attr.exclude_hv     = 1;
+      attr.read_format    = PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+
+      const unsigned long long readMiss = (PERF_COUNT_HW_CACHE_OP_READ << 8) |
+                                          (PERF_COUNT_HW_CACHE_RESULT_MISS << 16);
+      switch (event)
+      {
+         case CYCLES:
+            attr.type   = PERF_TYPE_HARDWARE;
+            attr.config = PERF_COUNT_HW_CPU_CYCLES;
+            break;
+         case INSTRUCTIONS:
+            attr.type   = PERF_TYPE_HARDWARE;
+            attr.config = PERF_COUNT_HW_INSTRUCTIONS;
+            break;
+         case L1D_MISSES:
+            attr.type   = PERF_TYPE_HW_CACHE;
+            attr.config = PERF_COUNT_HW_CACHE_L1D | readMiss;
+            break;
+         case LLC_MISSES:
+            attr.type   = PERF_TYPE_HARDWARE;
+            attr.config = PERF_COUNT_HW_CACHE_MISSES;
+            break;
+         case DTLB_MISSES:
+            attr.type   = PERF_TYPE_HW_CACHE;
+            attr.config = PERF_COUNT_HW_CACHE_DTLB | readMiss;
+            break;
+         case BRANCH_MISSES:
+            attr.type   = PERF_TYPE_HARDWARE;
+            attr.config = PERF_COUNT_HW_BRANCH_MISSES;
+            break;
+         default:
+            return -1;
+      }
+
+      // this process, any CPU, no group, no flags
+      return (int)syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0);
+#else
+      (void)event;
+      return -1;
+#endif
+   }
+};
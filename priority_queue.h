@@ -12,6 +12,8 @@
  *
  *    This will contain the class definition of:
  *        priority_queue          : A class that represents a Priority Queue
+ *        small_priority_queue    : A priority_queue on a small_vector
+ *        cow_priority_queue      : A priority_queue whose copies share a buffer
  * Author
  *    Stephen Costigan, Alexander Dohms, Jonathan Colwell, Shaun Crook
  ************************************************************************/
@@ -19,18 +21,74 @@
 #pragma once
 
 #include <cassert>
+#include <algorithm>     // for std::min
+#include <memory>        // for std::uses_allocator
+#include <type_traits>   // for std::enable_if, std::conditional
 #include "vector.h"
+#include "small_vector.h" // for small_priority_queue
+#include "cow_vector.h"   // for cow_priority_queue
+#include "instrument.h"  // for default_instrument
+#include "execution.h"   // for execution::seq and execution::par
+#include "thread_pool.h" // for the parallel heapify
 
 namespace custom
 {
 
+    /*************************************************
+     * P QUEUE PARTS
+     * The container and the instrument of a priority_queue.
+     * An instrument policy where the container belongs,
+     * priority_queue<T, instrument::counting>, means the default
+     * container, custom::vector<T, std::allocator<T>, Instrument>,
+     * counting with the same policy as the heap. A different
+     * policy in the third place as well is an error.
+     *************************************************/
+
+    // the Instrument of a priority_queue that was not given one
+    struct instrument_not_given {};
+
+    template <class T, class Container, class Instrument,
+              bool = instrument::is_policy<Container>::value>
+    struct priority_queue_parts
+    {
+        typedef Container container_type;
+        typedef typename std::conditional<std::is_same<Instrument, instrument_not_given>::value,
+                                          default_instrument, Instrument>::type instrument_type;
+    };
+    template <class T, class Instrument, class Unused>
+    struct priority_queue_parts <T, Instrument, Unused, true>
+    {
+        static_assert(std::is_same<Unused, instrument_not_given>::value ||
+                      std::is_same<Unused, Instrument>::value,
+                      "priority_queue<T, Policy, Other>: two different instrument policies");
+
+        typedef custom::vector<T, std::allocator<T>, Instrument> container_type;
+        typedef Instrument                                       instrument_type;
+    };
+
     /*************************************************
      * P QUEUE
      * Create a priority queue.
+     * Like std::priority_queue, the heap lives in a Container,
+     * and that container's allocator is where the memory comes from.
+     * The Instrument policy counts compares and sift levels
+     * here, and moves and reallocations in the container.
      *************************************************/
-    template<class T>
-    class priority_queue
+    template<class T, class Container = custom::vector<T, std::allocator<T>, default_instrument>,
+             class Instrument = instrument_not_given>
+    class priority_queue : private priority_queue_parts<T, Container, Instrument>::instrument_type
     {
+        typedef typename priority_queue_parts<T, Container, Instrument>::instrument_type instrument_type;
+
+    public:
+        typedef typename priority_queue_parts<T, Container, Instrument>::container_type container_type;
+        typedef T         value_type;
+
+    private:
+        // the allocator-extended constructors only exist if the container takes one
+        template <class Alloc>
+        using if_allocator = typename std::enable_if<std::uses_allocator<container_type, Alloc>::value>::type;
+
     public:
 
         //
@@ -38,7 +96,7 @@ namespace custom
         //
         // Jon
         priority_queue() {container.resize(0); }
-        priority_queue(const priority_queue& rhs) { this->container = rhs.container;  }                                      // throw (const char*); Copy Constructor
+        priority_queue(const priority_queue& rhs) : container(rhs.container) {}                         // throw (const char*); Copy Constructor
         priority_queue(priority_queue&& rhs) 
         {
             container = std::move(rhs.container);
@@ -54,10 +112,47 @@ namespace custom
             for (auto element = first; element != last; ++element)
                 push(*element);
         }
-        explicit priority_queue(custom::vector<T>&& rhs) { container = rhs; }                 // Explicit Move Constructor
-        explicit priority_queue(custom::vector<T>& rhs) {this->container = rhs;}//container = std::move(rhs); }                             // Explicit Copy Constructor
+        explicit priority_queue(container_type&& rhs) : container(std::move(rhs)) { heapify(); } // Explicit Move Constructor
+        explicit priority_queue(container_type& rhs) {this->container = rhs; heapify(); }         // Explicit Copy Constructor
+        priority_queue(const execution::sequenced_policy&, container_type&& rhs)                  // Bulk, one thread
+            : container(std::move(rhs)) { heapify(); }
+        priority_queue(const execution::parallel_policy& policy, container_type&& rhs)            // Bulk, many threads
+            : container(std::move(rhs)) { heapify(policy); }
         ~priority_queue() { container.clear(); }                                                         // Deconstructor
 
+        //
+        // Assign -- as cheap or as deep as copying the container
+        //
+        priority_queue& operator = (const priority_queue& rhs)
+        {
+            container = rhs.container;
+            return *this;
+        }
+        priority_queue& operator = (priority_queue&& rhs)
+        {
+            container = std::move(rhs.container);
+            return *this;
+        }
+
+        //
+        // Constructors with an allocator for the container
+        //
+        template <class Alloc, class = if_allocator<Alloc>>
+        explicit priority_queue(const Alloc& a) : container(a) {}
+        template <class Alloc, class = if_allocator<Alloc>>
+        priority_queue(const priority_queue& rhs, const Alloc& a) : container(rhs.container, a) {}
+        template <class Alloc, class = if_allocator<Alloc>>
+        priority_queue(priority_queue&& rhs, const Alloc& a) : container(std::move(rhs.container), a) {}
+        template <class Alloc, class = if_allocator<Alloc>>
+        priority_queue(container_type&& rhs, const Alloc& a) : container(std::move(rhs), a) { heapify(); }
+        template <class Iterator, class Alloc, class = if_allocator<Alloc>>
+        priority_queue(Iterator first, Iterator last, const Alloc& a) : container(a)
+        {
+            container.reserve(last - first);
+            for (auto element = first; element != last; ++element)
+                push(*element);
+        }
+
         //
         // Access
         //
@@ -68,11 +163,22 @@ namespace custom
         //
         void  push(const T& t);
         void  push(T&& t);
+        template <class ... Args>
+        void  emplace(Args&& ... args);
 
         //
         // Remove -- Shaun
         //
         void  pop();
+        T     pop_top();
+        void  shrink_to_fit()                                  { container.shrink_to_fit(); }
+
+        //
+        // Rebuild -- restore heap order after the container was filled in bulk
+        //
+        void  rebuild()                                        { heapify();       }
+        void  rebuild(const execution::sequenced_policy&)      { heapify();       }
+        void  rebuild(const execution::parallel_policy& policy) { heapify(policy); }
         
         //
         // Status
@@ -86,6 +192,16 @@ namespace custom
             return (size() == size_t(0));//container.empty();
         }
 
+        //
+        // Instrument
+        //
+        instrument_stats stats() const;
+        void reset_stats()
+        {
+            instrument_type::resetStats();
+            instrument::resetStatsOf(container);
+        }
+
 #ifdef DEBUG // make this visible to the unit tests
     public:
 #else
@@ -93,8 +209,13 @@ namespace custom
 #endif
 
         bool percolateDown(size_t indexHeap);      // fix heap from index down. This is a heap index!
+        void heapify();                            // build the heap bottom-up on one thread
+        void heapify(const execution::parallel_policy& policy);
+        void heapifySubtree(size_t indexRoot);     // heapify only the nodes under indexRoot
+        bool isLess(size_t indexLHS, size_t indexRHS); // compare two container indices
+        void swapElements(size_t indexLHS, size_t indexRHS);
 
-        custom::vector<T> container;
+        container_type container;
 
     };
 
@@ -102,8 +223,8 @@ namespace custom
      * P QUEUE :: TOP
      * Get the maximum item from the heap: the top item.
      ***********************************************/
-    template <class T>
-    const T& priority_queue <T> ::top() const
+    template <class T, class Container, class Instrument>
+    const T& priority_queue <T, Container, Instrument> ::top() const
     {
         if (size() > 0)
             return container[0];
@@ -114,11 +235,11 @@ namespace custom
      * P QUEUE :: POP
      * Delete the top item from the heap.
      **********************************************/
-    template <class T>
-    void priority_queue <T> ::pop()
+    template <class T, class Container, class Instrument>
+    void priority_queue <T, Container, Instrument> ::pop()
     {
         if (container.size() != 0) {
-            std::swap(container.front(), container.back());
+            swapElements(0, container.size() - 1);
             container.pop_back();
             percolateDown(1);
         }
@@ -126,22 +247,55 @@ namespace custom
             return;
     }
 
+    /**********************************************
+     * P QUEUE :: POP TOP
+     * Delete the top item from the heap and return it.
+     * The item is moved out, never copied.
+     **********************************************/
+    template <class T, class Container, class Instrument>
+    T priority_queue <T, Container, Instrument> ::pop_top()
+    {
+        if (container.size() == 0)
+            throw "std:out_of_range";
+
+        swapElements(0, container.size() - 1);
+        T t(std::move(container.back()));
+        container.pop_back();
+        percolateDown(1);
+        return t;
+    }
+
     /*****************************************
      * P QUEUE :: PUSH
      * Add a new element to the heap, reallocating as necessary
      ****************************************/
-    template <class T>
-    void priority_queue <T> ::push(const T& t)
+    template <class T, class Container, class Instrument>
+    void priority_queue <T, Container, Instrument> ::push(const T& t)
     {
         container.push_back(t);
         size_t i = container.size() / 2;
         while (i && percolateDown(i))
             i /= 2;
     }
-    template <class T>
-    void priority_queue <T> ::push(T&& t)
+    template <class T, class Container, class Instrument>
+    void priority_queue <T, Container, Instrument> ::push(T&& t)
     {
-        container.push_back(t);
+        container.push_back(std::move(t));
+        size_t i = container.size() / 2;
+        while (i && percolateDown(i))
+            i /= 2;
+    }
+
+    /*****************************************
+     * P QUEUE :: EMPLACE
+     * Build a new element at the bottom of the heap
+     * from args, then let it rise to its place
+     ****************************************/
+    template <class T, class Container, class Instrument>
+    template <class ... Args>
+    void priority_queue <T, Container, Instrument> ::emplace(Args&& ... args)
+    {
+        container.emplace_back(std::forward<Args>(args)...);
         size_t i = container.size() / 2;
         while (i && percolateDown(i))
             i /= 2;
@@ -155,37 +309,176 @@ namespace custom
      * order. Take care of that little detail!
      * Return TRUE if anything changed.
      ************************************************/
-    template <class T>
-    bool priority_queue <T> ::percolateDown(size_t indexHeap)
+    template <class T, class Container, class Instrument>
+    bool priority_queue <T, Container, Instrument> ::percolateDown(size_t indexHeap)
     {
         auto indexLeft = ((indexHeap-1) * 2)+1;
         auto indexRight = indexLeft + 1;
         bool change = 0;
 
-        if (indexRight <= container.numElements - 1 &&      
-            container[indexRight] > container[indexLeft] &&
-            container[indexRight] > container[indexHeap-1])            
+        if (indexRight < container.size() &&
+            isLess(indexLeft, indexRight) &&
+            isLess(indexHeap-1, indexRight))
         {
-            std::swap(container[indexHeap-1], container[indexRight]);
+            swapElements(indexHeap-1, indexRight);
+            this->onSift();
             percolateDown(indexRight + 1);
             change = 1;
         }
-        else if(indexLeft <= container.numElements - 1 && 
-            container[indexLeft] > container[indexHeap-1])
+        else if(indexLeft < container.size() &&
+            isLess(indexHeap-1, indexLeft))
         {
-            std::swap(container[indexHeap-1], container[indexLeft]);
+            swapElements(indexHeap-1, indexLeft);
+            this->onSift();
             percolateDown(indexLeft + 1);
             change = 1;
         }
         return change;
     }
 
+    /************************************************
+     * P QUEUE :: HEAPIFY
+     * Turn an arbitrary container into a heap by
+     * percolating every parent down, last parent first.
+     * This is O(n), where n pushes would be O(n log n).
+     ************************************************/
+    template <class T, class Container, class Instrument>
+    void priority_queue <T, Container, Instrument> ::heapify()
+    {
+        for (size_t indexHeap = size() / 2; indexHeap >= 1; indexHeap--)
+            percolateDown(indexHeap);
+    }
+
+    /************************************************
+     * P QUEUE :: HEAPIFY PARALLEL
+     * The subtrees rooted on any one level of the heap share
+     * no nodes, so they can be heapified at the same time.
+     * Pick a level wide enough to keep every worker busy, hand
+     * each subtree on that level to the pool, and then finish
+     * the few levels above it on this thread.
+     ************************************************/
+    template <class T, class Container, class Instrument>
+    void priority_queue <T, Container, Instrument> ::heapify(const execution::parallel_policy& policy)
+    {
+        // below this many parents, starting threads costs more than it saves
+        const size_t minParallel = 1 << 14;
+
+        size_t numThreads = policy.concurrency();
+        size_t numParents = size() / 2;
+        if (numThreads < 2 || numParents < minParallel)
+        {
+            heapify();
+            return;
+        }
+
+        // about four subtrees per worker evens out the ragged last level
+        size_t levelFirst = 1;
+        while (levelFirst < numThreads * 4 && levelFirst * 2 <= numParents)
+            levelFirst *= 2;
+        size_t levelLast = std::min(levelFirst * 2 - 1, numParents);
+
+        // ask for a writable element once, here: a copy-on-write container
+        // clones a shared buffer now, rather than every worker at once
+        (void)container[0];
+
+        {
+            thread_pool pool(numThreads);
+            for (size_t indexRoot = levelFirst; indexRoot <= levelLast; indexRoot++)
+                pool.submit([this, indexRoot]() { heapifySubtree(indexRoot); });
+            pool.wait();
+        }
+
+        // the top of the heap is small: do it serially
+        for (size_t indexHeap = levelFirst - 1; indexHeap >= 1; indexHeap--)
+            percolateDown(indexHeap);
+    }
+
+    /************************************************
+     * P QUEUE :: HEAPIFY SUBTREE
+     * Heapify the subtree under indexRoot, deepest level first.
+     * On depth d the subtree owns heap indices
+     * [indexRoot * 2^d, indexRoot * 2^d + 2^d - 1].
+     ************************************************/
+    template <class T, class Container, class Instrument>
+    void priority_queue <T, Container, Instrument> ::heapifySubtree(size_t indexRoot)
+    {
+        size_t numParents = size() / 2;
+
+        // find the deepest level of this subtree that has a parent on it
+        size_t depth = 0;
+        while ((indexRoot << (depth + 1)) <= numParents)
+            depth++;
+
+        for (size_t d = depth + 1; d-- > 0; )
+        {
+            size_t first = indexRoot << d;
+            size_t last = std::min(first + (size_t(1) << d) - 1, numParents);
+            for (size_t indexHeap = last; indexHeap >= first; indexHeap--)
+                percolateDown(indexHeap);
+        }
+    }
+
+    /************************************************
+     * P QUEUE :: IS LESS
+     * Compare two elements by their container index.
+     * Only operator< is required of T.
+     ************************************************/
+    template <class T, class Container, class Instrument>
+    bool priority_queue <T, Container, Instrument> ::isLess(size_t indexLHS, size_t indexRHS)
+    {
+        // read through const so a copy-on-write container is not told we write
+        const container_type& c = container;
+        this->onCompare();
+        return c[indexLHS] < c[indexRHS];
+    }
+
+    /************************************************
+     * P QUEUE :: SWAP ELEMENTS
+     * Exchange two elements by their container index.
+     * std::swap is one move construct and two move assigns.
+     ************************************************/
+    template <class T, class Container, class Instrument>
+    void priority_queue <T, Container, Instrument> ::swapElements(size_t indexLHS, size_t indexRHS)
+    {
+        std::swap(container[indexLHS], container[indexRHS]);
+        this->onMove(3);
+    }
+
+    /************************************************
+     * P QUEUE :: STATS
+     * Compares and sift levels are counted by the heap;
+     * the container adds its own moves and reallocations.
+     ************************************************/
+    template <class T, class Container, class Instrument>
+    instrument_stats priority_queue <T, Container, Instrument> ::stats() const
+    {
+        instrument_stats mine = instrument_type::getStats();
+        instrument_stats theirs = instrument::statsOf(container);
+        mine.moves += theirs.moves;
+        mine.reallocations += theirs.reallocations;
+        return mine;
+    }
+
+    // a priority queue that does not allocate until it holds more than N items
+    template <class T, size_t N = 16, class Instrument = default_instrument>
+    using small_priority_queue = custom::priority_queue <T, small_vector<T, N>, Instrument>;
+
+    // a priority queue whose copies are O(1) snapshots
+    template <class T, class Instrument = default_instrument>
+    using cow_priority_queue = custom::priority_queue <T, cow_vector<T>, Instrument>;
+
+    namespace pmr
+    {
+        // a priority queue whose memory comes from a std::pmr::memory_resource
+        template <class T, class Instrument = default_instrument>
+        using priority_queue = custom::priority_queue <T, pmr::vector<T>, Instrument>;
+    }
 
 };
 
-template <class T>
-inline void swap(custom::priority_queue <T>& lhs,
-   custom::priority_queue <T>& rhs)
+template <class T, class Container, class Instrument>
+inline void swap(custom::priority_queue <T, Container, Instrument>& lhs,
+   custom::priority_queue <T, Container, Instrument>& rhs)
 {
    lhs.container.swap(rhs.container);
 }
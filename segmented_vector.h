@@ -0,0 +1,365 @@
+/***********************************************************************
+ * Header:
+ *    SEGMENTED VECTOR
+ * Summary:
+ *    A vector that never moves its elements. They live in chunks of
+ *    ChunkSize elements each, and a small directory of chunk pointers
+ *    finds them: element i is in chunk i / ChunkSize. When the last
+ *    chunk is full, push_back() adds one more chunk instead of copying
+ *    everything into a buffer twice the size. So:
+ *
+ *       - no push_back() relocates an element: the worst case is one
+ *         chunk allocation and a push_back() onto the directory,
+ *       - the peak memory is the elements plus one chunk, not the old
+ *         buffer plus a new one twice its size,
+ *       - a reference or pointer to an element stays good until that
+ *         element is removed.
+ *
+ *    The price is one more load and a shift in operator[]. Iterators
+ *    are random access, so it works with std::sort and as the container
+ *    of a priority queue:
+ *
+ *       custom::priority_queue<int, custom::segmented_vector<int>> pq;
+ *
+ *    Like std::deque, iterators (not references) are invalidated by
+ *    push_back(), since the directory may grow.
+ *
+ *    This will contain the class definition of:
+ *        segmented_vector       : A vector of fixed-size chunks
+ *        segmented_vector::iterator : A random-access iterator through it
+ * Author
+ *    Stephen Costigan, Alexander Dohms, Jonathan Colwell, Shaun Crook
+ ************************************************************************/
+
+#pragma once
+
+#include <cassert>
+#include <cstddef>          // for std::ptrdiff_t
+#include <initializer_list> // for std::initializer_list
+#include <iterator>         // for std::random_access_iterator_tag
+#include <memory>           // for std::allocator_traits
+#include <type_traits>      // for std::enable_if
+#include <utility>          // for std::forward
+#include "vector.h"         // for the directory
+
+namespace custom
+{
+
+/*****************************************
+ * SEGMENTED CHUNK SIZE
+ * About one 4KB page of elements, rounded down to a power
+ * of two, and never fewer than 16
+ ****************************************/
+template <typename T>
+struct segmented_chunk_size
+{
+   static constexpr size_t floorPow2(size_t n)
+   {
+      return n < 2 ? 1 : 2 * floorPow2(n / 2);
+   }
+   static constexpr size_t value = floorPow2(4096 / sizeof(T)) < 16 ? 16 : floorPow2(4096 / sizeof(T));
+};
+
+/*****************************************
+ * SEGMENTED VECTOR
+ * chunks[c] holds elements [c * ChunkSize, (c + 1) * ChunkSize).
+ * Every chunk is full except the ones past numElements.
+ ****************************************/
+template <typename T, size_t ChunkSize = segmented_chunk_size<T>::value,
+          typename A = std::allocator<T>>
+class segmented_vector
+{
+   static_assert(ChunkSize > 0 && (ChunkSize & (ChunkSize - 1)) == 0,
+                 "the chunk size must be a power of two");
+   typedef std::allocator_traits<A> traits;
+   typedef typename traits::template rebind_alloc<T *> directory_allocator;
+
+   static constexpr size_t log2(size_t n) { return n < 2 ? 0 : 1 + log2(n / 2); }
+   static constexpr size_t shift = log2(ChunkSize);
+   static constexpr size_t mask = ChunkSize - 1;
+
+public:
+   template <typename U> class basic_iterator;
+   typedef T                       value_type;
+   typedef A                       allocator_type;
+   typedef size_t                  size_type;
+   typedef basic_iterator<T>       iterator;
+   typedef basic_iterator<const T> const_iterator;
+
+   //
+   // Construct
+   //
+
+   segmented_vector() : segmented_vector(A()) {}
+   explicit segmented_vector(const A & a) :
+      chunks(directory_allocator(a)), numElements(0), alloc(a) {}
+   segmented_vector(size_t num, const T & t, const A & a = A()) : segmented_vector(a)
+   {
+      reserve(num);
+      for (size_t i = 0; i < num; i++)
+         push_back(t);
+   }
+   segmented_vector(const std::initializer_list<T> & l, const A & a = A()) : segmented_vector(a)
+   {
+      reserve(l.size());
+      for (const T & t : l)
+         push_back(t);
+   }
+   segmented_vector(const segmented_vector & rhs) :
+      segmented_vector(traits::select_on_container_copy_construction(rhs.alloc))
+   {
+      reserve(rhs.numElements);
+      for (size_t i = 0; i < rhs.numElements; i++)
+         push_back(rhs[i]);
+   }
+   segmented_vector(segmented_vector && rhs) :
+      chunks(std::move(rhs.chunks)), numElements(rhs.numElements), alloc(rhs.alloc)
+   {
+      rhs.numElements = 0;
+   }
+   ~segmented_vector()
+   {
+      clear();
+      freeChunks(0);
+   }
+
+   //
+   // Assign
+   //
+
+   segmented_vector & operator = (const segmented_vector & rhs)
+   {
+      if (this != &rhs)
+      {
+         clear();
+         reserve(rhs.numElements);
+         for (size_t i = 0; i < rhs.numElements; i++)
+            push_back(rhs[i]);
+      }
+      return *this;
+   }
+   segmented_vector & operator = (segmented_vector && rhs)
+   {
+      if (this != &rhs)
+      {
+         clear();
+         freeChunks(0);
+         swap(rhs);
+      }
+      return *this;
+   }
+   void swap(segmented_vector & rhs)
+   {
+      assert(alloc == rhs.alloc);
+      chunks.swap(rhs.chunks);
+      std::swap(numElements, rhs.numElements);
+   }
+
+   A get_allocator() const { return alloc; }
+
+   //
+   // Iterator
+   //
+
+   iterator       begin()        { return iterator(directory(), 0);                 }
+   iterator       end()          { return iterator(directory(), numElements);       }
+   const_iterator begin()  const { return const_iterator(directory(), 0);           }
+   const_iterator end()    const { return const_iterator(directory(), numElements); }
+   const_iterator cbegin() const { return begin();                                  }
+   const_iterator cend()   const { return end();                                    }
+
+   //
+   // Access
+   //
+
+         T & operator [] (size_t index)       { return chunks[index >> shift][index & mask]; }
+   const T & operator [] (size_t index) const { return chunks[index >> shift][index & mask]; }
+         T & front()                          { return (*this)[0];                           }
+   const T & front()                    const { return (*this)[0];                           }
+         T & back()                           { return (*this)[numElements - 1];             }
+   const T & back()                     const { return (*this)[numElements - 1];             }
+
+   //
+   // Insert
+   //
+
+   void push_back(const T & t) { emplace_back(t);            }
+   void push_back(T && t)      { emplace_back(std::move(t)); }
+
+   // nothing moves, so args may safely be one of our own elements
+   template <class ... Args>
+   T & emplace_back(Args&& ... args)
+   {
+      if (numElements == capacity())
+         addChunk();
+      T * p = &(*this)[numElements];
+      traits::construct(alloc, p, std::forward<Args>(args)...);
+      numElements++;
+      return *p;
+   }
+
+   void reserve(size_t newCapacity)
+   {
+      while (capacity() < newCapacity)
+         addChunk();
+   }
+
+   void resize(size_t newElements)
+   {
+      while (numElements > newElements)
+         pop_back();
+      reserve(newElements);
+      while (numElements < newElements)
+         emplace_back();
+   }
+
+   //
+   // Remove
+   //
+
+   // one spare chunk is kept so a push and pop at a chunk
+   // boundary do not allocate and free a chunk every time
+   void pop_back()
+   {
+      if (numElements == 0)
+         return;
+      traits::destroy(alloc, &(*this)[--numElements]);
+      if (capacity() >= numElements + 2 * ChunkSize)
+         freeChunks(chunks.size() - 1);
+   }
+
+   void clear()
+   {
+      while (numElements > 0)
+         traits::destroy(alloc, &(*this)[--numElements]);
+   }
+
+   // give back every chunk past the last element
+   void shrink_to_fit()
+   {
+      freeChunks((numElements + mask) >> shift);
+      chunks.shrink_to_fit();
+   }
+
+   //
+   // Status
+   //
+
+   size_t size()     const { return numElements;                }
+   size_t capacity() const { return chunks.size() * ChunkSize;  }
+   bool   empty()    const { return numElements == 0;           }
+   static constexpr size_t chunk_size() { return ChunkSize;     }
+
+#ifdef DEBUG // make this visible to the unit tests
+public:
+#else
+private:
+#endif
+
+   T * const * directory() const { return chunks.size() ? &chunks[0] : nullptr; }
+
+   // one more chunk at the end of the directory
+   void addChunk()
+   {
+      T * chunk = traits::allocate(alloc, ChunkSize);
+      try
+      {
+         chunks.push_back(chunk);
+      }
+      catch (...)
+      {
+         traits::deallocate(alloc, chunk, ChunkSize);
+         throw;
+      }
+   }
+
+   // free the chunks from numKeep on; they must hold no elements
+   void freeChunks(size_t numKeep)
+   {
+      while (chunks.size() > numKeep)
+      {
+         traits::deallocate(alloc, chunks.back(), ChunkSize);
+         chunks.pop_back();
+      }
+   }
+
+   custom::vector<T *, directory_allocator> chunks;
+   size_t numElements;
+   A      alloc;
+};
+
+/**************************************************
+ * SEGMENTED VECTOR ITERATOR
+ * A position in the vector: the directory and an index.
+ * U is T for the iterator and const T for the const_iterator.
+ *************************************************/
+template <typename T, size_t ChunkSize, typename A>
+template <typename U>
+class segmented_vector <T, ChunkSize, A> :: basic_iterator
+{
+public:
+   typedef std::random_access_iterator_tag  iterator_category;
+   typedef T                                value_type;
+   typedef std::ptrdiff_t                   difference_type;
+   typedef U *                              pointer;
+   typedef U &                              reference;
+
+   // constructors, destructors, and assignment operator
+   basic_iterator() : chunks(nullptr), index(0) {}
+   basic_iterator(T * const * chunks, size_t index) : chunks(chunks), index(index) {}
+
+   // an iterator converts to a const_iterator, not the other way
+   template <typename V, typename = typename std::enable_if<std::is_convertible<V *, U *>::value>::type>
+   basic_iterator(const basic_iterator<V> & rhs) : chunks(rhs.chunks), index(rhs.index) {}
+
+   // dereference operator
+   U & operator *  () const { return chunks[index >> shift][index & mask]; }
+   U * operator -> () const { return &**this;                              }
+   U & operator [] (difference_type offset) const { return *(*this + offset); }
+
+   // prefix and postfix increment and decrement
+   basic_iterator & operator ++ ()    { ++index; return *this;                     }
+   basic_iterator   operator ++ (int) { basic_iterator i(*this); ++index; return i; }
+   basic_iterator & operator -- ()    { --index; return *this;                     }
+   basic_iterator   operator -- (int) { basic_iterator i(*this); --index; return i; }
+
+   // jump
+   basic_iterator & operator += (difference_type offset)      { index += offset; return *this;                 }
+   basic_iterator & operator -= (difference_type offset)      { index -= offset; return *this;                 }
+   basic_iterator   operator +  (difference_type offset) const { return basic_iterator(chunks, index + offset); }
+   basic_iterator   operator -  (difference_type offset) const { return basic_iterator(chunks, index - offset); }
+   friend basic_iterator operator + (difference_type offset, const basic_iterator & it)
+   {
+      return it + offset;
+   }
+
+   // distance, comparisons: any mix of const and non-const
+   template <typename V>
+   difference_type operator - (const basic_iterator<V> & rhs) const
+   {
+      return (difference_type)index - (difference_type)rhs.index;
+   }
+   template <typename V>
+   bool operator == (const basic_iterator<V> & rhs) const { return index == rhs.index; }
+   template <typename V>
+   bool operator != (const basic_iterator<V> & rhs) const { return index != rhs.index; }
+   template <typename V>
+   bool operator <  (const basic_iterator<V> & rhs) const { return index <  rhs.index; }
+   template <typename V>
+   bool operator >  (const basic_iterator<V> & rhs) const { return index >  rhs.index; }
+   template <typename V>
+   bool operator <= (const basic_iterator<V> & rhs) const { return index <= rhs.index; }
+   template <typename V>
+   bool operator >= (const basic_iterator<V> & rhs) const { return index >= rhs.index; }
+
+#ifdef DEBUG // make this visible to the unit tests
+public:
+#else
+private:
+#endif
+   template <typename V> friend class basic_iterator;
+   T * const * chunks;
+   size_t      index;
+};
+
+} // namespace custom
@@ -0,0 +1,547 @@
+/***********************************************************************
+ * Header:
+ *    SIMD
+ * Summary:
+ *    Bulk algorithms over a custom::vector of int, uint64_t, float, or
+ *    double that work on 4 to 8 elements per instruction:
+ *
+ *       find, count, min, max, argmin, argmax, sum, fill
+ *
+ *    Each takes a vector or a [first, last) pair of pointers. The
+ *    instruction set is picked once, at run time, from what the CPU
+ *    has: AVX2, else SSE4.2, else plain loops. Any other element type,
+ *    and any CPU that is not x86, always gets the plain loops.
+ *
+ *       custom::vector<float> v = ...;
+ *       float total = custom::simd::sum(v);
+ *       auto  it    = custom::simd::argmax(v);
+ *
+ *    sum() of floating point adds in a different order than a plain
+ *    loop, so it may round differently. min() and max() of floating
+ *    point assume there is no NaN.
+ *
+ *    This will contain the definitions of:
+ *        simd::isa              : The instruction sets we can use
+ *        simd::level            : The instruction set in use
+ *        simd::find ... fill    : The algorithms
+ * Author
+ *    Stephen Costigan, Alexander Dohms, Jonathan Colwell, Shaun Crook
+ ************************************************************************/
+
+#pragma once
+
+#include <cassert>
+#include <algorithm>   // for std::min
+#include <cstddef>     // for ptrdiff_t
+#include <cstdint>     // for int32_t, uint64_t
+#include <type_traits> // for std::is_same
+#include "vector.h"
+
+#if (defined(__x86_64__) || defined(__i386__) || defined(_M_X64)) && \
+    (defined(__GNUC__) || defined(__clang__) || defined(_MSC_VER))
+#include <immintrin.h> // for the SSE and AVX intrinsics
+#ifdef _MSC_VER
+#include <intrin.h>    // for __cpuidex
+#endif
+#define CUSTOM_HAS_SIMD
+#endif
+
+namespace custom
+{
+namespace simd
+{
+
+/*****************************************
+ * ISA
+ * The instruction sets, from worst to best
+ ****************************************/
+enum class isa { scalar, sse42, avx2 };
+
+namespace detail
+{
+
+   /*****************************************
+    * DETECT
+    * The best instruction set this CPU and OS support
+    ****************************************/
+   inline isa detect()
+   {
+#if defined(CUSTOM_HAS_SIMD) && defined(_MSC_VER)
+      int info[4];
+      __cpuidex(info, 1, 0);
+      bool sse42 = (info[2] & (1 << 20)) != 0;
+      bool osAvx = (info[2] & (1 << 27)) && (info[2] & (1 << 28)) &&
+                   (_xgetbv(0) & 6) == 6;
+      __cpuidex(info, 7, 0);
+      bool avx2 = osAvx && (info[1] & (1 << 5));
+      return avx2 ? isa::avx2 : sse42 ? isa::sse42 : isa::scalar;
+#elif defined(CUSTOM_HAS_SIMD)
+      __builtin_cpu_init();
+      if (__builtin_cpu_supports("avx2"))
+         return isa::avx2;
+      if (__builtin_cpu_supports("sse4.2"))
+         return isa::sse42;
+      return isa::scalar;
+#else
+      return isa::scalar;
+#endif
+   }
+
+   inline isa & current()
+   {
+      static isa level = detect();
+      return level;
+   }
+
+   // the index of the lowest set bit of a non-zero mask
+   inline unsigned int lowestBit(unsigned int mask)
+   {
+#ifdef _MSC_VER
+      unsigned long index;
+      _BitScanForward(&index, mask);
+      return (unsigned int)index;
+#else
+      return (unsigned int)__builtin_ctz(mask);
+#endif
+   }
+
+   inline unsigned int countBits(unsigned int mask)
+   {
+#ifdef _MSC_VER
+      return (unsigned int)__popcnt(mask);
+#else
+      return (unsigned int)__builtin_popcount(mask);
+#endif
+   }
+
+   // the element types that have vector kernels
+   template <class T>
+   struct has_lanes : std::integral_constant<bool,
+      std::is_same<T, int32_t>::value || std::is_same<T, uint64_t>::value ||
+      std::is_same<T, float>::value   || std::is_same<T, double>::value> {};
+
+   /*****************************************
+    * SCALAR
+    * The plain loops: the fallback and the tails
+    ****************************************/
+   namespace scalar
+   {
+      template <class T>
+      const T * find(const T * first, const T * last, const T & value)
+      {
+         for (; first != last; ++first)
+            if (*first == value)
+               return first;
+         return last;
+      }
+
+      template <class T>
+      size_t count(const T * first, const T * last, const T & value)
+      {
+         size_t num = 0;
+         for (; first != last; ++first)
+            num += (*first == value);
+         return num;
+      }
+
+      template <class T>
+      T min(const T * first, const T * last)
+      {
+         T result = *first;
+         for (++first; first != last; ++first)
+            if (*first < result)
+               result = *first;
+         return result;
+      }
+
+      template <class T>
+      T max(const T * first, const T * last)
+      {
+         T result = *first;
+         for (++first; first != last; ++first)
+            if (result < *first)
+               result = *first;
+         return result;
+      }
+
+      template <class T>
+      T sum(const T * first, const T * last)
+      {
+         T result = T(0);
+         for (; first != last; ++first)
+            result += *first;
+         return result;
+      }
+
+      template <class T>
+      void fill(T * first, T * last, const T & value)
+      {
+         for (; first != last; ++first)
+            *first = value;
+      }
+   }
+
+#ifdef CUSTOM_HAS_SIMD
+
+#if defined(__clang__)
+#pragma clang attribute push(__attribute__((target("sse4.2"))), apply_to = function)
+#elif defined(__GNUC__)
+#pragma GCC push_options
+#pragma GCC target("sse4.2")
+#endif
+
+   /*****************************************
+    * SSE 4.2
+    * 128-bit registers: 4 int or float, 2 uint64_t or double
+    ****************************************/
+   namespace sse42
+   {
+      template <class T> struct lanes;
+
+      template <> struct lanes<int32_t>
+      {
+         typedef __m128i reg;
+         static const size_t width = 4;
+         static reg  load(const int32_t * p)  { return _mm_loadu_si128((const __m128i *)p);         }
+         static void store(int32_t * p, reg a) { _mm_storeu_si128((__m128i *)p, a);                 }
+         static reg  set1(int32_t t)          { return _mm_set1_epi32(t);                           }
+         static reg  add(reg a, reg b)        { return _mm_add_epi32(a, b);                         }
+         static reg  min(reg a, reg b)        { return _mm_min_epi32(a, b);                         }
+         static reg  max(reg a, reg b)        { return _mm_max_epi32(a, b);                         }
+         static unsigned int eq(reg a, reg b)
+         {
+            return (unsigned int)_mm_movemask_ps(_mm_castsi128_ps(_mm_cmpeq_epi32(a, b)));
+         }
+      };
+
+      // there is no unsigned 64-bit compare: flip the sign bits and compare signed
+      template <> struct lanes<uint64_t>
+      {
+         typedef __m128i reg;
+         static const size_t width = 2;
+         static reg  load(const uint64_t * p)  { return _mm_loadu_si128((const __m128i *)p);        }
+         static void store(uint64_t * p, reg a) { _mm_storeu_si128((__m128i *)p, a);                }
+         static reg  set1(uint64_t t)          { return _mm_set1_epi64x((long long)t);              }
+         static reg  add(reg a, reg b)         { return _mm_add_epi64(a, b);                        }
+         static reg  greater(reg a, reg b)
+         {
+            reg bias = _mm_set1_epi64x((long long)0x8000000000000000ull);
+            return _mm_cmpgt_epi64(_mm_xor_si128(a, bias), _mm_xor_si128(b, bias));
+         }
+         static reg  min(reg a, reg b)         { return _mm_blendv_epi8(a, b, greater(a, b));       }
+         static reg  max(reg a, reg b)         { return _mm_blendv_epi8(b, a, greater(a, b));       }
+         static unsigned int eq(reg a, reg b)
+         {
+            return (unsigned int)_mm_movemask_pd(_mm_castsi128_pd(_mm_cmpeq_epi64(a, b)));
+         }
+      };
+
+      template <> struct lanes<float>
+      {
+         typedef __m128 reg;
+         static const size_t width = 4;
+         static reg  load(const float * p)  { return _mm_loadu_ps(p);     }
+         static void store(float * p, reg a) { _mm_storeu_ps(p, a);       }
+         static reg  set1(float t)          { return _mm_set1_ps(t);      }
+         static reg  add(reg a, reg b)      { return _mm_add_ps(a, b);    }
+         static reg  min(reg a, reg b)      { return _mm_min_ps(a, b);    }
+         static reg  max(reg a, reg b)      { return _mm_max_ps(a, b);    }
+         static unsigned int eq(reg a, reg b)
+         {
+            return (unsigned int)_mm_movemask_ps(_mm_cmpeq_ps(a, b));
+         }
+      };
+
+      template <> struct lanes<double>
+      {
+         typedef __m128d reg;
+         static const size_t width = 2;
+         static reg  load(const double * p)  { return _mm_loadu_pd(p);     }
+         static void store(double * p, reg a) { _mm_storeu_pd(p, a);       }
+         static reg  set1(double t)          { return _mm_set1_pd(t);      }
+         static reg  add(reg a, reg b)       { return _mm_add_pd(a, b);    }
+         static reg  min(reg a, reg b)       { return _mm_min_pd(a, b);    }
+         static reg  max(reg a, reg b)       { return _mm_max_pd(a, b);    }
+         static unsigned int eq(reg a, reg b)
+         {
+            return (unsigned int)_mm_movemask_pd(_mm_cmpeq_pd(a, b));
+         }
+      };
+
+#include "simd_kernels.h"
+   }
+
+#if defined(__clang__)
+#pragma clang attribute pop
+#pragma clang attribute push(__attribute__((target("avx2"))), apply_to = function)
+#elif defined(__GNUC__)
+#pragma GCC pop_options
+#pragma GCC push_options
+#pragma GCC target("avx2")
+#endif
+
+   /*****************************************
+    * AVX2
+    * 256-bit registers: 8 int or float, 4 uint64_t or double
+    ****************************************/
+   namespace avx2
+   {
+      template <class T> struct lanes;
+
+      template <> struct lanes<int32_t>
+      {
+         typedef __m256i reg;
+         static const size_t width = 8;
+         static reg  load(const int32_t * p)  { return _mm256_loadu_si256((const __m256i *)p);      }
+         static void store(int32_t * p, reg a) { _mm256_storeu_si256((__m256i *)p, a);              }
+         static reg  set1(int32_t t)          { return _mm256_set1_epi32(t);                        }
+         static reg  add(reg a, reg b)        { return _mm256_add_epi32(a, b);                      }
+         static reg  min(reg a, reg b)        { return _mm256_min_epi32(a, b);                      }
+         static reg  max(reg a, reg b)        { return _mm256_max_epi32(a, b);                      }
+         static unsigned int eq(reg a, reg b)
+         {
+            return (unsigned int)_mm256_movemask_ps(_mm256_castsi256_ps(_mm256_cmpeq_epi32(a, b)));
+         }
+      };
+
+      template <> struct lanes<uint64_t>
+      {
+         typedef __m256i reg;
+         static const size_t width = 4;
+         static reg  load(const uint64_t * p)  { return _mm256_loadu_si256((const __m256i *)p);     }
+         static void store(uint64_t * p, reg a) { _mm256_storeu_si256((__m256i *)p, a);             }
+         static reg  set1(uint64_t t)          { return _mm256_set1_epi64x((long long)t);           }
+         static reg  add(reg a, reg b)         { return _mm256_add_epi64(a, b);                     }
+         static reg  greater(reg a, reg b)
+         {
+            reg bias = _mm256_set1_epi64x((long long)0x8000000000000000ull);
+            return _mm256_cmpgt_epi64(_mm256_xor_si256(a, bias), _mm256_xor_si256(b, bias));
+         }
+         static reg  min(reg a, reg b)         { return _mm256_blendv_epi8(a, b, greater(a, b));    }
+         static reg  max(reg a, reg b)         { return _mm256_blendv_epi8(b, a, greater(a, b));    }
+         static unsigned int eq(reg a, reg b)
+         {
+            return (unsigned int)_mm256_movemask_pd(_mm256_castsi256_pd(_mm256_cmpeq_epi64(a, b)));
+         }
+      };
+
+      template <> struct lanes<float>
+      {
+         typedef __m256 reg;
+         static const size_t width = 8;
+         static reg  load(const float * p)  { return _mm256_loadu_ps(p);     }
+         static void store(float * p, reg a) { _mm256_storeu_ps(p, a);       }
+         static reg  set1(float t)          { return _mm256_set1_ps(t);      }
+         static reg  add(reg a, reg b)      { return _mm256_add_ps(a, b);    }
+         static reg  min(reg a, reg b)      { return _mm256_min_ps(a, b);    }
+         static reg  max(reg a, reg b)      { return _mm256_max_ps(a, b);    }
+         static unsigned int eq(reg a, reg b)
+         {
+            return (unsigned int)_mm256_movemask_ps(_mm256_cmp_ps(a, b, _CMP_EQ_OQ));
+         }
+      };
+
+      template <> struct lanes<double>
+      {
+         typedef __m256d reg;
+         static const size_t width = 4;
+         static reg  load(const double * p)  { return _mm256_loadu_pd(p);     }
+         static void store(double * p, reg a) { _mm256_storeu_pd(p, a);       }
+         static reg  set1(double t)          { return _mm256_set1_pd(t);      }
+         static reg  add(reg a, reg b)       { return _mm256_add_pd(a, b);    }
+         static reg  min(reg a, reg b)       { return _mm256_min_pd(a, b);    }
+         static reg  max(reg a, reg b)       { return _mm256_max_pd(a, b);    }
+         static unsigned int eq(reg a, reg b)
+         {
+            return (unsigned int)_mm256_movemask_pd(_mm256_cmp_pd(a, b, _CMP_EQ_OQ));
+         }
+      };
+
+#include "simd_kernels.h"
+   }
+
+#if defined(__clang__)
+#pragma clang attribute pop
+#elif defined(__GNUC__)
+#pragma GCC pop_options
+#endif
+
+#endif // CUSTOM_HAS_SIMD
+
+} // namespace detail
+
+/*****************************************
+ * LEVEL
+ * The instruction set in use. It starts as the best one the
+ * CPU has; set_level() can lower it, for testing and for
+ * comparing, but cannot raise it past what the CPU has.
+ ****************************************/
+inline isa level()     { return detail::current(); }
+inline isa supported() { static isa best = detail::detect(); return best; }
+inline void set_level(isa l)
+{
+   detail::current() = (int)l < (int)supported() ? l : supported();
+}
+
+// the instruction set T actually gets
+template <class T>
+isa level_for()
+{
+   return detail::has_lanes<T>::value ? level() : isa::scalar;
+}
+
+/*****************************************
+ * DISPATCH
+ * Call the kernel of the instruction set in use
+ ****************************************/
+#ifdef CUSTOM_HAS_SIMD
+#define CUSTOM_SIMD_DISPATCH(T, call)                                      \
+   if constexpr (detail::has_lanes<T>::value)                             \
+   {                                                                      \
+      switch (level())                                                    \
+      {                                                                   \
+      case isa::avx2:  return detail::avx2::call;                         \
+      case isa::sse42: return detail::sse42::call;                        \
+      default:         break;                                             \
+      }                                                                   \
+   }                                                                      \
+   return detail::scalar::call
+#else
+#define CUSTOM_SIMD_DISPATCH(T, call) return detail::scalar::call
+#endif
+
+/*****************************************
+ * FIND and COUNT
+ * The first element equal to value, or last; how many are
+ ****************************************/
+template <class T>
+const T * find(const T * first, const T * last, const T & value)
+{
+   CUSTOM_SIMD_DISPATCH(T, find<T>(first, last, value));
+}
+
+template <class T>
+size_t count(const T * first, const T * last, const T & value)
+{
+   CUSTOM_SIMD_DISPATCH(T, count<T>(first, last, value));
+}
+
+/*****************************************
+ * MIN and MAX
+ * The smallest and largest of a non-empty range
+ ****************************************/
+template <class T>
+T min(const T * first, const T * last)
+{
+   assert(first != last);
+   CUSTOM_SIMD_DISPATCH(T, min<T>(first, last));
+}
+
+template <class T>
+T max(const T * first, const T * last)
+{
+   assert(first != last);
+   CUSTOM_SIMD_DISPATCH(T, max<T>(first, last));
+}
+
+/*****************************************
+ * ARGMIN and ARGMAX
+ * The first smallest and the first largest element:
+ * the min or max, then a find of it
+ ****************************************/
+template <class T>
+const T * argmin(const T * first, const T * last)
+{
+   return first == last ? last : find(first, last, min(first, last));
+}
+
+template <class T>
+const T * argmax(const T * first, const T * last)
+{
+   return first == last ? last : find(first, last, max(first, last));
+}
+
+/*****************************************
+ * SUM
+ * Everything added up, starting from zero
+ ****************************************/
+template <class T>
+T sum(const T * first, const T * last)
+{
+   CUSTOM_SIMD_DISPATCH(T, sum<T>(first, last));
+}
+
+/*****************************************
+ * FILL
+ * Assign value to every element
+ ****************************************/
+template <class T>
+void fill(T * first, T * last, const T & value)
+{
+   CUSTOM_SIMD_DISPATCH(T, fill<T>(first, last, value));
+}
+
+#undef CUSTOM_SIMD_DISPATCH
+
+/*****************************************
+ * VECTOR
+ * The same algorithms over a whole custom::vector
+ ****************************************/
+template <typename T, typename A, typename I, typename G>
+typename vector<T, A, I, G>::const_iterator find(const vector<T, A, I, G> & v, const T & value)
+{
+   const T * first = v.data();
+   return v.begin() + (find(first, first + v.size(), value) - first);
+}
+
+template <typename T, typename A, typename I, typename G>
+size_t count(const vector<T, A, I, G> & v, const T & value)
+{
+   const T * first = v.data();
+   return count(first, first + v.size(), value);
+}
+
+template <typename T, typename A, typename I, typename G>
+T min(const vector<T, A, I, G> & v)
+{
+   const T * first = v.data();
+   return min(first, first + v.size());
+}
+
+template <typename T, typename A, typename I, typename G>
+T max(const vector<T, A, I, G> & v)
+{
+   const T * first = v.data();
+   return max(first, first + v.size());
+}
+
+template <typename T, typename A, typename I, typename G>
+typename vector<T, A, I, G>::const_iterator argmin(const vector<T, A, I, G> & v)
+{
+   const T * first = v.data();
+   return v.begin() + (argmin(first, first + v.size()) - first);
+}
+
+template <typename T, typename A, typename I, typename G>
+typename vector<T, A, I, G>::const_iterator argmax(const vector<T, A, I, G> & v)
+{
+   const T * first = v.data();
+   return v.begin() + (argmax(first, first + v.size()) - first);
+}
+
+template <typename T, typename A, typename I, typename G>
+T sum(const vector<T, A, I, G> & v)
+{
+   const T * first = v.data();
+   return sum(first, first + v.size());
+}
+
+template <typename T, typename A, typename I, typename G>
+void fill(vector<T, A, I, G> & v, const T & value)
+{
+   T * first = v.data();
+   fill(first, first + v.size(), value);
+}
+
+} // namespace simd
+} // namespace custom
@@ -0,0 +1,104 @@
+/***********************************************************************
+ * Header:
+ *    SIMD KERNELS
+ * Summary:
+ *    The bulk algorithms of simd.h written once in terms of lanes<T>:
+ *    a register of lanes<T>::width elements and the handful of
+ *    operations each instruction set has for it.
+ *
+ *    This file has no #pragma once on purpose. simd.h includes it
+ *    inside each instruction set's namespace, after that namespace's
+ *    lanes<T>, with the compiler targeting that instruction set. Do
+ *    not include it anywhere else.
+ *
+ *    Every kernel finishes the elements that do not fill a register
+ *    with the scalar version.
+ * Author
+ *    Stephen Costigan, Alexander Dohms, Jonathan Colwell, Shaun Crook
+ ************************************************************************/
+
+template <class T>
+const T * find(const T * first, const T * last, T value)
+{
+   typedef lanes<T> L;
+   typename L::reg key = L::set1(value);
+   for (; last - first >= (ptrdiff_t)L::width; first += L::width)
+   {
+      unsigned int mask = L::eq(L::load(first), key);
+      if (mask)
+         return first + lowestBit(mask);
+   }
+   return scalar::find(first, last, value);
+}
+
+template <class T>
+size_t count(const T * first, const T * last, T value)
+{
+   typedef lanes<T> L;
+   typename L::reg key = L::set1(value);
+   size_t num = 0;
+   for (; last - first >= (ptrdiff_t)L::width; first += L::width)
+      num += countBits(L::eq(L::load(first), key));
+   return num + scalar::count(first, last, value);
+}
+
+template <class T>
+T min(const T * first, const T * last)
+{
+   typedef lanes<T> L;
+   if (last - first < (ptrdiff_t)L::width)
+      return scalar::min(first, last);
+
+   typename L::reg acc = L::load(first);
+   for (first += L::width; last - first >= (ptrdiff_t)L::width; first += L::width)
+      acc = L::min(acc, L::load(first));
+
+   T lane[L::width];
+   L::store(lane, acc);
+   T result = scalar::min(lane, lane + L::width);
+   if (first != last)
+      result = std::min(result, scalar::min(first, last));
+   return result;
+}
+
+template <class T>
+T max(const T * first, const T * last)
+{
+   typedef lanes<T> L;
+   if (last - first < (ptrdiff_t)L::width)
+      return scalar::max(first, last);
+
+   typename L::reg acc = L::load(first);
+   for (first += L::width; last - first >= (ptrdiff_t)L::width; first += L::width)
+      acc = L::max(acc, L::load(first));
+
+   T lane[L::width];
+   L::store(lane, acc);
+   T result = scalar::max(lane, lane + L::width);
+   if (first != last)
+      result = std::max(result, scalar::max(first, last));
+   return result;
+}
+
+template <class T>
+T sum(const T * first, const T * last)
+{
+   typedef lanes<T> L;
+   typename L::reg acc = L::set1(T(0));
+   for (; last - first >= (ptrdiff_t)L::width; first += L::width)
+      acc = L::add(acc, L::load(first));
+
+   T lane[L::width];
+   L::store(lane, acc);
+   return scalar::sum(lane, lane + L::width) + scalar::sum(first, last);
+}
+
+template <class T>
+void fill(T * first, T * last, T value)
+{
+   typedef lanes<T> L;
+   typename L::reg key = L::set1(value);
+   for (; last - first >= (ptrdiff_t)L::width; first += L::width)
+      L::store(first, key);
+   scalar::fill(first, last, value);
+}
@@ -0,0 +1,275 @@
+/***********************************************************************
+ * Header:
+ *    SMALL VECTOR
+ * Summary:
+ *    A vector that keeps its first N elements inside itself. Only the
+ *    N+1st push_back() goes to the allocator, so a small_vector that
+ *    never grows past N never allocates at all. Past N it is an
+ *    ordinary vector that doubles its heap buffer.
+ *
+ *    This is what the priority queue of a connection should sit on:
+ *    almost all of them stay under 16 items.
+ *
+ *       custom::small_priority_queue<Event, 16> pq;
+ *
+ *    This will contain the class definition of:
+ *        small_vector           : A vector with N elements of inline storage
+ * Author
+ *    Stephen Costigan, Alexander Dohms, Jonathan Colwell, Shaun Crook
+ ************************************************************************/
+
+#pragma once
+
+#include <cassert>
+#include <cstring>           // for std::memcpy
+#include <initializer_list>  // for std::initializer_list
+#include <memory>            // for std::allocator_traits
+#include <utility>           // for std::move_if_noexcept
+#include "vector.h"          // for is_trivially_relocatable
+
+namespace custom
+{
+
+/*****************************************
+ * SMALL VECTOR
+ * data points at inlineBuffer until the elements no longer
+ * fit; then it points at memory from the allocator.
+ ****************************************/
+template <typename T, size_t N, typename A = std::allocator<T>>
+class small_vector
+{
+   static_assert(N > 0, "a small_vector needs room for at least one element inline");
+   typedef std::allocator_traits<A> traits;
+
+public:
+   typedef T      value_type;
+   typedef A      allocator_type;
+   typedef size_t size_type;
+   typedef T *    iterator;
+   typedef const T * const_iterator;
+
+   //
+   // Construct
+   //
+
+   small_vector() : small_vector(A()) {}
+   explicit small_vector(const A & a) :
+      data(inlineData()), numCapacity(N), numElements(0), alloc(a) {}
+   small_vector(const std::initializer_list<T> & l, const A & a = A()) : small_vector(a)
+   {
+      reserve(l.size());
+      for (const T & t : l)
+         push_back(t);
+   }
+   small_vector(const small_vector & rhs) :
+      small_vector(traits::select_on_container_copy_construction(rhs.alloc))
+   {
+      reserve(rhs.numElements);
+      for (size_t i = 0; i < rhs.numElements; i++)
+         push_back(rhs.data[i]);
+   }
+   small_vector(small_vector && rhs) : small_vector(rhs.alloc)
+   {
+      moveFrom(rhs);
+   }
+   ~small_vector()
+   {
+      clear();
+      freeHeap();
+   }
+
+   //
+   // Assign
+   //
+
+   small_vector & operator = (const small_vector & rhs)
+   {
+      if (this != &rhs)
+      {
+         clear();
+         reserve(rhs.numElements);
+         for (size_t i = 0; i < rhs.numElements; i++)
+            push_back(rhs.data[i]);
+      }
+      return *this;
+   }
+   small_vector & operator = (small_vector && rhs)
+   {
+      if (this != &rhs)
+      {
+         clear();
+         moveFrom(rhs);
+      }
+      return *this;
+   }
+   void swap(small_vector & rhs)
+   {
+      small_vector temp(std::move(rhs));
+      rhs = std::move(*this);
+      *this = std::move(temp);
+   }
+
+   A get_allocator() const { return alloc; }
+
+   //
+   // Iterator
+   //
+
+   iterator       begin()       { return data;               }
+   iterator       end()         { return data + numElements; }
+   const_iterator begin() const { return data;               }
+   const_iterator end()   const { return data + numElements; }
+
+   //
+   // Access
+   //
+
+         T & operator [] (size_t index)       { return data[index];            }
+   const T & operator [] (size_t index) const { return data[index];            }
+         T & front()                          { return data[0];                }
+   const T & front()                    const { return data[0];                }
+         T & back()                           { return data[numElements - 1];  }
+   const T & back()                     const { return data[numElements - 1];  }
+
+   //
+   // Insert
+   //
+
+   void push_back(const T & t) { emplace_back(t);            }
+   void push_back(T && t)      { emplace_back(std::move(t)); }
+
+   template <class ... Args>
+   T & emplace_back(Args&& ... args)
+   {
+      if (numElements == numCapacity)
+      {
+         // the args may be one of our elements: build it before moving house
+         T t(std::forward<Args>(args)...);
+         reserve(numCapacity * 2);
+         traits::construct(alloc, data + numElements, std::move(t));
+      }
+      else
+         traits::construct(alloc, data + numElements, std::forward<Args>(args)...);
+      return data[numElements++];
+   }
+
+   void reserve(size_t newCapacity)
+   {
+      if (newCapacity > numCapacity)
+         reallocate(newCapacity);
+   }
+
+   void resize(size_t newElements)
+   {
+      while (numElements > newElements)
+         pop_back();
+      reserve(newElements);
+      for (; numElements < newElements; numElements++)
+         traits::construct(alloc, data + numElements);
+   }
+
+   //
+   // Remove
+   //
+
+   void pop_back()
+   {
+      if (numElements > 0)
+         traits::destroy(alloc, data + --numElements);
+   }
+   void clear()
+   {
+      while (numElements > 0)
+         traits::destroy(alloc, data + --numElements);
+   }
+
+   //
+   // Status
+   //
+
+   size_t size()      const { return numElements;           }
+   size_t capacity()  const { return numCapacity;           }
+   bool   empty()     const { return numElements == 0;      }
+   bool   is_inline() const { return data == inlineData();  }
+   static constexpr size_t inline_capacity() { return N;     }
+
+#ifdef DEBUG // make this visible to the unit tests
+public:
+#else
+private:
+#endif
+
+         T * inlineData()       { return reinterpret_cast<T *>(inlineBuffer);       }
+   const T * inlineData() const { return reinterpret_cast<const T *>(inlineBuffer); }
+
+   // move the elements to a heap buffer of newCapacity
+   void reallocate(size_t newCapacity)
+   {
+      T * dataNew = traits::allocate(alloc, newCapacity);
+      if (is_trivially_relocatable<T>::value)
+      {
+         if (numElements)
+            std::memcpy((void *)dataNew, (const void *)data, numElements * sizeof(T));
+      }
+      else
+      {
+         size_t i = 0;
+         try
+         {
+            for (; i < numElements; i++)
+               traits::construct(alloc, dataNew + i, std::move_if_noexcept(data[i]));
+         }
+         catch (...)
+         {
+            while (i > 0)
+               traits::destroy(alloc, dataNew + --i);
+            traits::deallocate(alloc, dataNew, newCapacity);
+            throw;
+         }
+         for (size_t j = 0; j < numElements; j++)
+            traits::destroy(alloc, data + j);
+      }
+      freeHeap();
+      data = dataNew;
+      numCapacity = newCapacity;
+   }
+
+   // give back the heap buffer, if there is one. The elements must be gone.
+   void freeHeap()
+   {
+      if (!is_inline())
+         traits::deallocate(alloc, data, numCapacity);
+      data = inlineData();
+      numCapacity = N;
+   }
+
+   // take rhs's elements: its heap buffer if it has one, else one at a time
+   void moveFrom(small_vector & rhs)
+   {
+      assert(empty());
+      if (!rhs.is_inline() && alloc == rhs.alloc)
+      {
+         freeHeap();
+         data = rhs.data;
+         numCapacity = rhs.numCapacity;
+         numElements = rhs.numElements;
+         rhs.data = rhs.inlineData();
+         rhs.numCapacity = N;
+         rhs.numElements = 0;
+         return;
+      }
+      reserve(rhs.numElements);
+      for (size_t i = 0; i < rhs.numElements; i++)
+         traits::construct(alloc, data + i, std::move(rhs.data[i]));
+      numElements = rhs.numElements;
+      rhs.clear();
+   }
+
+   T *    data;               // inlineData() or a heap buffer
+   size_t numCapacity;
+   size_t numElements;
+   A      alloc;
+   alignas(T) unsigned char inlineBuffer[N * sizeof(T)];
+};
+
+} // namespace custom
@@ -5,11 +5,29 @@
  *    Br. Helfrich
  * Summary:
  *    A mock class designed to measure its usage: a spy!
+ *
+ *    By default each thread keeps its own counts: numCopy() and the
+ *    rest are what this thread did since it last called reset(), so
+ *    tests running at the same time do not see each other. total()
+ *    adds up every thread, including the ones that have exited, for
+ *    measuring work spread over many threads:
+ *
+ *       Spy::resetTotal();
+ *       // ... threads push, pop, and join ...
+ *       double movesPerOp = (double)Spy::total(COPY_MOVE) / numOps;
+ *
+ *    In Spy::ATOMIC mode every thread counts into one set of atomic
+ *    counters instead, which numCopy() and the rest then read. It is
+ *    slower, and global, so only one test may use it at a time.
  ************************************************************************/
 
 #pragma once
 
 #include <cassert>
+#include <atomic>     // for std::atomic
+#include <mutex>      // for std::mutex
+#include <vector>     // for std::vector
+#include <algorithm>  // for std::find
 
 enum { ALLOC,      // 0 allocations, number of times NEW is called
        DELETE,     // 1 deletions, number of times DELETE is called
@@ -36,14 +54,14 @@ public:
    int * p;
    
    // default constructor: allocate a spot and assign to zero
-   Spy() : p(nullptr) { counters[DEFAULT]++; }
+   Spy() : p(nullptr) { count(DEFAULT); }
    
    // non-default constructor: allocate a spot and assign to the value
    Spy(int value) : p(nullptr)
    {
       allocate();
       *p = value;
-      counters[NONDEFAULT]++;
+      count(NONDEFAULT);
    }
    
    // copy constructor: make a new copy
@@ -54,7 +72,7 @@ public:
          allocate();
          *p = rhs.get();
       }
-      counters[COPY]++;
+      count(COPY);
    }
    
    // move constructor: steal the data from the RHS
@@ -67,7 +85,7 @@ public:
       }
       else
          p = nullptr;
-      counters[COPY_MOVE]++;
+      count(COPY_MOVE);
    }
    
    // delete - remove the instance
@@ -75,7 +93,7 @@ public:
    {
       if (!empty())
          unallocate();
-      counters[DESTRUCTOR]++;
+      count(DESTRUCTOR);
    }
 
    // copy assignment operator
@@ -89,7 +107,7 @@ public:
       }
       else if (!empty())
          unallocate();
-      counters[ASSIGN]++;
+      count(ASSIGN);
       return *this;
    }
    
@@ -100,7 +118,7 @@ public:
          unallocate();
       p = rhs.p;
       rhs.p = nullptr;
-      counters[ASSIGN_MOVE]++;
+      count(ASSIGN_MOVE);
       return *this;
    }
    
@@ -110,7 +128,7 @@ public:
       int *pTemp = rhs.p;
       rhs.p = p;
       p = pTemp;
-      counters[SWAP]++;
+      count(SWAP);
    }
    
    // is this pointer empty?
@@ -136,7 +154,7 @@ public:
    // compare the values
    bool operator==(const Spy & rhs) const
    {
-      counters[EQUALS]++;
+      count(EQUALS);
       if (rhs.empty() && empty())
          return true;
       if (!rhs.empty() && !empty())
@@ -147,7 +165,7 @@ public:
    // a null value is assumed to be the smallest value
    bool operator<(const Spy & rhs) const
    {
-      counters[LESSTHAN]++;
+      count(LESSTHAN);
       if (rhs.empty() && empty())
          return false;
       if (!rhs.empty() && !empty())
@@ -158,36 +176,150 @@ public:
          return false;
    }
    
-   // reset the counters for a new test
+   // where the counts go
+   enum Counting { PER_THREAD, // each thread its own, the default
+                   ATOMIC };   // one shared set for every thread
+
+   // not while other threads are counting: set it, then start them
+   static void setCounting(Counting counting)
+   {
+      mode() = counting;
+   }
+   static Counting counting()
+   {
+      return mode();
+   }
+
+   // reset the counters for a new test: this thread's, or the
+   // shared ones in ATOMIC mode
    static void reset()
    {
       for (int i = 0; i < NUM_MARKERS; i++)
-         counters[i] = 0;
-   }
-   
-   static int numAlloc()       { return counters[ALLOC];      }
-   static int numDelete()      { return counters[DELETE];     }
-   static int numDefault()     { return counters[DEFAULT];    }
-   static int numNondefault()  { return counters[NONDEFAULT]; }
-   static int numCopy()        { return counters[COPY];       }
-   static int numCopyMove()    { return counters[COPY_MOVE];  }
-   static int numDestructor()  { return counters[DESTRUCTOR]; }
-   static int numAssign()      { return counters[ASSIGN];     }
-   static int numAssignMove()  { return counters[ASSIGN_MOVE];}
-   static int numEquals()      { return counters[EQUALS];     }
-   static int numLessthan()    { return counters[LESSTHAN];   }
-   static int numSwap()        { return counters[SWAP];       }
+         if (counting() == ATOMIC)
+            registry().shared[i].store(0, std::memory_order_relaxed);
+         else
+            local().counts[i] = 0;
+   }
+
+   // everything counted by every thread, in either mode, since the
+   // last resetTotal(). Call it once the threads that count are
+   // joined, not while they are still counting.
+   static int total(int marker)
+   {
+      Registry & r = registry();
+      std::lock_guard<std::mutex> guard(r.lock);
+      int sum = r.retired[marker] + r.shared[marker].load(std::memory_order_relaxed);
+      for (const Counts * counts : r.live)
+         sum += counts->counts[marker];
+      return sum;
+   }
+   static void resetTotal()
+   {
+      Registry & r = registry();
+      std::lock_guard<std::mutex> guard(r.lock);
+      for (int i = 0; i < NUM_MARKERS; i++)
+      {
+         r.retired[i] = 0;
+         r.shared[i].store(0, std::memory_order_relaxed);
+         for (Counts * counts : r.live)
+            counts->counts[i] = 0;
+      }
+   }
+   
+   static int numAlloc()       { return counter(ALLOC);      }
+   static int numDelete()      { return counter(DELETE);     }
+   static int numDefault()     { return counter(DEFAULT);    }
+   static int numNondefault()  { return counter(NONDEFAULT); }
+   static int numCopy()        { return counter(COPY);       }
+   static int numCopyMove()    { return counter(COPY_MOVE);  }
+   static int numDestructor()  { return counter(DESTRUCTOR); }
+   static int numAssign()      { return counter(ASSIGN);     }
+   static int numAssignMove()  { return counter(ASSIGN_MOVE);}
+   static int numEquals()      { return counter(EQUALS);     }
+   static int numLessthan()    { return counter(LESSTHAN);   }
+   static int numSwap()        { return counter(SWAP);       }
 
-   // keep track of how it is used
-   static int counters[NUM_MARKERS];
 private:
+   struct Counts;
+
+   // every thread's counts, and the shared ones
+   struct Registry
+   {
+      Registry()
+      {
+         for (int i = 0; i < NUM_MARKERS; i++)
+         {
+            retired[i] = 0;
+            shared[i].store(0, std::memory_order_relaxed);
+         }
+      }
+      std::mutex            lock;                 // guards live and retired
+      std::vector<Counts *> live;                 // threads still running
+      int                   retired[NUM_MARKERS]; // threads that have exited
+      std::atomic<int>      shared[NUM_MARKERS];  // the ATOMIC mode counts
+   };
+
+   // one thread's counts. Only that thread writes them, so they are
+   // plain ints: total() reads them once the thread has been joined
+   // or has otherwise handed its work back. A thread that exits
+   // leaves its counts in the registry.
+   struct Counts
+   {
+      Counts() : counts()
+      {
+         Registry & r = registry();
+         std::lock_guard<std::mutex> guard(r.lock);
+         r.live.push_back(this);
+      }
+      ~Counts()
+      {
+         Registry & r = registry();
+         std::lock_guard<std::mutex> guard(r.lock);
+         for (int i = 0; i < NUM_MARKERS; i++)
+            r.retired[i] += counts[i];
+         r.live.erase(std::find(r.live.begin(), r.live.end(), this));
+      }
+      int counts[NUM_MARKERS];
+   };
+
+   // read on every count, so a plain variable with no guard
+   static Counting & mode()
+   {
+      static Counting m = PER_THREAD;
+      return m;
+   }
+   static Registry & registry()
+   {
+      static Registry r;
+      return r;
+   }
+   static Counts & local()
+   {
+      thread_local Counts counts;
+      return counts;
+   }
+
+   // keep track of how it is used
+   static void count(int marker)
+   {
+      if (mode() == ATOMIC)
+         registry().shared[marker].fetch_add(1, std::memory_order_relaxed);
+      else
+         local().counts[marker]++;
+   }
+   static int counter(int marker)
+   {
+      if (counting() == ATOMIC)
+         return registry().shared[marker].load(std::memory_order_relaxed);
+      return local().counts[marker];
+   }
    
    // allocate a new buffer
    void allocate()
    {
       assert(p == nullptr);
       p = new int;
-      counters[ALLOC]++;
+      count(ALLOC);
    }
    
    // free the buffer
@@ -196,7 +328,7 @@ private:
       assert(p != nullptr);
       delete p;
       p = nullptr;
-      counters[DELETE]++;
+      count(DELETE);
    }
    
 };
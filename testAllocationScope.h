@@ -0,0 +1,222 @@
+/***********************************************************************
+ * Header:
+ *    TEST ALLOCATION SCOPE
+ * Summary:
+ *    Unit tests for AllocationScope, and the allocation budgets of
+ *    the containers that it makes possible
+ * Author
+ *    Stephen Costigan, Alexander Dohms, Jonathan Colwell, Shaun Crook
+ ************************************************************************/
+
+#pragma once
+
+#ifdef DEBUG
+
+#include "allocationScope.h"   // class under test
+#include "aligned_allocator.h" // for an over-aligned allocation
+#include "priority_queue.h"    // for the budgets
+#include "vector.h"            // for the budgets
+#include "unitTest.h"          // unit test baseclass
+
+#include <cstdint>             // for uintptr_t, SIZE_MAX
+#include <new>                 // for std::bad_alloc, std::nothrow
+#include <thread>              // for std::thread
+
+/***********************************************
+ * TEST ALLOCATION SCOPE
+ * Unit tests for the AllocationScope class
+ ***********************************************/
+class TestAllocationScope : public UnitTest
+{
+public:
+   void run()
+   {
+      reset();
+
+      // Scope
+      test_installed();
+      test_scope_newDelete();
+      test_scope_nested();
+      test_scope_otherThread();
+      test_scope_aligned();
+      test_scope_tooBig();
+
+      // Budget
+      test_budget_reserve();
+      test_budget_pushbackPeak();
+      test_budget_heapify();
+      test_budget_pop();
+
+      report("AllocationScope");
+   }
+
+   /***************************************
+    * SCOPE
+    ***************************************/
+
+   // the driver replaced operator new, so the scopes count
+   void test_installed()
+   {  // setup
+      // exercise
+      // verify
+      assertUnit(AllocationScope::installed());
+   }  // teardown
+
+   // one new and one delete: nothing left, but it was there once
+   void test_scope_newDelete()
+   {  // setup
+      AllocationScope scope;
+      // exercise: volatile, so the pair cannot be optimized away
+      int * volatile p = new int(26);
+      delete p;
+      // verify
+      assertUnit(scope.numAlloc() == 1);
+      assertUnit(scope.numDelete() == 1);
+      assertUnit(scope.bytesAllocated() == sizeof(int));
+      assertUnit(scope.bytesLive() == 0);
+      assertUnit(scope.bytesPeak() == (long long)sizeof(int));
+   }  // teardown
+
+   // an allocation counts in every scope it is inside
+   void test_scope_nested()
+   {  // setup
+      AllocationScope outer;
+      int * p1 = new int(1);
+      // exercise
+      {
+         AllocationScope inner;
+         int * p2 = new int(2);
+         delete p1;
+         // verify
+         assertUnit(inner.numAlloc() == 1);
+         assertUnit(inner.numDelete() == 1);
+         assertUnit(inner.bytesLive() == 0);
+         delete p2;
+         assertUnit(inner.bytesLive() == -(long long)sizeof(int));
+      }
+      assertUnit(outer.numAlloc() == 2);
+      assertUnit(outer.numDelete() == 2);
+      assertUnit(outer.bytesLive() == 0);
+      assertUnit(outer.bytesPeak() == 2 * (long long)sizeof(int));
+   }  // teardown
+
+   // what another thread allocates is not ours
+   void test_scope_otherThread()
+   {  // setup
+      AllocationScope scope;
+      // exercise
+      std::thread other([]()
+      {
+         AllocationScope theirs;
+         delete new int(3);
+      });
+      size_t numAfterStart = scope.numAlloc();
+      other.join();
+      // verify
+      assertUnit(scope.numAlloc() == numAfterStart);
+   }  // teardown
+
+   // over-aligned new is counted and stays aligned
+   void test_scope_aligned()
+   {  // setup
+      custom::aligned_allocator<int, 64> alloc;
+      AllocationScope scope;
+      // exercise
+      int * p = alloc.allocate(10);
+      bool isAligned = (uintptr_t)p % 64 == 0;
+      alloc.deallocate(p, 10);
+      // verify
+      assertUnit(isAligned);
+      assertUnit(scope.numAlloc() == 1);
+      assertUnit(scope.bytesAllocated() == 64);
+      assertUnit(scope.bytesLive() == 0);
+   }  // teardown
+
+   // a size that leaves no room for the header is refused, not wrapped
+   void test_scope_tooBig()
+   {  // setup
+      volatile size_t tooBig = SIZE_MAX - 1;   // not a constant, or it warns
+      AllocationScope scope;
+      bool threw = false;
+      void * p = nullptr;
+      // exercise
+      try
+      {
+         p = ::operator new(tooBig);
+      }
+      catch (const std::bad_alloc &)
+      {
+         threw = true;
+      }
+      void * q = ::operator new(tooBig, std::nothrow);
+      // verify
+      assertUnit(threw);
+      assertUnit(p == nullptr);
+      assertUnit(q == nullptr);
+      assertUnit(scope.numAlloc() == 0);
+   }  // teardown
+
+   /***************************************
+    * BUDGET
+    ***************************************/
+
+   // reserve() is one block of exactly the size asked for
+   void test_budget_reserve()
+   {  // setup
+      custom::vector<int> v;
+      AllocationScope scope;
+      // exercise
+      v.reserve(100);
+      // verify
+      assertUnit(scope.numAlloc() == 1);
+      assertUnit(scope.bytesAllocated() == 100 * sizeof(int));
+   }  // teardown
+
+   // doubling to 1024: eleven buffers, at most two alive at once
+   void test_budget_pushbackPeak()
+   {  // setup
+      custom::vector<int> v;
+      AllocationScope scope;
+      // exercise
+      for (int i = 0; i < 1000; i++)
+         v.push_back(i);
+      // verify
+      assertUnit(scope.numAlloc() == 11);
+      assertUnit(scope.numDelete() == 10);
+      assertUnit(scope.bytesLive() == (long long)(v.capacity() * sizeof(int)));
+      assertUnit(scope.bytesPeak() == (long long)((1024 + 512) * sizeof(int)));
+   }  // teardown
+
+   // building a heap in the buffer it is handed allocates nothing
+   void test_budget_heapify()
+   {  // setup
+      custom::vector<int> v;
+      for (int i = 0; i < 1000; i++)
+         v.push_back((i * 37) % 1000);
+      AllocationScope scope;
+      // exercise
+      custom::priority_queue<int> pq(std::move(v));
+      // verify
+      assertUnit(scope.numAlloc() == 0);
+      assertUnit(pq.top() == 999);
+   }  // teardown
+
+   // neither does taking the top off
+   void test_budget_pop()
+   {  // setup
+      custom::vector<int> v;
+      for (int i = 0; i < 1000; i++)
+         v.push_back(i);
+      custom::priority_queue<int> pq(std::move(v));
+      AllocationScope scope;
+      // exercise
+      while (pq.size() > 1)
+         pq.pop();
+      // verify
+      assertUnit(scope.numAlloc() == 0);
+      assertUnit(scope.numDelete() == 0);
+      assertUnit(pq.top() == 0);
+   }  // teardown
+};
+
+#endif // DEBUG
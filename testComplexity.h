@@ -0,0 +1,259 @@
+/***********************************************************************
+ * Header:
+ *    TEST COMPLEXITY
+ * Summary:
+ *    The other unit tests count what a handful of elements cost. These
+ *    count what push, pop, heapify, reserve, and copy cost at every
+ *    size from 2^4 to 2^20 and hold the counts to a bound with the
+ *    constant written out, so a change that makes pop() do one more
+ *    compare per level fails here even though it is still O(log n):
+ *
+ *       pop        : at most 2 log2 n compares and 3 log2 n moves
+ *       push       : at most 5 log2 n compares, one copy
+ *       heapify    : at most 9/4 n compares and 5/2 n moves
+ *       push_back  : one copy, and under one relocation, per element
+ *       reserve    : one move per element; no copy, no allocation
+ *       copy       : one copy and one allocation per element, no compare
+ *
+ *    The counts come from Spy. pop and push are sampled: a few hundred
+ *    of each at every size, every one held to the bound. pop stops
+ *    at half the size it started with, so the heap never gets so
+ *    small that the swap of the top with the last counts for more
+ *    than a level. The tests run at the same time, on a worker pool;
+ *    Spy counts per thread, so the bounds hold all the same.
+ * Author
+ *    Stephen Costigan, Alexander Dohms, Jonathan Colwell, Shaun Crook
+ ************************************************************************/
+
+#pragma once
+
+#ifdef DEBUG
+
+#include "priority_queue.h"   // class under test
+#include "vector.h"           // class under test
+#include "unitTest.h"         // unit test baseclass
+#include "spy.h"
+
+/***********************************************
+ * TEST COMPLEXITY
+ * Spy counts against their bounds at sizes 2^4 .. 2^20
+ ***********************************************/
+class TestComplexity : public UnitTest
+{
+public:
+   void run()
+   {
+      reset();
+
+      // each test counts only its own Spies, so they can run at once
+      runConcurrently({
+         // Priority queue
+         [this]() { test_pop_logCompares();    },
+         [this]() { test_push_logCompares();   },
+         [this]() { test_heapify_linear();     },
+         [this]() { test_copy_noCompares();    },
+
+         // Vector
+         [this]() { test_pushback_amortized(); },
+         [this]() { test_reserve_movesOnly();  },
+         [this]() { test_copy_linear();        }
+      });
+
+      report("Complexity");
+   }
+
+   static const size_t lgFirst   = 4;
+   static const size_t lgLast    = 20;
+   static const size_t numSample = 256;
+
+   // n distinct values, scrambled
+   static void fill(custom::vector<Spy> & v, size_t n)
+   {
+      v.reserve(n);
+      for (size_t i = 0; i < n; i++)
+         v.push_back(Spy(int((i * 2654435761u) % 1000003u)));
+   }
+
+   // the height of a heap of n: the smallest k with 2^k >= n
+   static int height(size_t n)
+   {
+      int k = 0;
+      while ((size_t(1) << k) < n)
+         k++;
+      return k;
+   }
+
+   static int numMoves()
+   {
+      return Spy::numCopyMove() + Spy::numAssignMove();
+   }
+
+   /***************************************
+    * PRIORITY QUEUE
+    ***************************************/
+
+   // each pop sifts one element down: two compares and a swap a level
+   void test_pop_logCompares()
+   {  // setup
+      bool withinBound = true;
+      for (size_t lg = lgFirst; lg <= lgLast; lg++)
+      {
+         custom::vector<Spy> v;
+         fill(v, size_t(1) << lg);
+         custom::priority_queue<Spy> pq(std::move(v));
+         // exercise
+         for (size_t i = 0; i < numSample && i < pq.size(); i++)
+         {
+            int lgSize = height(pq.size());
+            Spy::reset();
+            pq.pop();
+            withinBound = withinBound &&
+                          Spy::numLessthan() <= 2 * lgSize &&
+                          numMoves()         <= 3 * lgSize &&
+                          Spy::numCopy()     == 0 &&
+                          Spy::numAlloc()    == 0;
+         }
+      }
+      // verify
+      assertUnit(withinBound);
+   }  // teardown
+
+   // a new maximum climbs every level to the top
+   void test_push_logCompares()
+   {  // setup
+      bool withinBound = true;
+      for (size_t lg = lgFirst; lg <= lgLast; lg++)
+      {
+         custom::vector<Spy> v;
+         fill(v, size_t(1) << lg);
+         v.reserve(v.size() + numSample);
+         custom::priority_queue<Spy> pq(std::move(v));
+         // exercise
+         for (size_t i = 0; i < numSample; i++)
+         {
+            Spy s(2000000 + int(i));
+            Spy::reset();
+            pq.push(s);
+            withinBound = withinBound &&
+                          Spy::numLessthan() <= 5 * height(pq.size()) &&
+                          Spy::numCopy()     == 1;
+         }
+      }
+      // verify
+      assertUnit(withinBound);
+   }  // teardown
+
+   // building the heap bottom up is linear, not n log n
+   void test_heapify_linear()
+   {  // setup
+      bool withinBound = true;
+      for (size_t lg = lgFirst; lg <= lgLast; lg++)
+      {
+         size_t n = size_t(1) << lg;
+         custom::vector<Spy> v;
+         fill(v, n);
+         Spy::reset();
+         // exercise
+         custom::priority_queue<Spy> pq(std::move(v));
+         withinBound = withinBound &&
+                       size_t(Spy::numLessthan()) <= n * 9 / 4 &&
+                       size_t(numMoves())         <= n * 5 / 2 &&
+                       Spy::numCopy()             == 0;
+      }
+      // verify
+      assertUnit(withinBound);
+   }  // teardown
+
+   // a copy of a heap is already a heap
+   void test_copy_noCompares()
+   {  // setup
+      bool withinBound = true;
+      for (size_t lg = lgFirst; lg <= lgLast; lg++)
+      {
+         size_t n = size_t(1) << lg;
+         custom::vector<Spy> v;
+         fill(v, n);
+         custom::priority_queue<Spy> pqSrc(std::move(v));
+         Spy::reset();
+         // exercise
+         custom::priority_queue<Spy> pqDest(pqSrc);
+         withinBound = withinBound &&
+                       Spy::numLessthan()      == 0 &&
+                       size_t(Spy::numCopy())  == n &&
+                       size_t(Spy::numAlloc()) == n;
+      }
+      // verify
+      assertUnit(withinBound);
+   }  // teardown
+
+   /***************************************
+    * VECTOR
+    ***************************************/
+
+   // doubling moves 1 + 2 + 4 + ... < n elements over n push_backs
+   void test_pushback_amortized()
+   {  // setup
+      bool withinBound = true;
+      for (size_t lg = lgFirst; lg <= lgLast; lg++)
+      {
+         size_t n = size_t(1) << lg;
+         custom::vector<Spy> v;
+         Spy s(26);
+         Spy::reset();
+         // exercise
+         for (size_t i = 0; i < n; i++)
+            v.push_back(s);
+         withinBound = withinBound &&
+                       size_t(Spy::numCopy()) == n &&
+                       size_t(numMoves())     <  n &&
+                       Spy::numAssign()       == 0;
+      }
+      // verify
+      assertUnit(withinBound);
+   }  // teardown
+
+   // growing a full vector moves each element once
+   void test_reserve_movesOnly()
+   {  // setup
+      bool withinBound = true;
+      for (size_t lg = lgFirst; lg <= lgLast; lg++)
+      {
+         size_t n = size_t(1) << lg;
+         custom::vector<Spy> v;
+         fill(v, n);
+         Spy::reset();
+         // exercise
+         v.reserve(n * 2);
+         withinBound = withinBound &&
+                       size_t(Spy::numCopyMove()) == n &&
+                       Spy::numCopy()             == 0 &&
+                       Spy::numAlloc()            == 0 &&
+                       Spy::numDelete()           == 0;
+      }
+      // verify
+      assertUnit(withinBound);
+   }  // teardown
+
+   // one copy, and so one allocation, per element
+   void test_copy_linear()
+   {  // setup
+      bool withinBound = true;
+      for (size_t lg = lgFirst; lg <= lgLast; lg++)
+      {
+         size_t n = size_t(1) << lg;
+         custom::vector<Spy> vSrc;
+         fill(vSrc, n);
+         Spy::reset();
+         // exercise
+         custom::vector<Spy> vDest(vSrc);
+         withinBound = withinBound &&
+                       size_t(Spy::numCopy())  == n &&
+                       size_t(Spy::numAlloc()) == n &&
+                       numMoves()              == 0;
+      }
+      // verify
+      assertUnit(withinBound);
+   }  // teardown
+};
+
+#endif // DEBUG
@@ -0,0 +1,209 @@
+/***********************************************************************
+ * Header:
+ *    TEST CONCURRENT VECTOR
+ * Summary:
+ *    Unit tests for concurrent_vector
+ * Author
+ *    Stephen Costigan, Alexander Dohms, Jonathan Colwell, Shaun Crook
+ ************************************************************************/
+
+#pragma once
+
+#ifdef DEBUG
+
+#include "concurrent_vector.h" // class under test
+#include "priority_queue.h"    // for building a queue from freeze()
+#include "unitTest.h"          // unit test baseclass
+#include "spy.h"
+
+#include <algorithm>           // for std::sort
+#include <thread>              // for std::thread
+#include <vector>              // for std::vector
+
+/***********************************************
+ * TEST CONCURRENT VECTOR
+ * Unit tests for the concurrent_vector class
+ ***********************************************/
+class TestConcurrentVector : public UnitTest
+{
+public:
+   void run()
+   {
+      reset();
+
+      // Segment
+      test_segment_boundaries();
+      test_reserve_capacity();
+
+      // Insert
+      test_pushback_indices();
+      test_pushback_referencesStay();
+      test_pushback_threads();
+
+      // Freeze
+      test_freeze_keepsOrder();
+      test_freeze_movesSpy();
+      test_freeze_pqueue();
+      test_destructor_spy();
+
+      report("ConcurrentVector");
+   }
+
+   /***************************************
+    * SEGMENT
+    ***************************************/
+
+   // segments of 16, 32, 64 elements, back to back
+   void test_segment_boundaries()
+   {  // setup
+      typedef custom::concurrent_vector<int> Vector;
+      // exercise
+      // verify
+      assertUnit(Vector::segmentOf(0) == 0);
+      assertUnit(Vector::segmentOf(15) == 0);
+      assertUnit(Vector::segmentOf(16) == 1);
+      assertUnit(Vector::segmentOf(47) == 1);
+      assertUnit(Vector::segmentOf(48) == 2);
+      assertUnit(Vector::segmentBegin(2) == 48);
+      assertUnit(Vector::segmentSize(2) == 64);
+   }  // teardown
+
+   // reserve() adds whole segments and builds nothing
+   void test_reserve_capacity()
+   {  // setup
+      custom::concurrent_vector<int> v;
+      // exercise
+      v.reserve(20);
+      // verify
+      assertUnit(v.capacity() == 48);
+      assertUnit(v.size() == 0);
+      assertUnit(v.empty());
+   }  // teardown
+
+   /***************************************
+    * INSERT
+    ***************************************/
+
+   // each push_back() says where it put the element
+   void test_pushback_indices()
+   {  // setup
+      custom::concurrent_vector<int> v;
+      bool inOrder = true;
+      // exercise
+      for (int i = 0; i < 100; i++)
+         inOrder = inOrder && v.push_back(i * 2) == size_t(i);
+      // verify
+      assertUnit(inOrder);
+      assertUnit(v.size() == 100);
+      assertUnit(v[0] == 0);
+      assertUnit(v[16] == 32);
+      assertUnit(v[99] == 198);
+   }  // teardown
+
+   // growing adds a segment; nothing already there moves
+   void test_pushback_referencesStay()
+   {  // setup
+      custom::concurrent_vector<int> v;
+      v.push_back(26);
+      int * p = &v[0];
+      // exercise
+      for (int i = 0; i < 1000; i++)
+         v.push_back(i);
+      // verify
+      assertUnit(p == &v[0]);
+      assertUnit(*p == 26);
+      assertUnit(v.size() == 1001);
+   }  // teardown
+
+   // four threads at once: every element lands exactly once
+   void test_pushback_threads()
+   {  // setup
+      const int numThreads = 4;
+      const int numEach = 10000;
+      custom::concurrent_vector<int> v;
+      std::vector<std::thread> threads;
+      // exercise
+      for (int t = 0; t < numThreads; t++)
+         threads.emplace_back([&v, t, numEach]()
+         {
+            for (int i = 0; i < numEach; i++)
+               v.push_back(t * numEach + i);
+         });
+      for (std::thread & thread : threads)
+         thread.join();
+      // verify
+      assertUnit(v.size() == size_t(numThreads * numEach));
+      custom::vector<int> frozen = v.freeze();
+      std::sort(frozen.begin(), frozen.end());
+      bool everyOnce = true;
+      for (int i = 0; i < numThreads * numEach; i++)
+         everyOnce = everyOnce && frozen[i] == i;
+      assertUnit(everyOnce);
+   }  // teardown
+
+   /***************************************
+    * FREEZE
+    ***************************************/
+
+   // one contiguous vector, in push_back() order; we are left empty
+   void test_freeze_keepsOrder()
+   {  // setup
+      custom::concurrent_vector<int> v;
+      for (int i = 0; i < 50; i++)
+         v.push_back(i);
+      // exercise
+      custom::vector<int> frozen = v.freeze();
+      // verify
+      assertUnit(frozen.size() == 50);
+      assertUnit(frozen[0] == 0);
+      assertUnit(frozen[16] == 16);
+      assertUnit(frozen[49] == 49);
+      assertUnit(v.empty());
+      assertUnit(v.capacity() == 0);
+   }  // teardown
+
+   // the elements are moved out, not copied
+   void test_freeze_movesSpy()
+   {  // setup
+      custom::concurrent_vector<Spy> v;
+      for (int i = 0; i < 20; i++)
+         v.push_back(Spy(i));
+      Spy::reset();
+      // exercise
+      custom::vector<Spy> frozen = v.freeze();
+      // verify
+      assertUnit(Spy::numCopy() == 0);
+      assertUnit(Spy::numCopyMove() == 20);
+      assertUnit(frozen[19].get() == 19);
+   }  // teardown
+
+   // what the ingest threads collected becomes a heap
+   void test_freeze_pqueue()
+   {  // setup
+      custom::concurrent_vector<int> v;
+      for (int i = 0; i < 100; i++)
+         v.push_back((i * 37) % 100);
+      // exercise
+      custom::priority_queue<int> pq(v.freeze());
+      // verify
+      assertUnit(pq.size() == 100);
+      assertUnit(pq.top() == 99);
+   }  // teardown
+
+   // every element destroyed and every segment freed
+   void test_destructor_spy()
+   {  // setup
+      Spy::reset();
+      {
+         custom::concurrent_vector<Spy> v;
+         for (int i = 0; i < 40; i++)
+            v.push_back(Spy(i));
+         // exercise
+      }
+      // verify
+      assertUnit(Spy::numNondefault() + Spy::numCopy() + Spy::numCopyMove() == Spy::numDestructor());
+      assertUnit(Spy::numAlloc() == Spy::numDelete());
+   }  // teardown
+};
+
+#endif // DEBUG
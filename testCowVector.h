@@ -0,0 +1,269 @@
+/***********************************************************************
+ * Header:
+ *    TEST COW VECTOR
+ * Summary:
+ *    Unit tests for cow_vector and cow_priority_queue
+ * Author
+ *    Stephen Costigan, Alexander Dohms, Jonathan Colwell, Shaun Crook
+ ************************************************************************/
+
+#pragma once
+
+#ifdef DEBUG
+
+#include "cow_vector.h"       // class under test
+#include "priority_queue.h"   // for cow_priority_queue
+#include "unitTest.h"         // unit test baseclass
+#include "spy.h"
+
+#include <thread>             // for std::thread
+
+/***********************************************
+ * TEST COW VECTOR
+ * Unit tests for the cow_vector class
+ ***********************************************/
+class TestCowVector : public UnitTest
+{
+public:
+   void run()
+   {
+      reset();
+
+      // Share
+      test_constructCopy_shares();
+      test_assign_shares();
+      test_read_doesNotClone();
+
+      // Write
+      test_pushback_clonesShared();
+      test_pushback_movesUnshared();
+      test_pushback_aliasWhileCloning();
+      test_clear_releasesShared();
+      test_destructor_spy();
+
+      // Priority queue
+      test_pqueue_snapshot();
+      test_pqueue_snapshotThread();
+      test_pqueue_heapifyParallelShared();
+
+      report("CowVector");
+   }
+
+   /***************************************
+    * SHARE
+    ***************************************/
+
+   // a copy is one more owner of the same buffer
+   void test_constructCopy_shares()
+   {  // setup
+      custom::cow_vector<Spy> vSrc;
+      for (int i = 0; i < 4; i++)
+         vSrc.push_back(Spy(i));
+      Spy::reset();
+      // exercise
+      custom::cow_vector<Spy> vDest(vSrc);
+      // verify
+      assertUnit(vDest.data == vSrc.data);
+      assertUnit(vDest.use_count() == 2);
+      assertUnit(vDest.size() == 4);
+      assertUnit(Spy::numCopy() == 0);
+      assertUnit(Spy::numAlloc() == 0);
+   }  // teardown
+
+   // assignment lets go of the old buffer and shares the new one
+   void test_assign_shares()
+   {  // setup
+      custom::cow_vector<int> vSrc{ 26, 49, 67 };
+      custom::cow_vector<int> vDest{ 89 };
+      // exercise
+      vDest = vSrc;
+      // verify
+      assertUnit(vDest.data == vSrc.data);
+      assertUnit(vSrc.use_count() == 2);
+      assertUnit(vDest.size() == 3);
+   }  // teardown
+
+   // reading through const leaves the buffer shared
+   void test_read_doesNotClone()
+   {  // setup
+      custom::cow_vector<int> vSrc{ 26, 49, 67 };
+      custom::cow_vector<int> vDest(vSrc);
+      const custom::cow_vector<int> & vConst = vDest;
+      int total = 0;
+      // exercise
+      for (const int & i : vConst)
+         total += i;
+      total += vConst[0] + vConst.back();
+      // verify
+      assertUnit(total == 26 + 49 + 67 + 26 + 67);
+      assertUnit(vDest.data == vSrc.data);
+   }  // teardown
+
+   /***************************************
+    * WRITE
+    ***************************************/
+
+   // the writer clones; the other owner keeps the old elements
+   void test_pushback_clonesShared()
+   {  // setup
+      custom::cow_vector<Spy> vSrc;
+      for (int i = 0; i < 4; i++)
+         vSrc.push_back(Spy(i));
+      custom::cow_vector<Spy> vDest(vSrc);
+      Spy::reset();
+      // exercise
+      vDest.push_back(Spy(4));
+      // verify
+      assertUnit(vDest.data != vSrc.data);
+      assertUnit(vDest.use_count() == 1);
+      assertUnit(vSrc.use_count() == 1);
+      assertUnit(vDest.size() == 5);
+      assertUnit(vSrc.size() == 4);
+      assertUnit(vDest[4].get() == 4);
+      assertUnit(Spy::numCopy() == 4);
+   }  // teardown
+
+   // with no one else looking, growing moves like any vector
+   void test_pushback_movesUnshared()
+   {  // setup
+      custom::cow_vector<Spy> v;
+      for (int i = 0; i < 4; i++)
+         v.push_back(Spy(i));
+      Spy::reset();
+      // exercise
+      v.push_back(Spy(4));
+      // verify
+      assertUnit(v.capacity() == 8);
+      assertUnit(v.size() == 5);
+      assertUnit(Spy::numCopy() == 0);
+   }  // teardown
+
+   // copying one of the shared elements as we clone
+   void test_pushback_aliasWhileCloning()
+   {  // setup
+      custom::cow_vector<Spy> vSrc;
+      vSrc.push_back(Spy(26));
+      vSrc.push_back(Spy(49));
+      custom::cow_vector<Spy> vDest(vSrc);
+      const custom::cow_vector<Spy> & vConst = vDest;
+      // exercise
+      vDest.push_back(vConst[0]);
+      // verify
+      assertUnit(vDest.size() == 3);
+      assertUnit(vDest[2].get() == 26);
+      assertUnit(vSrc.size() == 2);
+   }  // teardown
+
+   // clearing a shared vector must not clone it first
+   void test_clear_releasesShared()
+   {  // setup
+      custom::cow_vector<Spy> vSrc;
+      for (int i = 0; i < 4; i++)
+         vSrc.push_back(Spy(i));
+      custom::cow_vector<Spy> vDest(vSrc);
+      Spy::reset();
+      // exercise
+      vDest.clear();
+      // verify
+      assertUnit(vDest.empty());
+      assertUnit(vSrc.size() == 4);
+      assertUnit(vSrc.use_count() == 1);
+      assertUnit(Spy::numCopy() == 0);
+      assertUnit(Spy::numDestructor() == 0);
+   }  // teardown
+
+   // the last owner destroys every element once
+   void test_destructor_spy()
+   {  // setup
+      Spy::reset();
+      {
+         custom::cow_vector<Spy> vSrc;
+         for (int i = 0; i < 5; i++)
+            vSrc.push_back(Spy(i));
+         custom::cow_vector<Spy> vShared(vSrc);
+         custom::cow_vector<Spy> vCloned(vSrc);
+         vCloned.pop_back();
+         // exercise
+      }
+      // verify
+      assertUnit(Spy::numNondefault() + Spy::numCopy() + Spy::numCopyMove() == Spy::numDestructor());
+      assertUnit(Spy::numAlloc() == Spy::numDelete());
+   }  // teardown
+
+   /***************************************
+    * PRIORITY QUEUE
+    ***************************************/
+
+   // the snapshot does not see what happens to the queue afterwards
+   void test_pqueue_snapshot()
+   {  // setup
+      custom::cow_priority_queue<Spy> pq;
+      for (int i = 0; i < 10; i++)
+         pq.push(Spy((i * 7) % 10));
+      custom::cow_priority_queue<Spy> snapshot;
+      Spy::reset();
+      // exercise
+      snapshot = pq;
+      size_t numCopySnapshot = Spy::numCopy();
+      pq.pop();
+      pq.push(Spy(26));
+      // verify
+      assertUnit(numCopySnapshot == 0);
+      assertUnit(snapshot.size() == 10);
+      assertUnit(snapshot.top().get() == 9);
+      assertUnit(pq.top().get() == 26);
+      assertUnit(snapshot.container.use_count() == 1);
+   }  // teardown
+
+   // one thread reads a snapshot while another keeps pushing
+   void test_pqueue_snapshotThread()
+   {  // setup
+      custom::cow_priority_queue<int> pq;
+      for (int i = 0; i < 1000; i++)
+         pq.push(i);
+      custom::cow_priority_queue<int> snapshot(pq);
+      long long total = 0;
+      // exercise
+      std::thread reader([&snapshot, &total]()
+      {
+         const custom::cow_vector<int> & c = snapshot.container;
+         for (const int & i : c)
+            total += i;
+      });
+      for (int i = 0; i < 1000; i++)
+      {
+         pq.push(1000 + i);
+         pq.pop();
+      }
+      reader.join();
+      // verify
+      assertUnit(total == 999 * 1000 / 2);
+      assertUnit(snapshot.top() == 999);
+      assertUnit(pq.size() == 1000);
+   }  // teardown
+
+   // the workers of a parallel heapify write to a buffer that was
+   // shared: it must be cloned once, before they start, not by each
+   void test_pqueue_heapifyParallelShared()
+   {  // setup
+      custom::cow_vector<int> v;
+      for (int i = 0; i < 200000; i++)
+         v.push_back((i * 7919) % 200000);
+      custom::cow_vector<int> shared(v);
+      // exercise
+      custom::cow_priority_queue<int> pq(custom::execution::par.threads(4), std::move(shared));
+      // verify
+      assertUnit(pq.size() == 200000);
+      assertUnit(pq.top() == 199999);
+      assertUnit(pq.container.use_count() == 1);
+      assertUnit(v.use_count() == 1);
+      assertUnit(v[0] == 0);
+      assertUnit(v[1] == 7919);
+      bool isHeap = true;
+      for (size_t i = 1; i < pq.size(); i++)
+         isHeap = isHeap && !(pq.container[(i - 1) / 2] < pq.container[i]);
+      assertUnit(isHeap);
+   }  // teardown
+};
+
+#endif // DEBUG
@@ -0,0 +1,299 @@
+/***********************************************************************
+ * Header:
+ *    TEST GROWTH
+ * Summary:
+ *    Unit tests for the growth policies, shrinking, and the
+ *    incremental vector
+ * Author
+ *    Stephen Costigan, Alexander Dohms, Jonathan Colwell, Shaun Crook
+ ************************************************************************/
+
+#pragma once
+
+#ifdef DEBUG
+
+#include "growth.h"              // class under test
+#include "incremental_vector.h"  // class under test
+#include "vector.h"              // for vector with a growth policy
+#include "priority_queue.h"      // for a queue that gives memory back
+#include "unitTest.h"            // unit test baseclass
+#include "spy.h"
+
+/***********************************************
+ * TEST GROWTH
+ * Unit tests for the growth policies
+ ***********************************************/
+class TestGrowth : public UnitTest
+{
+public:
+   void run()
+   {
+      reset();
+
+      // Policies
+      test_factor_two();
+      test_factor_oneAndHalf();
+      test_pageRounded();
+      test_vector_factorOneAndHalf();
+
+      // Shrink
+      test_autoShrink_policy();
+      test_shrink_defaultKeeps();
+      test_shrink_popHalves();
+      test_shrink_hysteresis();
+      test_shrink_pqueue();
+      test_shrink_pqueueToFit();
+
+      // Incremental
+      test_incremental_values();
+      test_incremental_boundedMoves();
+      test_incremental_popDuringMigration();
+      test_incremental_alias();
+
+      report("Growth");
+   }
+
+   /***************************************
+    * POLICIES
+    ***************************************/
+
+   // 0, 1, 2, 4, 8
+   void test_factor_two()
+   {  // setup
+      // exercise
+      // verify
+      assertUnit(custom::growth::factor_2::next(0, 4) == 1);
+      assertUnit(custom::growth::factor_2::next(1, 4) == 2);
+      assertUnit(custom::growth::factor_2::next(2, 4) == 4);
+      assertUnit(custom::growth::factor_2::next(4, 4) == 8);
+   }  // teardown
+
+   // 0, 1, 2, 3, 4, 6, 9, 13
+   void test_factor_oneAndHalf()
+   {  // setup
+      // exercise
+      // verify
+      assertUnit(custom::growth::factor_1_5::next(0, 4) == 1);
+      assertUnit(custom::growth::factor_1_5::next(1, 4) == 2);
+      assertUnit(custom::growth::factor_1_5::next(2, 4) == 3);
+      assertUnit(custom::growth::factor_1_5::next(4, 4) == 6);
+      assertUnit(custom::growth::factor_1_5::next(9, 4) == 13);
+   }  // teardown
+
+   // small buffers grow as usual, big ones fill their last page
+   void test_pageRounded()
+   {  // setup
+      typedef custom::growth::page_rounded<custom::growth::factor_2, 4096> Policy;
+      // exercise
+      // verify
+      assertUnit(Policy::next(4, 4) == 8);          // 32 bytes
+      assertUnit(Policy::next(1000, 4) == 2048);    // 8000 -> 8192 bytes
+      assertUnit(Policy::next(1024, 4) == 2048);    // already 8192 bytes
+      assertUnit(Policy::next(100, 24) == 341);     // 4800 -> 8192 bytes
+   }  // teardown
+
+   // a vector takes its growth policy as a template parameter
+   void test_vector_factorOneAndHalf()
+   {  // setup
+      custom::vector<int, std::allocator<int>, custom::default_instrument, custom::growth::factor_1_5> v;
+      // exercise
+      for (int i = 0; i < 10; i++)
+         v.push_back(i);
+      // verify
+      assertUnit(v.size() == 10);
+      assertUnit(v.capacity() == 13);
+      assertUnit(v[9] == 9);
+   }  // teardown
+
+   /***************************************
+    * SHRINK
+    ***************************************/
+
+   // halve below a quarter full, but not below MinBytes
+   void test_autoShrink_policy()
+   {  // setup
+      typedef custom::growth::auto_shrink<custom::growth::factor_2, 4096> Policy;
+      // exercise
+      // verify
+      assertUnit(Policy::next(4, 4) == 8);
+      assertUnit(Policy::shrink(4096, 1024, 4) == 4096);   // a quarter full
+      assertUnit(Policy::shrink(4096, 1023, 4) == 2048);
+      assertUnit(Policy::shrink(2048, 0, 4) == 1024);      // 4096 bytes left
+      assertUnit(Policy::shrink(1024, 0, 4) == 1024);      // 2048 is too small
+   }  // teardown
+
+   // without auto_shrink, popping everything keeps the buffer
+   void test_shrink_defaultKeeps()
+   {  // setup
+      custom::vector<int> v;
+      for (int i = 0; i < 64; i++)
+         v.push_back(i);
+      // exercise
+      while (!v.empty())
+         v.pop_back();
+      // verify
+      assertUnit(v.capacity() == 64);
+   }  // teardown
+
+   // popping below a quarter halves the buffer, keeping the elements
+   void test_shrink_popHalves()
+   {  // setup
+      custom::vector<Spy, std::allocator<Spy>, custom::default_instrument,
+                     custom::growth::auto_shrink<custom::growth::factor_2, 0>> v;
+      for (int i = 0; i < 64; i++)
+         v.push_back(Spy(i));
+      // exercise
+      while (v.size() > 16)
+         v.pop_back();
+      size_t capacityAtQuarter = v.capacity();
+      v.pop_back();
+      // verify
+      assertUnit(capacityAtQuarter == 64);
+      assertUnit(v.capacity() == 32);
+      assertUnit(v.size() == 15);
+      assertUnit(v[0].get() == 0);
+      assertUnit(v[14].get() == 14);
+   }  // teardown
+
+   // after a shrink, going back up to where it shrank does not grow it
+   void test_shrink_hysteresis()
+   {  // setup
+      custom::vector<int, std::allocator<int>, custom::default_instrument,
+                     custom::growth::auto_shrink<custom::growth::factor_2, 0>> v;
+      for (int i = 0; i < 64; i++)
+         v.push_back(i);
+      while (v.size() > 15)
+         v.pop_back();
+      bool steady = true;
+      // exercise
+      for (int round = 0; round < 10; round++)
+      {
+         for (int i = 0; i < 16; i++)
+            v.push_back(i);
+         for (int i = 0; i < 16; i++)
+            v.pop_back();
+         steady = steady && v.capacity() == 32;
+      }
+      // verify
+      assertUnit(steady);
+      assertUnit(v.size() == 15);
+   }  // teardown
+
+   // a burst through a queue, then idle: the memory goes back
+   void test_shrink_pqueue()
+   {  // setup
+      typedef custom::vector<int, std::allocator<int>, custom::default_instrument,
+                             custom::growth::auto_shrink<custom::growth::factor_2, 0>> Container;
+      custom::priority_queue<int, Container> pq;
+      for (int i = 0; i < 1000; i++)
+         pq.push(i);
+      // exercise
+      while (pq.size() > 10)
+         pq.pop();
+      // verify
+      assertUnit(pq.container.capacity() == 32);   // 1024, 512, ... 32
+      assertUnit(pq.top() == 9);
+   }  // teardown
+
+   // any queue can give its memory back when asked
+   void test_shrink_pqueueToFit()
+   {  // setup
+      custom::priority_queue<int> pq;
+      for (int i = 0; i < 1000; i++)
+         pq.push(i);
+      while (pq.size() > 10)
+         pq.pop();
+      // exercise
+      pq.shrink_to_fit();
+      // verify
+      assertUnit(pq.container.capacity() == 10);
+      assertUnit(pq.top() == 9);
+   }  // teardown
+
+   /***************************************
+    * INCREMENTAL
+    ***************************************/
+
+   // every element can be found at every step of a migration
+   void test_incremental_values()
+   {  // setup
+      custom::incremental_vector<int> v;
+      bool correct = true;
+      bool sawMigration = false;
+      // exercise
+      for (int i = 0; i < 100; i++)
+      {
+         v.push_back(i);
+         sawMigration = sawMigration || v.migrating();
+         for (int j = 0; j <= i; j++)
+            correct = correct && v[j] == j;
+      }
+      // verify
+      assertUnit(correct);
+      assertUnit(sawMigration);
+      assertUnit(v.size() == 100);
+      assertUnit(v.capacity() == 128);
+   }  // teardown
+
+   // no push_back moves more than a few elements
+   void test_incremental_boundedMoves()
+   {  // setup
+      custom::incremental_vector<Spy, std::allocator<Spy>, custom::growth::factor_1_5> v;
+      int maxMoves = 0;
+      // exercise
+      for (int i = 0; i < 1000; i++)
+      {
+         Spy s(i);
+         Spy::reset();
+         v.push_back(std::move(s));
+         if (Spy::numCopyMove() > maxMoves)
+            maxMoves = Spy::numCopyMove();
+      }
+      // verify
+      assertUnit(maxMoves <= 1 + 3);   // the new one, and ceil(9 / 4) old ones
+      assertUnit(Spy::numCopy() == 0);
+      assertUnit(v[0].get() == 0);
+      assertUnit(v[999].get() == 999);
+   }  // teardown
+
+   // popping the elements that have not moved yet ends the migration
+   void test_incremental_popDuringMigration()
+   {  // setup
+      Spy::reset();
+      {
+         custom::incremental_vector<Spy> v;
+         for (int i = 0; i < 9; i++)
+            v.push_back(Spy(i));
+         bool wasMigrating = v.migrating();   // 7 of 8 are still moving to a buffer of 16
+         // exercise
+         while (v.size() > 2)
+            v.pop_back();
+         bool stillMigrating = v.migrating(); // [1] is still in the old buffer
+         v.pop_back();
+         // verify
+         assertUnit(wasMigrating);
+         assertUnit(stillMigrating);
+         assertUnit(!v.migrating());
+         assertUnit(v.size() == 1);
+         assertUnit(v[0].get() == 0);
+      }
+      assertUnit(Spy::numNondefault() + Spy::numCopy() + Spy::numCopyMove() == Spy::numDestructor());
+   }  // teardown
+
+   // push_back of the element that the push_back is about to migrate
+   void test_incremental_alias()
+   {  // setup
+      custom::incremental_vector<Spy> v;
+      for (int i = 0; i < 8; i++)
+         v.push_back(Spy(i + 10));
+      // exercise
+      v.push_back(v[0]);
+      // verify
+      assertUnit(v.migrating());
+      assertUnit(v.size() == 9);
+      assertUnit(v[8].get() == 10);
+      assertUnit(v[0].get() == 10);
+   }  // teardown
+};
+
+#endif // DEBUG
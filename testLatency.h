@@ -0,0 +1,220 @@
+/***********************************************************************
+ * Header:
+ *    TEST LATENCY
+ * Summary:
+ *    Unit tests for the latency histogram and timed priority queue
+ * Author
+ *    Stephen Costigan, Alexander Dohms, Jonathan Colwell, Shaun Crook
+ ************************************************************************/
+
+#pragma once
+
+#ifdef DEBUG
+
+#include "latency.h"    // class under test
+#include "unitTest.h"   // unit test baseclass
+
+#include <sstream>      // for std::ostringstream
+#include <string>
+
+/***********************************************
+ * TEST LATENCY
+ * Unit tests for the latency_histogram class
+ ***********************************************/
+class TestLatency : public UnitTest
+{
+public:
+   void run()
+   {
+      reset();
+
+      // Buckets
+      test_bucket_small();
+      test_bucket_relativeError();
+
+      // Query
+      test_percentile_empty();
+      test_percentile_uniform();
+      test_percentile_spike();
+
+      // Merge
+      test_merge_twoThreads();
+      test_collector_snapshot();
+
+      // Report
+      test_dumpJson_standard();
+
+      // Timed priority queue
+      test_timed_pushPop();
+
+      report("Latency");
+   }
+
+   /***************************************
+    * BUCKETS
+    ***************************************/
+
+   // values below 64 get a bucket each
+   void test_bucket_small()
+   {  // setup
+      bool exact = true;
+      // exercise
+      for (uint64_t ns = 0; ns < 64; ns++)
+         exact = exact &&
+                 custom::latency_histogram::lowestOf(custom::latency_histogram::indexOf(ns)) == ns &&
+                 custom::latency_histogram::highestOf(custom::latency_histogram::indexOf(ns)) == ns;
+      // verify
+      assertUnit(exact);
+   }  // teardown
+
+   // every bucket is within 1/32 of the value that landed in it
+   void test_bucket_relativeError()
+   {  // setup
+      bool close = true;
+      // exercise
+      for (uint64_t ns = 1; ns < (uint64_t(1) << 62); ns = ns * 3 + 1)
+      {
+         size_t index = custom::latency_histogram::indexOf(ns);
+         uint64_t low  = custom::latency_histogram::lowestOf(index);
+         uint64_t high = custom::latency_histogram::highestOf(index);
+         close = close && low <= ns && ns <= high && (high - low) <= ns / 32;
+      }
+      // verify
+      assertUnit(close);
+      assertUnit(custom::latency_histogram::indexOf(UINT64_MAX) ==
+                 custom::latency_histogram::numBuckets - 1);
+   }  // teardown
+
+   /***************************************
+    * QUERY
+    ***************************************/
+
+   // nothing recorded, nothing to report
+   void test_percentile_empty()
+   {  // setup
+      custom::latency_histogram h;
+      // exercise
+      uint64_t p99 = h.percentile(99.0);
+      // verify
+      assertUnit(p99 == 0);
+      assertUnit(h.count() == 0);
+      assertUnit(h.min() == 0);
+      assertUnit(h.max() == 0);
+   }  // teardown
+
+   // 1..1000 ns, once each
+   void test_percentile_uniform()
+   {  // setup
+      custom::latency_histogram h;
+      for (uint64_t ns = 1; ns <= 1000; ns++)
+         h.record(ns);
+      // exercise
+      uint64_t p50 = h.percentile(50.0);
+      uint64_t p99 = h.percentile(99.0);
+      uint64_t p100 = h.percentile(100.0);
+      // verify
+      assertUnit(h.count() == 1000);
+      assertUnit(h.min() == 1);
+      assertUnit(h.max() == 1000);
+      assertUnit(500 <= p50 && p50 <= 500 + 500 / 32);
+      assertUnit(990 <= p99 && p99 <= 990 + 990 / 32);
+      assertUnit(p100 == 1000);
+   }  // teardown
+
+   // one slow push in a thousand must show up at p99.9, not p99
+   void test_percentile_spike()
+   {  // setup
+      custom::latency_histogram h;
+      for (int i = 0; i < 999; i++)
+         h.record(50);
+      h.record(1000000);
+      // exercise
+      uint64_t p99 = h.percentile(99.0);
+      uint64_t p999 = h.percentile(99.95);
+      // verify
+      assertUnit(p99 == 50);
+      assertUnit(p999 == 1000000);
+   }  // teardown
+
+   /***************************************
+    * MERGE
+    ***************************************/
+
+   // two per-thread histograms add up to one
+   void test_merge_twoThreads()
+   {  // setup
+      custom::latency_histogram h1;
+      custom::latency_histogram h2;
+      h1.record(10);
+      h1.record(20);
+      h2.record(5);
+      h2.record(40000);
+      // exercise
+      h1.merge(h2);
+      // verify
+      assertUnit(h1.count() == 4);
+      assertUnit(h1.min() == 5);
+      assertUnit(h1.max() == 40000);
+      assertUnit(h1.percentile(25.0) == 5);
+      assertUnit(h2.count() == 2);
+   }  // teardown
+
+   // the collector is the sum of what was added
+   void test_collector_snapshot()
+   {  // setup
+      custom::latency_collector collector;
+      custom::latency_histogram h;
+      h.record(7);
+      // exercise
+      collector.add(h);
+      collector.add(h);
+      custom::latency_histogram total = collector.snapshot();
+      // verify
+      assertUnit(total.count() == 2);
+      assertUnit(total.max() == 7);
+   }  // teardown
+
+   /***************************************
+    * REPORT
+    ***************************************/
+
+   // the JSON has the summary and the non-empty buckets
+   void test_dumpJson_standard()
+   {  // setup
+      custom::latency_histogram h;
+      h.record(3);
+      h.record(3);
+      std::ostringstream out;
+      // exercise
+      h.dump_json(out);
+      // verify
+      std::string json = out.str();
+      assertUnit(json.find("\"count\":2") != std::string::npos);
+      assertUnit(json.find("\"p99\":3") != std::string::npos);
+      assertUnit(json.find("\"buckets\":[[3,3,2]]") != std::string::npos);
+   }  // teardown
+
+   /***************************************
+    * TIMED PRIORITY QUEUE
+    ***************************************/
+
+   // every operation lands in its own histogram
+   void test_timed_pushPop()
+   {  // setup
+      custom::timed_priority_queue<int> pq;
+      // exercise
+      pq.push(4);
+      pq.push(9);
+      pq.push(1);
+      int value = pq.top();
+      pq.pop();
+      // verify
+      assertUnit(value == 9);
+      assertUnit(pq.size() == 2);
+      assertUnit(pq.push_latency().count() == 3);
+      assertUnit(pq.top_latency().count() == 1);
+      assertUnit(pq.pop_latency().count() == 1);
+   }  // teardown
+};
+
+#endif // DEBUG
@@ -0,0 +1,230 @@
+/***********************************************************************
+ * Header:
+ *    TEST MAPPED VECTOR
+ * Summary:
+ *    Unit tests for mapped_vector
+ * Author
+ *    Stephen Costigan, Alexander Dohms, Jonathan Colwell, Shaun Crook
+ ************************************************************************/
+
+#pragma once
+
+#ifdef DEBUG
+
+#include "mapped_vector.h"    // class under test
+
+#ifdef CUSTOM_HAS_MMAP
+
+#include "priority_queue.h"   // for a priority_queue on a mapped_vector
+#include "unitTest.h"         // unit test baseclass
+
+#include <cstdio>             // for std::remove
+#include <stdexcept>          // for std::runtime_error
+#include <string>
+#include <sys/stat.h>         // for fstat
+#include <unistd.h>           // for getpid
+
+/***********************************************
+ * TEST MAPPED VECTOR
+ * Unit tests for the mapped_vector class
+ ***********************************************/
+class TestMappedVector : public UnitTest
+{
+public:
+   void run()
+   {
+      reset();
+
+      // Construct
+      test_construct_lazy();
+      test_constructCopy_ownFile();
+      test_constructMove_sourceUsable();
+
+      // Insert
+      test_pushback_grows();
+
+      // File
+      test_file_reopen();
+      test_file_wrongType();
+      test_file_shrinkToFit();
+      test_advise_keepsElements();
+
+      // Priority queue
+      test_pqueue_pushPop();
+
+      report("MappedVector");
+   }
+
+   /***************************************
+    * CONSTRUCT
+    ***************************************/
+
+   // no file until there is something to put in it
+   void test_construct_lazy()
+   {  // setup
+      // exercise
+      custom::mapped_vector<int> v;
+      // verify
+      assertUnit(v.empty());
+      assertUnit(v.capacity() == 0);
+      assertUnit(v.fd == -1);
+      assertUnit(v.base == nullptr);
+   }  // teardown
+
+   // a copy has its own file
+   void test_constructCopy_ownFile()
+   {  // setup
+      custom::mapped_vector<int> vSrc{ 26, 49, 67 };
+      // exercise
+      custom::mapped_vector<int> vDest(vSrc);
+      vSrc[0] = 0;
+      // verify
+      assertUnit(vDest.size() == 3);
+      assertUnit(vDest[0] == 26);
+      assertUnit(vDest[2] == 67);
+      assertUnit(vDest.fd != vSrc.fd);
+   }  // teardown
+
+   // a moved-from vector starts over with a new temporary file
+   void test_constructMove_sourceUsable()
+   {  // setup
+      custom::mapped_vector<int> vSrc{ 26, 49 };
+      // exercise
+      custom::mapped_vector<int> vDest(std::move(vSrc));
+      vSrc.push_back(89);
+      // verify
+      assertUnit(vDest.size() == 2);
+      assertUnit(vDest[1] == 49);
+      assertUnit(vSrc.size() == 1);
+      assertUnit(vSrc[0] == 89);
+   }  // teardown
+
+   /***************************************
+    * INSERT
+    ***************************************/
+
+   // many pages' worth, the file growing under the elements
+   void test_pushback_grows()
+   {  // setup
+      custom::mapped_vector<long long> v;
+      bool right = true;
+      // exercise
+      for (long long i = 0; i < 100000; i++)
+         v.push_back(i * 3);
+      for (long long i = 0; i < 100000; i++)
+         right = right && v[i] == i * 3;
+      // verify
+      assertUnit(right);
+      assertUnit(v.size() == 100000);
+      assertUnit(v.capacity() >= 100000);
+      assertUnit(v.numBytes % v.pageSize() == 0);
+   }  // teardown
+
+   /***************************************
+    * FILE
+    ***************************************/
+
+   // what was written is there when the file is opened again
+   void test_file_reopen()
+   {  // setup
+      std::string path = tempPath("reopen");
+      {
+         custom::mapped_vector<int> v(path);
+         for (int i = 0; i < 5000; i++)
+            v.push_back(i);
+         v.sync();
+      }
+      // exercise
+      custom::mapped_vector<int> v(path);
+      // verify
+      assertUnit(v.size() == 5000);
+      assertUnit(v[0] == 0);
+      assertUnit(v[4999] == 4999);
+      // teardown
+      std::remove(path.c_str());
+   }
+
+   // a file of doubles is not a vector of ints
+   void test_file_wrongType()
+   {  // setup
+      std::string path = tempPath("type");
+      {
+         custom::mapped_vector<double> v(path);
+         v.push_back(2.6);
+      }
+      bool thrown = false;
+      // exercise
+      try
+      {
+         custom::mapped_vector<char> v(path);
+      }
+      catch (const std::runtime_error &)
+      {
+         thrown = true;
+      }
+      // verify
+      assertUnit(thrown);
+      // teardown
+      std::remove(path.c_str());
+   }
+
+   // the file shrinks to the header and the pages in use
+   void test_file_shrinkToFit()
+   {  // setup
+      custom::mapped_vector<int> v;
+      v.reserve(100000);
+      v.push_back(26);
+      // exercise
+      v.shrink_to_fit();
+      // verify
+      struct stat st;
+      fstat(v.fd, &st);
+      assertUnit((size_t)st.st_size == 2 * v.pageSize());
+      assertUnit(v.size() == 1);
+      assertUnit(v[0] == 26);
+   }  // teardown
+
+   // advice is only a hint
+   void test_advise_keepsElements()
+   {  // setup
+      custom::mapped_vector<int> v{ 26, 49, 67 };
+      // exercise
+      v.advise(custom::mapped_vector<int>::advice::random);
+      v.advise(custom::mapped_vector<int>::advice::willneed);
+      v.push_back(89);
+      v.advise(custom::mapped_vector<int>::advice::sequential);
+      // verify
+      assertUnit(v.size() == 4);
+      assertUnit(v[0] == 26);
+      assertUnit(v[3] == 89);
+      assertUnit(v.hint == custom::mapped_vector<int>::advice::sequential);
+   }  // teardown
+
+   /***************************************
+    * PRIORITY QUEUE
+    ***************************************/
+
+   // a priority queue works on top of a file
+   void test_pqueue_pushPop()
+   {  // setup
+      custom::priority_queue<int, custom::mapped_vector<int>> pq;
+      bool sorted = true;
+      // exercise
+      for (int i = 0; i < 3000; i++)
+         pq.push((i * 7) % 3000);
+      for (int i = 2999; i >= 0; i--)
+         sorted = sorted && pq.pop_top() == i;
+      // verify
+      assertUnit(sorted);
+      assertUnit(pq.empty());
+   }  // teardown
+
+   // a file name of our own in /tmp
+   static std::string tempPath(const char * name)
+   {
+      return "/tmp/testMappedVector." + std::to_string(getpid()) + "." + name;
+   }
+};
+
+#endif // CUSTOM_HAS_MMAP
+#endif // DEBUG
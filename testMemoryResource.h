@@ -0,0 +1,253 @@
+/***********************************************************************
+ * Header:
+ *    TEST MEMORY RESOURCE
+ * Summary:
+ *    Unit tests for the arena and pool memory resources
+ * Author
+ *    Stephen Costigan, Alexander Dohms, Jonathan Colwell, Shaun Crook
+ ************************************************************************/
+
+#pragma once
+
+#ifdef DEBUG
+
+#include "memory_resource.h"   // class under test
+#include "priority_queue.h"    // for pmr::priority_queue
+#include "vector.h"            // for pmr::vector
+#include "unitTest.h"          // unit test baseclass
+
+#include <cstdint>             // for uintptr_t
+#include <thread>              // for std::thread
+
+/***********************************************
+ * COUNTING RESOURCE
+ * Forward to new/delete and count the calls
+ ***********************************************/
+class CountingResource : public std::pmr::memory_resource
+{
+public:
+   CountingResource() : numAllocate(0), numDeallocate(0) {}
+   int numAllocate;
+   int numDeallocate;
+
+protected:
+   void * do_allocate(size_t bytes, size_t alignment) override
+   {
+      numAllocate++;
+      return std::pmr::new_delete_resource()->allocate(bytes, alignment);
+   }
+   void do_deallocate(void * p, size_t bytes, size_t alignment) override
+   {
+      numDeallocate++;
+      std::pmr::new_delete_resource()->deallocate(p, bytes, alignment);
+   }
+   bool do_is_equal(const std::pmr::memory_resource & rhs) const noexcept override
+   {
+      return this == &rhs;
+   }
+};
+
+/***********************************************
+ * TEST MEMORY RESOURCE
+ * Unit tests for arena_resource and pool_resource
+ ***********************************************/
+class TestMemoryResource : public UnitTest
+{
+public:
+   void run()
+   {
+      reset();
+
+      // Arena
+      test_arena_bump();
+      test_arena_aligned();
+      test_arena_grow();
+      test_arena_resetKeepsChunk();
+      test_arena_vector();
+
+      // Pool
+      test_pool_sizeClass();
+      test_pool_reuse();
+      test_pool_large();
+      test_pool_threadLocal();
+      test_pool_priorityQueue();
+
+      report("Memory");
+   }
+
+   /***************************************
+    * ARENA
+    ***************************************/
+
+   // two allocations sit next to each other in the caller's buffer
+   void test_arena_bump()
+   {  // setup
+      alignas(16) char buffer[256];
+      CountingResource upstream;
+      custom::pmr::arena_resource arena(buffer, sizeof(buffer), &upstream);
+      // exercise
+      char * p1 = (char *)arena.allocate(16, 8);
+      char * p2 = (char *)arena.allocate(16, 8);
+      // verify
+      assertUnit(p1 == buffer);
+      assertUnit(p2 == buffer + 16);
+      assertUnit(arena.bytes_allocated() == 32);
+      assertUnit(upstream.numAllocate == 0);
+   }  // teardown
+
+   // the pointer is bumped up to the requested alignment
+   void test_arena_aligned()
+   {  // setup
+      alignas(64) char buffer[256];
+      custom::pmr::arena_resource arena(buffer, sizeof(buffer));
+      // exercise
+      char * p1 = (char *)arena.allocate(1, 1);
+      char * p2 = (char *)arena.allocate(8, 64);
+      // verify
+      assertUnit(p1 == buffer);
+      assertUnit(p2 == buffer + 64);
+      assertUnit((uintptr_t)p2 % 64 == 0);
+   }  // teardown
+
+   // running out of the buffer gets a chunk from upstream
+   void test_arena_grow()
+   {  // setup
+      alignas(16) char buffer[64];
+      CountingResource upstream;
+      // exercise
+      {
+         custom::pmr::arena_resource arena(buffer, sizeof(buffer), &upstream);
+         char * p0 = (char *)arena.allocate(48, 8);
+         char * p = (char *)arena.allocate(48, 8);
+         // verify
+         assertUnit(p0 == buffer);
+         assertUnit(p < buffer || p >= buffer + sizeof(buffer));
+         assertUnit(upstream.numAllocate == 1);
+         assertUnit(arena.bytes_reserved() >= 48);
+      }
+      assertUnit(upstream.numDeallocate == 1);
+   }  // teardown
+
+   // reset() rewinds to the start of the biggest chunk and frees the rest
+   void test_arena_resetKeepsChunk()
+   {  // setup
+      CountingResource upstream;
+      custom::pmr::arena_resource arena(64, &upstream);
+      void * p1 = arena.allocate(40, 8);
+      void * p2 = arena.allocate(40, 8);
+      void * p3 = arena.allocate(40, 8);
+      int numAllocate = upstream.numAllocate;
+      // exercise
+      arena.reset();
+      // verify
+      assertUnit(p1 != p2 && p2 != p3);
+      assertUnit(numAllocate == 2);
+      assertUnit(upstream.numDeallocate == 1);
+      assertUnit(arena.bytes_allocated() == 0);
+      assertUnit(arena.allocate(40, 8) < p3);
+      assertUnit(upstream.numAllocate == 2);
+   }  // teardown
+
+   // a vector grows inside the arena
+   void test_arena_vector()
+   {  // setup
+      alignas(16) char buffer[1024];
+      CountingResource upstream;
+      custom::pmr::arena_resource arena(buffer, sizeof(buffer), &upstream);
+      custom::pmr::vector<int> v(&arena);
+      // exercise
+      for (int i = 0; i < 100; i++)
+         v.push_back(i);
+      // verify
+      assertUnit(v.size() == 100);
+      assertUnit(v[99] == 99);
+      assertUnit((char *)&v[0] >= buffer);
+      assertUnit((char *)&v[99] < buffer + sizeof(buffer));
+      assertUnit(upstream.numAllocate == 0);
+   }  // teardown
+
+   /***************************************
+    * POOL
+    ***************************************/
+
+   // sizes round up to the next power of two, big ones have no class
+   void test_pool_sizeClass()
+   {  // setup
+      // exercise
+      // verify
+      assertUnit(custom::pmr::pool_resource::classOf(1, 1) == 0);
+      assertUnit(custom::pmr::pool_resource::classOf(8, 8) == 0);
+      assertUnit(custom::pmr::pool_resource::classOf(9, 8) == 1);
+      assertUnit(custom::pmr::pool_resource::classOf(24, 8) == 2);
+      assertUnit(custom::pmr::pool_resource::classOf(8, 16) == 1);
+      assertUnit(custom::pmr::pool_resource::classOf(4096, 8) == 9);
+      assertUnit(custom::pmr::pool_resource::classOf(4097, 8) == custom::pmr::pool_resource::numClasses);
+   }  // teardown
+
+   // a freed block goes to the next request of the same class
+   void test_pool_reuse()
+   {  // setup
+      CountingResource upstream;
+      custom::pmr::pool_resource pool(&upstream);
+      void * p1 = pool.allocate(100, 8);
+      // exercise
+      pool.deallocate(p1, 100, 8);
+      void * p2 = pool.allocate(128, 8);
+      void * p3 = pool.allocate(64, 8);
+      // verify
+      assertUnit(p1 == p2);
+      assertUnit(p3 != p1);
+      assertUnit((uintptr_t)p2 % alignof(std::max_align_t) == 0);
+      assertUnit(upstream.numAllocate == 2);   // one chunk per class
+   }  // teardown
+
+   // anything over 4K is not pooled
+   void test_pool_large()
+   {  // setup
+      CountingResource upstream;
+      custom::pmr::pool_resource pool(&upstream);
+      // exercise
+      void * p = pool.allocate(10000, 8);
+      pool.deallocate(p, 10000, 8);
+      // verify
+      assertUnit(upstream.numAllocate == 1);
+      assertUnit(upstream.numDeallocate == 1);
+      assertUnit(pool.bytes_reserved() == 0);
+   }  // teardown
+
+   // every thread gets its own pool
+   void test_pool_threadLocal()
+   {  // setup
+      custom::pmr::pool_resource * mine = custom::pmr::thread_local_pool();
+      custom::pmr::pool_resource * theirs = nullptr;
+      // exercise
+      std::thread t([&]() { theirs = custom::pmr::thread_local_pool(); });
+      t.join();
+      // verify
+      assertUnit(mine == custom::pmr::thread_local_pool());
+      assertUnit(mine != theirs);
+   }  // teardown
+
+   // a priority queue reuses the blocks it gave back while growing
+   void test_pool_priorityQueue()
+   {  // setup
+      CountingResource upstream;
+      custom::pmr::pool_resource pool(&upstream);
+      // exercise
+      {
+         custom::pmr::priority_queue<int> pq(&pool);
+         for (int i = 0; i < 100; i++)
+            pq.push(i);
+         // verify
+         assertUnit(pq.top() == 99);
+      }
+      {
+         custom::pmr::priority_queue<int> pq(&pool);
+         for (int i = 0; i < 100; i++)
+            pq.push(i);
+      }
+      assertUnit(upstream.numAllocate == 7);   // 8, 16, 32 ... 512 bytes
+   }  // teardown
+};
+
+#endif // DEBUG
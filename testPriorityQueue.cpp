@@ -14,22 +14,64 @@
 #define DEBUG   // Remove this to skip the unit tests
 #endif // DEBUG
 
+#define TRACK_ALLOCATIONS // replace operator new for AllocationScope
+
 #include "testPriorityQueue.h"  // for the priority queue unit tests
 #include "testSpy.h"            // for the spy unit tests
 #include "testVector.h"         // for the vector unit tests
-int Spy::counters[] = {};
+#include "testLatency.h"        // for the latency histogram unit tests
+#include "testMemoryResource.h" // for the memory resource unit tests
+#include "testGrowth.h"         // for the growth policy unit tests
+#include "testSmallVector.h"    // for the small vector unit tests
+#include "testSimd.h"           // for the simd algorithm unit tests
+#include "testCowVector.h"      // for the copy-on-write vector unit tests
+#include "testSegmentedVector.h" // for the segmented vector unit tests
+#include "testMappedVector.h"   // for the mapped vector unit tests
+#include "testConcurrentVector.h" // for the concurrent vector unit tests
+#include "testComplexity.h"     // for the asymptotic cost checks
+#include "testAllocationScope.h" // for the allocation counts and budgets
+#include "testUnitTest.h"       // for the timing checks of UnitTest itself
 
 /**********************************************************************
  * MAIN
- * This is just a simple menu to launch a collection of tests
+ * This is just a simple menu to launch a collection of tests.
+ * The suites run at the same time, one per worker, unless this is
+ * run with --serial. TestSpy counts across every thread and switches
+ * Spy to ATOMIC mode, so it runs first, alone. TestUnitTest times
+ * code, so it runs alone too.
  ***********************************************************************/
-int main()
+int main(int argc, char ** argv)
 {
 #ifdef DEBUG
-   // unit tests
+   bool serial = argc > 1 && std::string(argv[1]) == "--serial";
+
+   // checks Spy::total(), which every thread adds to
    TestSpy().run();
-   TestVector().run();
-   TestPQueue().run();
+
+   // compares timings, which other suites running would disturb
+   TestUnitTest().run();
+
+   {
+      custom::thread_pool pool(serial ? 1 : custom::thread_pool::defaultConcurrency());
+
+      // unit tests
+      pool.submit([]() { TestVector().run();           });
+      pool.submit([]() { TestPQueue().run();           });
+      pool.submit([]() { TestLatency().run();          });
+      pool.submit([]() { TestMemoryResource().run();   });
+      pool.submit([]() { TestGrowth().run();           });
+      pool.submit([]() { TestSmallVector().run();      });
+      pool.submit([]() { TestSimd().run();             });
+      pool.submit([]() { TestCowVector().run();        });
+      pool.submit([]() { TestSegmentedVector().run();  });
+#ifdef CUSTOM_HAS_MMAP
+      pool.submit([]() { TestMappedVector().run();     });
+#endif
+      pool.submit([]() { TestConcurrentVector().run(); });
+      pool.submit([]() { TestComplexity().run();       });
+      pool.submit([]() { TestAllocationScope().run();  });
+      pool.wait();
+   }
 #endif // DEBUG
    
    return 0;
@@ -17,6 +17,7 @@
 
 #include <cassert>
 #include <memory>
+#include <memory_resource>   // for std::pmr
 
 
 class TestPQueue : public UnitTest
@@ -67,6 +68,13 @@ public:
         test_pop_one();
         test_pop_two();
         test_pop_standard();
+        test_popTop_empty();
+        test_popTop_standard();
+
+        // Move
+        test_move_pushSpy();
+        test_move_emplaceSpy();
+        test_move_popTopSpy();
 
         // Status
         test_size_empty();
@@ -78,6 +86,17 @@ public:
         test_percolateDown_nothing();
         test_percolateDown_oneLevel();
         test_percolateDown_twoLevels();
+        test_heapify_standard();
+        test_rebuild_parallelMatchesSerial();
+        test_constructBulk_parallel();
+
+        // Instrument
+        test_stats_push();
+        test_stats_rebuildParallel();
+
+        // Allocator
+        test_allocator_pmr();
+
 
         report("PQueue");
     }
@@ -126,7 +145,7 @@ public:
         // exercise
         custom::priority_queue<int> pqDest(pqSrc);
         // verify
-        assertUnit(pqSrc.container.data != pqDest.container.data);
+        assertUnit(pqSrc.container.buffer != pqDest.container.buffer);
         //  +---+---+---+---+---+---+---+---+---+
         //  | 10| 8 | 9 | 4 | 3 | 7 | 5 |   |   |
         //  +---+---+---+---+---+---+---+---+---+
@@ -594,7 +613,267 @@ public:
         teardownStandardFixture(pq);
     }
 
+    // heapify a sorted container
+    void test_heapify_standard()
+    {  // setup
+       //    1   2   3   4   5   6   7
+       //  +---+---+---+---+---+---+---+
+       //  | 3 | 4 | 5 | 7 | 8 | 9 | 10|
+       //  +---+---+---+---+---+---+---+
+        custom::priority_queue <int> pq;
+        pq.container = { int(3), int(4), int(5), int(7), int(8), int(9), int(10) };
+        // exercise
+        pq.rebuild();
+        // verify
+        //    1   2   3   4   5   6   7
+        //  +---+---+---+---+---+---+---+
+        //  | 10| 8 | 9 | 7 | 4 | 3 | 5 |
+        //  +---+---+---+---+---+---+---+
+        //               10
+        //         8            9
+        //      7     4      3     5
+        assertUnit(pq.container.size() == 7);
+        if (pq.container.size() == 7)
+        {
+            assertUnit(pq.container[0] == int(10));
+            assertUnit(pq.container[1] == int(8));
+            assertUnit(pq.container[2] == int(9));
+            assertUnit(pq.container[3] == int(7));
+            assertUnit(pq.container[4] == int(4));
+            assertUnit(pq.container[5] == int(3));
+            assertUnit(pq.container[6] == int(5));
+        }
+        // teardown
+        teardownStandardFixture(pq);
+    }
 
+    // the parallel heapify does the same percolates as the serial one
+    void test_rebuild_parallelMatchesSerial()
+    {  // setup
+        const size_t num = 100000;
+        custom::priority_queue <int> pqSerial;
+        custom::priority_queue <int> pqParallel;
+        for (size_t i = 0; i < num; i++)
+        {
+            int value = int((i * 7919) % num);
+            pqSerial.container.push_back(value);
+            pqParallel.container.push_back(value);
+        }
+        // exercise
+        pqSerial.rebuild();
+        pqParallel.rebuild(custom::execution::par.threads(4));
+        // verify
+        bool same = pqSerial.container.size() == pqParallel.container.size();
+        for (size_t i = 0; same && i < num; i++)
+            same = pqSerial.container[i] == pqParallel.container[i];
+        assertUnit(same);
+        // teardown
+        teardownStandardFixture(pqSerial);
+        teardownStandardFixture(pqParallel);
+    }
+
+    // build a heap from a loaded vector on several threads
+    void test_constructBulk_parallel()
+    {  // setup
+        const size_t num = 100000;
+        custom::vector <int> v;
+        for (size_t i = 0; i < num; i++)
+            v.push_back(int(i));
+        // exercise
+        custom::priority_queue <int> pq(custom::execution::par.threads(4), std::move(v));
+        // verify
+        assertUnit(v.size() == 0);
+        assertUnit(pq.size() == num);
+        assertUnit(pq.top() == int(num - 1));
+        bool isHeap = true;
+        for (size_t i = 1; isHeap && i < pq.container.size(); i++)
+            isHeap = !(pq.container[(i - 1) / 2] < pq.container[i]);
+        assertUnit(isHeap);
+        // teardown
+        teardownStandardFixture(pq);
+    }
+
+
+
+    /***************************************
+     * POP TOP
+     ***************************************/
+
+     // pop_top of an empty priority queue throws
+    void test_popTop_empty()
+    {  // setup
+        custom::priority_queue <int> pq;
+        bool threw = false;
+        // exercise
+        try
+        {
+            pq.pop_top();
+        }
+        catch (const char *)
+        {
+            threw = true;
+        }
+        // verify
+        assertUnit(threw);
+        assertEmptyFixture(pq);
+    }  // teardown
+
+    // pop_top returns what top() was and leaves what pop() would
+    void test_popTop_standard()
+    {  // setup
+       //  +---+---+---+---+---+---+---+---+---+
+       //  | 10| 8 | 9 | 4 | 3 | 7 | 5 |   |   |
+       //  +---+---+---+---+---+---+---+---+---+
+        custom::priority_queue <int> pq;
+        setupStandardFixture(pq);
+        // exercise
+        int top = pq.pop_top();
+        // verify
+        //  +---+---+---+---+---+---+---+---+---+
+        //  | 9 | 8 | 7 | 4 | 3 | 5 |   |   |   |
+        //  +---+---+---+---+---+---+---+---+---+
+        assertUnit(top == int(10));
+        assertUnit(pq.container.size() == 6);
+        if (pq.container.size() == 6)
+        {
+            assertUnit(pq.container[0] == int(9));
+            assertUnit(pq.container[2] == int(7));
+            assertUnit(pq.container[5] == int(5));
+        }
+    }  // teardown
+
+    /***************************************
+     * MOVE
+     * An rvalue goes into the heap and back out
+     * without ever being copied
+     ***************************************/
+
+    // push an rvalue, growing the container on the way
+    void test_move_pushSpy()
+    {  // setup
+        custom::priority_queue <Spy> pq;
+        Spy::reset();
+        // exercise
+        for (int i = 0; i < 10; i++)
+            pq.push(Spy(i));
+        // verify
+        assertUnit(pq.size() == 10);
+        assertUnit(pq.top().get() == 9);
+        assertUnit(Spy::numCopy() == 0);
+        assertUnit(Spy::numAssign() == 0);
+    }  // teardown
+
+    // emplace builds the element inside the container
+    void test_move_emplaceSpy()
+    {  // setup
+        custom::priority_queue <Spy> pq;
+        pq.container.reserve(4);
+        Spy::reset();
+        // exercise
+        pq.emplace(4);
+        pq.emplace(10);
+        // verify
+        assertUnit(pq.top().get() == 10);
+        assertUnit(Spy::numNondefault() == 2);
+        assertUnit(Spy::numCopy() == 0);
+    }  // teardown
+
+    // pop_top moves the top out
+    void test_move_popTopSpy()
+    {  // setup
+        custom::priority_queue <Spy> pq;
+        for (int i = 0; i < 10; i++)
+            pq.push(Spy(i));
+        Spy::reset();
+        // exercise
+        Spy s = pq.pop_top();
+        // verify
+        assertUnit(s.get() == 9);
+        assertUnit(pq.top().get() == 8);
+        assertUnit(Spy::numCopy() == 0);
+        assertUnit(Spy::numAssign() == 0);
+    }  // teardown
+
+    /***************************************
+     * INSTRUMENT
+     ***************************************/
+
+     // count the work done by pushing 11 onto the standard fixture
+    void test_stats_push()
+    {  // setup
+       //  +---+---+---+---+---+---+---+---+---+
+       //  | 10| 8 | 9 | 4 | 3 | 7 | 5 |   |   |
+       //  +---+---+---+---+---+---+---+---+---+
+        custom::priority_queue <int, custom::instrument::counting> pq;
+        pq.container = { int(10), int(8), int(9), int(4), int(3), int(7), int(5) };
+        pq.container.reserve(9);
+        pq.reset_stats();
+        // exercise
+        pq.push(int(11));
+        // verify
+        //  +---+---+---+---+---+---+---+---+---+
+        //  | 11| 10| 9 | 8 | 3 | 7 | 5 | 4 |   |
+        //  +---+---+---+---+---+---+---+---+---+
+        //    11 rose three levels: three swaps plus the push_back
+        custom::instrument_stats stats = pq.stats();
+        assertUnit(stats.siftLevels == 3);
+        assertUnit(stats.compares == 8);
+        assertUnit(stats.moves == 3 * 3 + 1);
+        assertUnit(stats.reallocations == 0);
+        assertUnit(pq.top() == int(11));
+    }  // teardown
+
+    // the workers of a parallel heapify count into the same stats,
+    // and miss nothing: they do the same percolates as the serial one
+    void test_stats_rebuildParallel()
+    {  // setup
+        const size_t num = 100000;
+        custom::priority_queue <int, custom::vector<int>, custom::instrument::counting> pqSerial;
+        custom::priority_queue <int, custom::vector<int>, custom::instrument::counting> pqParallel;
+        for (size_t i = 0; i < num; i++)
+        {
+            int value = int((i * 7919) % num);
+            pqSerial.container.push_back(value);
+            pqParallel.container.push_back(value);
+        }
+        pqSerial.reset_stats();
+        pqParallel.reset_stats();
+        // exercise
+        pqSerial.rebuild();
+        pqParallel.rebuild(custom::execution::par.threads(4));
+        // verify
+        custom::instrument_stats serial = pqSerial.stats();
+        custom::instrument_stats parallel = pqParallel.stats();
+        assertUnit(serial.compares > 0);
+        assertUnit(parallel.compares == serial.compares);
+        assertUnit(parallel.siftLevels == serial.siftLevels);
+        assertUnit(parallel.moves == serial.moves);
+        assertUnit(parallel.reallocations == 0);
+    }  // teardown
+
+    /***************************************
+     * ALLOCATOR
+     ***************************************/
+
+     // the heap grows inside the memory resource it was given
+    void test_allocator_pmr()
+    {  // setup
+        char buffer[1024];
+        std::pmr::monotonic_buffer_resource arena(buffer, sizeof(buffer),
+                                                  std::pmr::null_memory_resource());
+        typedef custom::vector <int, std::pmr::polymorphic_allocator<int>> Container;
+        std::pmr::polymorphic_allocator<int> alloc(&arena);
+        custom::priority_queue <int, Container> pq(alloc);
+        // exercise
+        pq.push(int(4));
+        pq.push(int(10));
+        pq.push(int(8));
+        // verify
+        assertUnit(pq.top() == int(10));
+        assertUnit(pq.container.get_allocator().resource() == &arena);
+        assertUnit((char *)&pq.container[0] >= buffer);
+        assertUnit((char *)&pq.container[0] < buffer + sizeof(buffer));
+    }  // teardown
 
     /***************************************
      * TOP
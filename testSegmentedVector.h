@@ -0,0 +1,255 @@
+/***********************************************************************
+ * Header:
+ *    TEST SEGMENTED VECTOR
+ * Summary:
+ *    Unit tests for segmented_vector
+ * Author
+ *    Stephen Costigan, Alexander Dohms, Jonathan Colwell, Shaun Crook
+ ************************************************************************/
+
+#pragma once
+
+#ifdef DEBUG
+
+#include "segmented_vector.h" // class under test
+#include "priority_queue.h"   // for a priority_queue on a segmented_vector
+#include "unitTest.h"         // unit test baseclass
+#include "spy.h"
+
+#include <algorithm>          // for std::sort
+
+/***********************************************
+ * TEST SEGMENTED VECTOR
+ * Unit tests for the segmented_vector class
+ ***********************************************/
+class TestSegmentedVector : public UnitTest
+{
+public:
+   void run()
+   {
+      reset();
+
+      // Construct
+      test_construct_default();
+      test_constructCopy_standard();
+
+      // Insert
+      test_pushback_addsChunk();
+      test_pushback_neverRelocates();
+      test_pushback_stableAddress();
+      test_pushback_aliasFull();
+
+      // Remove
+      test_popback_keepsOneSpare();
+      test_shrinkToFit();
+      test_destructor_spy();
+
+      // Iterator
+      test_iterator_acrossChunks();
+      test_iterator_sort();
+
+      // Priority queue
+      test_pqueue_pushPop();
+
+      report("SegmentedVector");
+   }
+
+   /***************************************
+    * CONSTRUCT
+    ***************************************/
+
+   // no chunks until the first element
+   void test_construct_default()
+   {  // setup
+      // exercise
+      custom::segmented_vector<int, 4> v;
+      // verify
+      assertUnit(v.empty());
+      assertUnit(v.capacity() == 0);
+      assertUnit(v.chunks.size() == 0);
+      assertUnit(custom::segmented_vector<int>::chunk_size() == 1024);
+   }  // teardown
+
+   // a copy has its own chunks
+   void test_constructCopy_standard()
+   {  // setup
+      custom::segmented_vector<int, 4> vSrc{ 26, 49, 67, 89, 99 };
+      // exercise
+      custom::segmented_vector<int, 4> vDest(vSrc);
+      vSrc[4] = 0;
+      // verify
+      assertUnit(vDest.size() == 5);
+      assertUnit(vDest[4] == 99);
+      assertUnit(vDest.chunks[1] != vSrc.chunks[1]);
+   }  // teardown
+
+   /***************************************
+    * INSERT
+    ***************************************/
+
+   // the fifth element of a 4-element chunk starts a second chunk
+   void test_pushback_addsChunk()
+   {  // setup
+      custom::segmented_vector<int, 4> v{ 26, 49, 67, 89 };
+      int * pChunk = v.chunks[0];
+      // exercise
+      v.push_back(99);
+      // verify
+      assertUnit(v.size() == 5);
+      assertUnit(v.capacity() == 8);
+      assertUnit(v.chunks.size() == 2);
+      assertUnit(v.chunks[0] == pChunk);
+      assertUnit(v.chunks[1][0] == 99);
+   }  // teardown
+
+   // every element is moved once, into place, and never again
+   void test_pushback_neverRelocates()
+   {  // setup
+      custom::segmented_vector<Spy, 4> v;
+      Spy::reset();
+      // exercise
+      for (int i = 0; i < 20; i++)
+         v.push_back(Spy(i));
+      // verify
+      assertUnit(Spy::numCopyMove() == 20);
+      assertUnit(Spy::numCopy() == 0);
+      assertUnit(v[19].get() == 19);
+   }  // teardown
+
+   // a pointer to an element outlives many more push_back()s
+   void test_pushback_stableAddress()
+   {  // setup
+      custom::segmented_vector<int, 4> v{ 26 };
+      int * p = &v[0];
+      // exercise
+      for (int i = 0; i < 100; i++)
+         v.push_back(i);
+      // verify
+      assertUnit(&v[0] == p);
+      assertUnit(*p == 26);
+      assertUnit(v.size() == 101);
+   }  // teardown
+
+   // copying one of our own elements as we add a chunk
+   void test_pushback_aliasFull()
+   {  // setup
+      custom::segmented_vector<Spy, 2> v;
+      v.push_back(Spy(26));
+      v.push_back(Spy(49));
+      // exercise
+      v.push_back(v[0]);
+      // verify
+      assertUnit(v.size() == 3);
+      assertUnit(v[2].get() == 26);
+      assertUnit(v[0].get() == 26);
+   }  // teardown
+
+   /***************************************
+    * REMOVE
+    ***************************************/
+
+   // emptying a chunk keeps it; emptying a second one frees the spare
+   void test_popback_keepsOneSpare()
+   {  // setup
+      custom::segmented_vector<int, 4> v;
+      for (int i = 0; i < 12; i++)
+         v.push_back(i);
+      // exercise
+      while (v.size() > 4)
+         v.pop_back();
+      // verify
+      assertUnit(v.size() == 4);
+      assertUnit(v.capacity() == 8);
+      assertUnit(v.back() == 3);
+   }  // teardown
+
+   // only the chunks that hold elements are left
+   void test_shrinkToFit()
+   {  // setup
+      custom::segmented_vector<int, 4> v;
+      v.reserve(20);
+      v.push_back(26);
+      v.push_back(49);
+      // exercise
+      v.shrink_to_fit();
+      // verify
+      assertUnit(v.capacity() == 4);
+      assertUnit(v.chunks.size() == 1);
+      assertUnit(v[1] == 49);
+   }  // teardown
+
+   // every element is destroyed once
+   void test_destructor_spy()
+   {  // setup
+      Spy::reset();
+      {
+         custom::segmented_vector<Spy, 4> v;
+         for (int i = 0; i < 10; i++)
+            v.push_back(Spy(i));
+         v.pop_back();
+         // exercise
+      }
+      // verify
+      assertUnit(Spy::numNondefault() + Spy::numCopy() + Spy::numCopyMove() == Spy::numDestructor());
+      assertUnit(Spy::numAlloc() == Spy::numDelete());
+   }  // teardown
+
+   /***************************************
+    * ITERATOR
+    ***************************************/
+
+   // arithmetic crosses from one chunk to the next
+   void test_iterator_acrossChunks()
+   {  // setup
+      custom::segmented_vector<int, 4> v;
+      for (int i = 0; i < 10; i++)
+         v.push_back(i * 10);
+      // exercise
+      custom::segmented_vector<int, 4>::iterator it = v.begin() + 3;
+      ++it;
+      custom::segmented_vector<int, 4>::const_iterator itConst = it + 5;
+      // verify
+      assertUnit(*it == 40);
+      assertUnit(*itConst == 90);
+      assertUnit(itConst - it == 5);
+      assertUnit(it[-1] == 30);
+      assertUnit(v.end() - v.begin() == 10);
+      assertUnit(it < itConst);
+   }  // teardown
+
+   // std::sort needs random access
+   void test_iterator_sort()
+   {  // setup
+      custom::segmented_vector<int, 4> v;
+      for (int i = 0; i < 13; i++)
+         v.push_back((i * 5) % 13);
+      // exercise
+      std::sort(v.begin(), v.end());
+      // verify
+      bool sorted = true;
+      for (int i = 0; i < 13; i++)
+         sorted = sorted && v[i] == i;
+      assertUnit(sorted);
+   }  // teardown
+
+   /***************************************
+    * PRIORITY QUEUE
+    ***************************************/
+
+   // a priority queue works on top of chunks
+   void test_pqueue_pushPop()
+   {  // setup
+      custom::priority_queue<int, custom::segmented_vector<int, 4>> pq;
+      bool sorted = true;
+      // exercise
+      for (int i = 0; i < 30; i++)
+         pq.push((i * 7) % 30);
+      for (int i = 29; i >= 0; i--)
+         sorted = sorted && pq.pop_top() == i;
+      // verify
+      assertUnit(sorted);
+      assertUnit(pq.empty());
+   }  // teardown
+};
+
+#endif // DEBUG
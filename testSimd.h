@@ -0,0 +1,280 @@
+/***********************************************************************
+ * Header:
+ *    TEST SIMD
+ * Summary:
+ *    Unit tests for the bulk algorithms. Every test runs once for each
+ *    instruction set this CPU has, so the vector kernels and the plain
+ *    loops must agree.
+ * Author
+ *    Stephen Costigan, Alexander Dohms, Jonathan Colwell, Shaun Crook
+ ************************************************************************/
+
+#pragma once
+
+#ifdef DEBUG
+
+#include "simd.h"       // class under test
+#include "vector.h"
+#include "unitTest.h"   // unit test baseclass
+
+#include <cstdint>      // for uint64_t
+
+/***********************************************
+ * TEST SIMD
+ * Unit tests for custom::simd
+ ***********************************************/
+class TestSimd : public UnitTest
+{
+public:
+   void run()
+   {
+      reset();
+
+      // Level
+      test_level_clamped();
+
+      // Find
+      test_find_everyPosition();
+      test_find_missing();
+      test_find_otherType();
+      test_count_int();
+
+      // Min and max
+      test_minMax_int();
+      test_minMax_uint64();
+      test_argmax_firstOfTies();
+
+      // Sum and fill
+      test_sum_int();
+      test_sum_double();
+      test_fill_float();
+
+      // Empty
+      test_vector_empty();
+
+      custom::simd::set_level(custom::simd::supported());
+      report("Simd");
+   }
+
+   /***************************************
+    * LEVEL
+    ***************************************/
+
+   // we can go down but not up past the CPU
+   void test_level_clamped()
+   {  // setup
+      // exercise
+      custom::simd::set_level(custom::simd::isa::avx2);
+      custom::simd::isa best = custom::simd::level();
+      custom::simd::set_level(custom::simd::isa::scalar);
+      // verify
+      assertUnit(best == custom::simd::supported());
+      assertUnit(custom::simd::level() == custom::simd::isa::scalar);
+      assertUnit(custom::simd::level_for<int>() == custom::simd::isa::scalar);
+      // teardown
+      custom::simd::set_level(custom::simd::supported());
+   }
+
+   /***************************************
+    * FIND
+    ***************************************/
+
+   // the key in every position of every length up to three registers
+   void test_find_everyPosition()
+   {  // setup
+      bool found = true;
+      // exercise
+      for (int l = 0; l <= (int)custom::simd::supported(); l++)
+      {
+         custom::simd::set_level(custom::simd::isa(l));
+         for (int size = 1; size <= 24; size++)
+            for (int pos = 0; pos < size; pos++)
+            {
+               custom::vector<int> v(size, 7);
+               v[pos] = 26;
+               found = found && custom::simd::find(v, 26) - v.begin() == pos;
+            }
+      }
+      // verify
+      assertUnit(found);
+   }  // teardown
+
+   // not there: end()
+   void test_find_missing()
+   {  // setup
+      custom::vector<double> v{ 2.6, 4.9, 6.7, 8.9, 2.6, 4.9, 6.7, 8.9, 2.6 };
+      bool missing = true;
+      // exercise
+      for (int l = 0; l <= (int)custom::simd::supported(); l++)
+      {
+         custom::simd::set_level(custom::simd::isa(l));
+         missing = missing && custom::simd::find(v, 9.9) == v.end();
+      }
+      // verify
+      assertUnit(missing);
+   }  // teardown
+
+   // a type without vector kernels still works
+   void test_find_otherType()
+   {  // setup
+      custom::vector<short> v{ 26, 49, 67, 89 };
+      // exercise
+      custom::vector<short>::const_iterator it = custom::simd::find(v, short(67));
+      // verify
+      assertUnit(it - v.begin() == 2);
+      assertUnit(custom::simd::level_for<short>() == custom::simd::isa::scalar);
+   }  // teardown
+
+   // every other element matches
+   void test_count_int()
+   {  // setup
+      custom::vector<int> v(21, 0);
+      for (size_t i = 0; i < v.size(); i += 2)
+         v[i] = 49;
+      bool right = true;
+      // exercise
+      for (int l = 0; l <= (int)custom::simd::supported(); l++)
+      {
+         custom::simd::set_level(custom::simd::isa(l));
+         right = right && custom::simd::count(v, 49) == 11;
+      }
+      // verify
+      assertUnit(right);
+   }  // teardown
+
+   /***************************************
+    * MIN AND MAX
+    ***************************************/
+
+   // negative numbers, with the extremes in the tail
+   void test_minMax_int()
+   {  // setup
+      custom::vector<int> v;
+      for (int i = 0; i < 19; i++)
+         v.push_back((i * 7) % 19 - 9);
+      v.push_back(-26);
+      v.push_back(89);
+      bool right = true;
+      // exercise
+      for (int l = 0; l <= (int)custom::simd::supported(); l++)
+      {
+         custom::simd::set_level(custom::simd::isa(l));
+         right = right && custom::simd::min(v) == -26 && custom::simd::max(v) == 89;
+      }
+      // verify
+      assertUnit(right);
+   }  // teardown
+
+   // past 2^63 an unsigned compare and a signed compare differ
+   void test_minMax_uint64()
+   {  // setup
+      custom::vector<uint64_t> v;
+      for (uint64_t i = 0; i < 9; i++)
+         v.push_back(i + 26);
+      v[3] = 0xFFFFFFFFFFFFFFF0ull;
+      bool right = true;
+      // exercise
+      for (int l = 0; l <= (int)custom::simd::supported(); l++)
+      {
+         custom::simd::set_level(custom::simd::isa(l));
+         right = right && custom::simd::max(v) == 0xFFFFFFFFFFFFFFF0ull &&
+                          custom::simd::min(v) == 26;
+      }
+      // verify
+      assertUnit(right);
+   }  // teardown
+
+   // argmax is the first of equal maxima
+   void test_argmax_firstOfTies()
+   {  // setup
+      custom::vector<float> v(17, 1.0f);
+      v[5] = 9.0f;
+      v[12] = 9.0f;
+      v[9] = -3.0f;
+      bool right = true;
+      // exercise
+      for (int l = 0; l <= (int)custom::simd::supported(); l++)
+      {
+         custom::simd::set_level(custom::simd::isa(l));
+         right = right && custom::simd::argmax(v) - v.begin() == 5 &&
+                          custom::simd::argmin(v) - v.begin() == 9;
+      }
+      // verify
+      assertUnit(right);
+   }  // teardown
+
+   /***************************************
+    * SUM AND FILL
+    ***************************************/
+
+   // 1 + 2 + ... + 100
+   void test_sum_int()
+   {  // setup
+      custom::vector<int> v;
+      for (int i = 1; i <= 100; i++)
+         v.push_back(i);
+      bool right = true;
+      // exercise
+      for (int l = 0; l <= (int)custom::simd::supported(); l++)
+      {
+         custom::simd::set_level(custom::simd::isa(l));
+         right = right && custom::simd::sum(v) == 5050;
+      }
+      // verify
+      assertUnit(right);
+   }  // teardown
+
+   // small whole numbers add exactly in any order
+   void test_sum_double()
+   {  // setup
+      custom::vector<double> v;
+      for (int i = 1; i <= 11; i++)
+         v.push_back(double(i));
+      bool right = true;
+      // exercise
+      for (int l = 0; l <= (int)custom::simd::supported(); l++)
+      {
+         custom::simd::set_level(custom::simd::isa(l));
+         right = right && custom::simd::sum(v) == 66.0;
+      }
+      // verify
+      assertUnit(right);
+   }  // teardown
+
+   // every element, including the tail
+   void test_fill_float()
+   {  // setup
+      custom::vector<float> v(13, 0.0f);
+      bool right = true;
+      // exercise
+      for (int l = 0; l <= (int)custom::simd::supported(); l++)
+      {
+         custom::simd::set_level(custom::simd::isa(l));
+         custom::simd::fill(v, float(l + 1));
+         for (size_t i = 0; i < v.size(); i++)
+            right = right && v[i] == float(l + 1);
+      }
+      // verify
+      assertUnit(right);
+   }  // teardown
+
+   /***************************************
+    * EMPTY
+    ***************************************/
+
+   // nothing to find, count, or add
+   void test_vector_empty()
+   {  // setup
+      custom::vector<int> v;
+      // exercise
+      // verify
+      assertUnit(custom::simd::find(v, 26) == v.end());
+      assertUnit(custom::simd::count(v, 26) == 0);
+      assertUnit(custom::simd::argmax(v) == v.end());
+      assertUnit(custom::simd::sum(v) == 0);
+      custom::simd::fill(v, 26);
+      assertUnit(v.empty());
+   }  // teardown
+};
+
+#endif // DEBUG
@@ -0,0 +1,223 @@
+/***********************************************************************
+ * Header:
+ *    TEST SMALL VECTOR
+ * Summary:
+ *    Unit tests for small_vector and small_priority_queue
+ * Author
+ *    Stephen Costigan, Alexander Dohms, Jonathan Colwell, Shaun Crook
+ ************************************************************************/
+
+#pragma once
+
+#ifdef DEBUG
+
+#include "small_vector.h"     // class under test
+#include "priority_queue.h"   // for small_priority_queue
+#include "unitTest.h"         // unit test baseclass
+#include "spy.h"
+
+/***********************************************
+ * TEST SMALL VECTOR
+ * Unit tests for the small_vector class
+ ***********************************************/
+class TestSmallVector : public UnitTest
+{
+public:
+   void run()
+   {
+      reset();
+
+      // Construct
+      test_construct_default();
+      test_constructCopy_inline();
+      test_constructMove_inline();
+      test_constructMove_heap();
+
+      // Insert
+      test_pushback_staysInline();
+      test_pushback_spills();
+      test_pushback_aliasWhileSpilling();
+
+      // Remove
+      test_destructor_spy();
+
+      // Assign
+      test_swap_inlineHeap();
+
+      // Priority queue
+      test_pqueue_pushPop();
+
+      report("SmallVector");
+   }
+
+   /***************************************
+    * CONSTRUCT
+    ***************************************/
+
+   // an empty small_vector already has its inline room
+   void test_construct_default()
+   {  // setup
+      // exercise
+      custom::small_vector<int, 4> v;
+      // verify
+      assertUnit(v.empty());
+      assertUnit(v.capacity() == 4);
+      assertUnit(v.is_inline());
+   }  // teardown
+
+   // a copy of an inline vector is inline too
+   void test_constructCopy_inline()
+   {  // setup
+      custom::small_vector<int, 4> vSrc{ 26, 49, 67 };
+      // exercise
+      custom::small_vector<int, 4> vDest(vSrc);
+      // verify
+      assertUnit(vDest.is_inline());
+      assertUnit(vDest.size() == 3);
+      assertUnit(vDest[2] == 67);
+      assertUnit(vDest.data != vSrc.data);
+   }  // teardown
+
+   // moving an inline vector has to move the elements themselves
+   void test_constructMove_inline()
+   {  // setup
+      custom::small_vector<Spy, 4> vSrc;
+      vSrc.push_back(Spy(26));
+      vSrc.push_back(Spy(49));
+      Spy::reset();
+      // exercise
+      custom::small_vector<Spy, 4> vDest(std::move(vSrc));
+      // verify
+      assertUnit(vDest.is_inline());
+      assertUnit(vDest.size() == 2);
+      assertUnit(vDest[1].get() == 49);
+      assertUnit(vSrc.empty());
+      assertUnit(Spy::numCopyMove() == 2);
+      assertUnit(Spy::numCopy() == 0);
+   }  // teardown
+
+   // moving a spilled vector steals its heap buffer
+   void test_constructMove_heap()
+   {  // setup
+      custom::small_vector<int, 2> vSrc{ 26, 49, 67 };
+      int * p = vSrc.data;
+      // exercise
+      custom::small_vector<int, 2> vDest(std::move(vSrc));
+      // verify
+      assertUnit(vDest.data == p);
+      assertUnit(vDest.size() == 3);
+      assertUnit(vSrc.is_inline());
+      assertUnit(vSrc.empty());
+   }  // teardown
+
+   /***************************************
+    * INSERT
+    ***************************************/
+
+   // N elements fit without touching the heap
+   void test_pushback_staysInline()
+   {  // setup
+      custom::small_vector<int, 4> v;
+      // exercise
+      for (int i = 0; i < 4; i++)
+         v.push_back(i);
+      // verify
+      assertUnit(v.is_inline());
+      assertUnit(v.size() == 4);
+      assertUnit(v[3] == 3);
+   }  // teardown
+
+   // the N+1st element moves everything to the heap
+   void test_pushback_spills()
+   {  // setup
+      custom::small_vector<Spy, 4> v;
+      for (int i = 0; i < 4; i++)
+         v.push_back(Spy(i));
+      Spy::reset();
+      // exercise
+      v.push_back(Spy(4));
+      // verify
+      assertUnit(!v.is_inline());
+      assertUnit(v.capacity() == 8);
+      assertUnit(v.size() == 5);
+      assertUnit(v[0].get() == 0);
+      assertUnit(v[4].get() == 4);
+      assertUnit(Spy::numCopy() == 0);
+   }  // teardown
+
+   // copying one of our own elements as we spill
+   void test_pushback_aliasWhileSpilling()
+   {  // setup
+      custom::small_vector<Spy, 2> v;
+      v.push_back(Spy(26));
+      v.push_back(Spy(49));
+      // exercise
+      v.push_back(v[0]);
+      // verify
+      assertUnit(v.size() == 3);
+      assertUnit(v[2].get() == 26);
+      assertUnit(v[0].get() == 26);
+   }  // teardown
+
+   /***************************************
+    * REMOVE
+    ***************************************/
+
+   // every element is destroyed once, inline or not
+   void test_destructor_spy()
+   {  // setup
+      Spy::reset();
+      {
+         custom::small_vector<Spy, 2> vInline;
+         vInline.push_back(Spy(1));
+         custom::small_vector<Spy, 2> vHeap;
+         for (int i = 0; i < 5; i++)
+            vHeap.push_back(Spy(i));
+         // exercise
+      }
+      // verify
+      assertUnit(Spy::numNondefault() + Spy::numCopy() + Spy::numCopyMove() == Spy::numDestructor());
+      assertUnit(Spy::numAlloc() == Spy::numDelete());
+   }  // teardown
+
+   /***************************************
+    * ASSIGN
+    ***************************************/
+
+   // swap an inline vector with a spilled one
+   void test_swap_inlineHeap()
+   {  // setup
+      custom::small_vector<int, 2> vInline{ 26 };
+      custom::small_vector<int, 2> vHeap{ 49, 67, 89 };
+      // exercise
+      vInline.swap(vHeap);
+      // verify
+      assertUnit(vInline.size() == 3);
+      assertUnit(vInline[2] == 89);
+      assertUnit(!vInline.is_inline());
+      assertUnit(vHeap.size() == 1);
+      assertUnit(vHeap[0] == 26);
+      assertUnit(vHeap.is_inline());
+   }  // teardown
+
+   /***************************************
+    * PRIORITY QUEUE
+    ***************************************/
+
+   // a small priority queue works the same, inline or spilled
+   void test_pqueue_pushPop()
+   {  // setup
+      custom::small_priority_queue<int, 4> pq;
+      bool sorted = true;
+      // exercise
+      for (int i = 0; i < 10; i++)
+         pq.push((i * 7) % 10);
+      for (int i = 9; i >= 0; i--)
+         sorted = sorted && pq.pop_top() == i;
+      // verify
+      assertUnit(sorted);
+      assertUnit(pq.empty());
+   }  // teardown
+};
+
+#endif // DEBUG
@@ -13,6 +13,9 @@
 #include "spy.h"        // class under test
 #include "unitTest.h"   // unit test baseclass
 
+#include <thread>       // for std::thread
+#include <vector>       // for std::vector
+
 /***********************************************
  * TEST SPY
  * Unit tests for the Spy class
@@ -68,6 +71,12 @@ public:
       test_lessthan_same();
       test_lessthan_firstSmaller();
       test_lessthan_firstLarger();
+
+      // Threads
+      test_thread_ownCounts();
+      test_thread_total();
+      test_thread_resetTotal();
+      test_thread_atomic();
   
       report("Spy");
    }
@@ -733,6 +742,96 @@ public:
          delete sDes.p;
       sDes.p = sSrc.p = nullptr;
    }
+
+   /***************************************
+    * THREADS
+    *    Spy::total()
+    *    Spy::resetTotal()
+    *    Spy::setCounting()
+    ***************************************/
+
+   // what another thread does is not counted here
+   void test_thread_ownCounts()
+   {  // setup
+      Spy::reset();
+      // exercise
+      std::thread other([]()
+      {
+         Spy s1(1);
+         Spy s2(s1);
+      });
+      other.join();
+      // verify
+      assertUnit(Spy::numNondefault() == 0);
+      assertUnit(Spy::numCopy() == 0);
+      assertUnit(Spy::numAlloc() == 0);
+   }  // teardown
+
+   // total() is every thread, joined or not
+   void test_thread_total()
+   {  // setup
+      const int numThreads = 4;
+      const int numEach = 1000;
+      Spy s1(1);
+      Spy s2(2);
+      std::vector<std::thread> threads;
+      Spy::resetTotal();
+      // exercise
+      for (int t = 0; t < numThreads; t++)
+         threads.emplace_back([&s1, &s2, numEach]()
+         {
+            for (int i = 0; i < numEach; i++)
+               (void)(s1 < s2);
+         });
+      for (std::thread & thread : threads)
+         thread.join();
+      (void)(s1 < s2);
+      // verify
+      assertUnit(Spy::total(LESSTHAN) == numThreads * numEach + 1);
+      assertUnit(Spy::numLessthan() >= 1);
+      assertUnit(Spy::total(COPY) == 0);
+   }  // teardown
+
+   // resetTotal() starts every thread over, this one included
+   void test_thread_resetTotal()
+   {  // setup
+      Spy s1(1);
+      std::thread other([]() { Spy s(2); });
+      other.join();
+      // exercise
+      Spy::resetTotal();
+      // verify
+      assertUnit(Spy::total(NONDEFAULT) == 0);
+      assertUnit(Spy::total(ALLOC) == 0);
+      assertUnit(Spy::numNondefault() == 0);
+   }  // teardown
+
+   // in ATOMIC mode every thread counts into one set
+   void test_thread_atomic()
+   {  // setup
+      const int numThreads = 4;
+      const int numEach = 1000;
+      Spy s1(1);
+      Spy s2(2);
+      std::vector<std::thread> threads;
+      Spy::setCounting(Spy::ATOMIC);
+      Spy::reset();
+      // exercise
+      for (int t = 0; t < numThreads; t++)
+         threads.emplace_back([&s1, &s2, numEach]()
+         {
+            for (int i = 0; i < numEach; i++)
+               (void)(s1 == s2);
+         });
+      for (std::thread & thread : threads)
+         thread.join();
+      // verify
+      assertUnit(Spy::counting() == Spy::ATOMIC);
+      assertUnit(Spy::numEquals() == numThreads * numEach);
+      // teardown
+      Spy::setCounting(Spy::PER_THREAD);
+      assertUnit(Spy::numEquals() != numThreads * numEach);
+   }
 };
 
 #endif // DEBUG
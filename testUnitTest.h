@@ -0,0 +1,111 @@
+/***********************************************************************
+ * Header:
+ *    TEST UNIT TEST
+ * Summary:
+ *    Unit tests for the timing half of UnitTest: measure() and the
+ *    performance ceilings checked with assertNotSlower()
+ * Author
+ *    Stephen Costigan, Alexander Dohms, Jonathan Colwell, Shaun Crook
+ ************************************************************************/
+
+#pragma once
+
+#ifdef DEBUG
+
+#include "unitTest.h"   // class under test
+
+#include <chrono>       // for std::chrono::milliseconds
+#include <thread>       // for std::this_thread::sleep_for
+
+/***********************************************
+ * TEST UNIT TEST
+ * Unit tests for UnitTest::measure() and notSlower()
+ ***********************************************/
+class TestUnitTest : public UnitTest
+{
+public:
+   void run()
+   {
+      reset();
+
+      // Measure
+      test_measure_slowBody();
+      test_measure_spinRatio();
+
+      // Not slower
+      test_notSlower_unstable();
+      test_notSlower_noSamples();
+
+      report("UnitTest");
+   }
+
+   /***************************************
+    * MEASURE
+    ***************************************/
+
+   // a body slower than the whole time allowed still gets its samples
+   void test_measure_slowBody()
+   {  // setup
+      auto body = []() { std::this_thread::sleep_for(std::chrono::milliseconds(2)); };
+      // exercise
+      timing t = measure(body, 0.01, 0.001 /*maxSeconds*/);
+      // verify
+      assertUnit(t.numSamples >= 5);
+      assertUnit(t.nsPerOp >= 2.0e6);
+   }  // teardown
+
+   // eight times the work takes longer, and the ceiling sees it
+   void test_measure_spinRatio()
+   {  // setup
+      auto fast = []() { spin(1000); };
+      auto slow = []() { spin(8000); };
+      // exercise
+      timing tFast = measure(fast, 0.05);
+      timing tSlow = measure(slow, 0.05);
+      // verify
+      assertUnit(tFast.stable);
+      assertUnit(tSlow.stable);
+      assertUnit(tFast.nsPerOp > 0.0);
+      assertNotSlower(tFast, tSlow, 1.0);
+      assertUnit(!notSlower(tSlow, tFast, 2.0));
+   }  // teardown
+
+   /***************************************
+    * NOT SLOWER
+    ***************************************/
+
+   // a time that never settled is not under any ceiling
+   void test_notSlower_unstable()
+   {  // setup
+      timing measured = { 100.0, 80.0, 50, false };
+      timing baseline = { 1000.0, 1.0, 5, true };
+      // exercise
+      bool within = notSlower(measured, baseline, 1.0);
+      // verify
+      assertUnit(!within);
+      assertUnit(!notSlower(baseline, measured, 100.0));
+   }  // teardown
+
+   // nor is one with nothing measured, which looks like 0ns
+   void test_notSlower_noSamples()
+   {  // setup
+      timing measured = { 0.0, 0.0, 0, true };
+      timing baseline = { 1000.0, 1.0, 5, true };
+      // exercise
+      bool within = notSlower(measured, baseline, 1.0);
+      // verify
+      assertUnit(!within);
+      assertUnit(notSlower(baseline, baseline, 1.0));
+   }  // teardown
+
+private:
+   // work that takes time in proportion to num
+   static void spin(size_t num)
+   {
+      volatile size_t sink = 0;
+      for (size_t i = 0; i < num; i++)
+         sink = sink + i;
+   }
+};
+
+#endif // DEBUG
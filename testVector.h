@@ -13,14 +13,108 @@
 
 #include <vector>
 #include "vector.h"
+#include "mmap_allocator.h"
+#include "aligned_allocator.h"
 #include "unitTest.h"
+#include "spy.h"
 
 
 #include <cassert>
 #include <memory>
+#include <algorithm> // for std::sort
 
 #include <iostream>
 
+/***********************************************
+ * TRACKING ALLOCATOR
+ * An allocator that counts what it hands out. Two of them
+ * are equal if they share an id; they do not propagate.
+ ***********************************************/
+struct AllocatorTally
+{
+   int numAllocate;
+   int numDeallocate;
+   long long bytesLive;
+};
+
+template <class T>
+struct TrackingAllocator
+{
+   typedef T value_type;
+
+   TrackingAllocator(AllocatorTally * tally, int id) : tally(tally), id(id) {}
+   template <class U>
+   TrackingAllocator(const TrackingAllocator<U> & rhs) : tally(rhs.tally), id(rhs.id) {}
+
+   T * allocate(size_t num)
+   {
+      tally->numAllocate++;
+      tally->bytesLive += num * sizeof(T);
+      return std::allocator<T>().allocate(num);
+   }
+   void deallocate(T * p, size_t num)
+   {
+      tally->numDeallocate++;
+      tally->bytesLive -= num * sizeof(T);
+      std::allocator<T>().deallocate(p, num);
+   }
+
+   AllocatorTally * tally;
+   int id;
+};
+
+template <class T, class U>
+bool operator == (const TrackingAllocator<T> & lhs, const TrackingAllocator<U> & rhs)
+{
+   return lhs.id == rhs.id;
+}
+template <class T, class U>
+bool operator != (const TrackingAllocator<T> & lhs, const TrackingAllocator<U> & rhs)
+{
+   return !(lhs == rhs);
+}
+
+/***********************************************
+ * THROWING MOVE
+ * A move constructor that is not noexcept: growing
+ * has to copy these to keep the strong guarantee
+ ***********************************************/
+struct ThrowingMove
+{
+   ThrowingMove(int value) : value(value) {}
+   ThrowingMove(const ThrowingMove & rhs) : value(rhs.value) { numCopy++; }
+   ThrowingMove(ThrowingMove && rhs) : value(rhs.value) { numMove++; }
+
+   int value;
+   static int numCopy;
+   static int numMove;
+};
+inline int ThrowingMove::numCopy = 0;
+inline int ThrowingMove::numMove = 0;
+
+/***********************************************
+ * RELOCATABLE
+ * Owns memory through a plain pointer, so it has a real
+ * copy constructor but can still be moved with memcpy
+ ***********************************************/
+struct Relocatable
+{
+   Relocatable(int value) : p(new int(value)) {}
+   Relocatable(const Relocatable & rhs) : p(new int(*rhs.p)) { numCopy++; }
+   Relocatable & operator = (const Relocatable & rhs) { *p = *rhs.p; return *this; }
+   ~Relocatable() { delete p; }
+
+   int * p;
+   static int numCopy;
+};
+inline int Relocatable::numCopy = 0;
+
+namespace custom
+{
+   template <>
+   struct is_trivially_relocatable<Relocatable> : std::true_type {};
+}
+
 class TestVector : public UnitTest
 {
    
@@ -59,6 +153,12 @@ public:
       test_iterator_incrementFull();
       test_iterator_dereferenceReadFull();
       test_iterator_dereferenceUpdate();
+      test_iterator_arithmetic();
+      test_iterator_compare();
+      test_iterator_constFromIterator();
+      test_iterator_sort();
+      test_iterator_lowerBound();
+      test_iterator_makeHeap();
 
       // Access
       test_subscript_read();
@@ -67,6 +167,8 @@ public:
       test_front_write();
       test_back_read();
       test_back_write();
+      test_data_empty();
+      test_data_standard();
 
       // Insert
       test_pushback_empty();
@@ -109,6 +211,42 @@ public:
       test_capacity_empty();
       test_capacity_full();
 
+      // Instrument
+      test_stats_noneIsFree();
+      test_stats_pushback();
+
+      // Allocator
+      test_allocator_pushback();
+      test_allocator_copy();
+      test_allocator_moveEqual();
+      test_allocator_moveUnequal();
+
+      // Storage
+      test_storage_reserve();
+      test_storage_constructSize();
+      test_storage_constructFill();
+      test_storage_pushbackReallocate();
+      test_storage_destructor();
+      test_storage_remove();
+      test_storage_assignShrink();
+
+      // Move
+      test_move_pushback();
+      test_move_emplaceback();
+      test_move_emplacebackAlias();
+      test_move_throwingMoveCopies();
+
+      // Relocate
+      test_relocate_memcpy();
+      test_relocate_mremap();
+      test_relocate_mmapSmall();
+
+      // Align
+      test_align_pushback();
+      test_align_page();
+      test_align_hugePage();
+      test_align_roundsUp();
+
       report("Vector");
    }
    
@@ -146,15 +284,15 @@ public:
       //    +----+----+----+----+
       //    | 00 | 00 | 00 | 00 |
       //    +----+----+----+----+
-      assertUnit(v.data != nullptr);
+      assertUnit(v.buffer != nullptr);
       
       
-      if (v.data)
+      if (v.buffer)
       {
-         assertUnit(v.data[0] == 0);
-         assertUnit(v.data[1] == 0);
-         assertUnit(v.data[2] == 0);
-         assertUnit(v.data[3] == 0);
+         assertUnit(v.buffer[0] == 0);
+         assertUnit(v.buffer[1] == 0);
+         assertUnit(v.buffer[2] == 0);
+         assertUnit(v.buffer[3] == 0);
          
       }
       
@@ -174,14 +312,14 @@ public:
       //    +----+----+----+----+
       //    | 99 | 99 | 99 | 99 |
       //    +----+----+----+----+
-      assertUnit(v.data != nullptr);
+      assertUnit(v.buffer != nullptr);
       
-      if (v.data)
+      if (v.buffer)
       {
-         assertUnit(v.data[0] == 99);
-         assertUnit(v.data[1] == 99);
-         assertUnit(v.data[2] == 99);
-         assertUnit(v.data[3] == 99);
+         assertUnit(v.buffer[0] == 99);
+         assertUnit(v.buffer[1] == 99);
+         assertUnit(v.buffer[2] == 99);
+         assertUnit(v.buffer[3] == 99);
       }
       assertUnit(v.numElements == 4);
       assertUnit(v.numCapacity == 4);
@@ -227,9 +365,9 @@ public:
          //    | 26 | 49 |    |    |
          //    +----+----+----+----+
          custom::vector<int> v;
-         v.data = new int[4];
-         v.data[0] = 99;
-         v.data[1] = 99;
+         v.buffer = v.alloc.allocate(4);
+         v.buffer[0] = 99;
+         v.buffer[1] = 99;
          v.numElements = 2;
          v.numCapacity = 4;
       }  // exercise
@@ -262,7 +400,7 @@ public:
       // exercise
       custom::vector<int> vDest(vSrc);
       // verify
-      assertUnit(vSrc.data != vDest.data);
+      assertUnit(vSrc.buffer != vDest.buffer);
       //      0    1    2    3
       //    +----+----+----+----+
       //    | 26 | 49 | 67 | 89 |
@@ -286,9 +424,9 @@ public:
       //    | 26 | 49 |    |    |
       //    +----+----+----+----+
       custom::vector<int> vSrc;
-      vSrc.data = new int[4];
-      vSrc.data[0] = 26;
-      vSrc.data[1] = 49;
+      vSrc.buffer = vSrc.alloc.allocate(4);
+      vSrc.buffer[0] = 26;
+      vSrc.buffer[1] = 49;
       vSrc.numElements = 2;
       vSrc.numCapacity = 4;
       // exercise
@@ -298,21 +436,21 @@ public:
       //    +----+----+----+----+
       //    | 26 | 49 |    |    |
       //    +----+----+----+----+
-      assertUnit(vSrc.data != nullptr);
-      assertUnit(vSrc.data[0] == 26);
-      assertUnit(vSrc.data[1] == 49);
+      assertUnit(vSrc.buffer != nullptr);
+      assertUnit(vSrc.buffer[0] == 26);
+      assertUnit(vSrc.buffer[1] == 49);
       assertUnit(vSrc.numElements == 2);
       assertUnit(vSrc.numCapacity == 4);
       //      0    1
       //    +----+----+
       //    | 26 | 49 |
       //    +----+----+
-      assertUnit(vDest.data != nullptr);
+      assertUnit(vDest.buffer != nullptr);
       
-      if (vDest.data)
+      if (vDest.buffer)
       {
-         assertUnit(vDest.data[0] == 26);
-         assertUnit(vDest.data[1] == 49);
+         assertUnit(vDest.buffer[0] == 26);
+         assertUnit(vDest.buffer[1] == 49);
       }
       
       assertUnit(vDest.numElements == 2);
@@ -346,7 +484,7 @@ public:
       //    +----+----+----+----+
       custom::vector<int> vSrc;
       setupStandardFixture(vSrc);
-      int * p = vSrc.data;
+      int * p = vSrc.buffer;
       // exercise
       custom::vector<int> vDest(std::move(vSrc));
       // verify
@@ -356,7 +494,7 @@ public:
       //    | 26 | 49 | 67 | 89 |
       //    +----+----+----+----+
       assertStandardFixture(vDest);
-      assertUnit(p == vDest.data);
+      assertUnit(p == vDest.buffer);
       // teardown
       teardownStandardFixture(vSrc);
       teardownStandardFixture(vDest);
@@ -370,9 +508,9 @@ public:
       //    | 26 | 49 |    |    |
       //    +----+----+----+----+
       custom::vector<int> vSrc;
-      vSrc.data = new int[4];\
-      vSrc.data[0] = 26;
-      vSrc.data[1] = 49;
+      vSrc.buffer = vSrc.alloc.allocate(4);\
+      vSrc.buffer[0] = 26;
+      vSrc.buffer[1] = 49;
       vSrc.numElements = 2;
       vSrc.numCapacity = 4;
       // exercise
@@ -383,12 +521,12 @@ public:
       //    +----+----+----+----+
       //    | 26 | 49 |    |    |
       //    +----+----+----+----+
-      assertUnit(vDest.data != nullptr);
+      assertUnit(vDest.buffer != nullptr);
       
-      if (vDest.data && vDest.numElements == 2)
+      if (vDest.buffer && vDest.numElements == 2)
       {
-         assertUnit(vDest.data[0] == 26);
-         assertUnit(vDest.data[1] == 49);
+         assertUnit(vDest.buffer[0] == 26);
+         assertUnit(vDest.buffer[1] == 49);
       }
       
       assertUnit(vDest.numElements == 2);
@@ -514,10 +652,10 @@ public:
       assertUnit(v.numCapacity == 6);
       assertUnit(v.numElements == 6);
       
-      if (v.data)
+      if (v.buffer)
       {
-         assertUnit(v.data[4] == int());
-         assertUnit(v.data[5] == int());
+         assertUnit(v.buffer[4] == int());
+         assertUnit(v.buffer[5] == int());
       }
       
       v.numCapacity = 4;
@@ -545,10 +683,10 @@ public:
       assertUnit(v.numCapacity == 6);
       assertUnit(v.numElements == 6);
       
-      if (v.data && v.numElements == 6)
+      if (v.buffer && v.numElements == 6)
       {
-         assertUnit(v.data[4] == 99);
-         assertUnit(v.data[5] == 99);
+         assertUnit(v.buffer[4] == 99);
+         assertUnit(v.buffer[5] == 99);
       }
       
       v.numCapacity = 4;
@@ -593,7 +731,7 @@ public:
       //    |    |    |    |    |
       //    +----+----+----+----+
       custom::vector<int> v;
-      v.data = new int[4];
+      v.buffer = v.alloc.allocate(4);
       v.numElements = 0;
       v.numCapacity = 4;
       // exercise
@@ -617,7 +755,7 @@ public:
       //    |    |    |    |    |
       //    +----+----+----+----+
       custom::vector<int> v;
-      v.data = new int[4];
+      v.buffer = v.alloc.allocate(4);
       v.numElements = 0;
       v.numCapacity = 4;
       // exercise
@@ -641,7 +779,7 @@ public:
       //    |    |    |    |    |
       //    +----+----+----+----+
       custom::vector<int> v;
-      v.data = new int[4];
+      v.buffer = v.alloc.allocate(4);
       v.numElements = 0;
       v.numCapacity = 4;
       // exercise
@@ -720,7 +858,7 @@ public:
       //    |    |    |    |    |
       //    +----+----+----+----+
       custom::vector<int> v;
-      v.data = new int[4];
+      v.buffer = v.alloc.allocate(4);
       v.numElements = 0;
       v.numCapacity = 4;
       // exercise
@@ -754,11 +892,11 @@ public:
       //    | 26 | 49 | 67 | 89 |    |    |
       //    +----+----+----+----+----+----+
       custom::vector<int> v;
-      v.data = new int[6];
-      v.data[0] = 26;
-      v.data[1] = 49;
-      v.data[2] = 67;
-      v.data[3] = 89;
+      v.buffer = v.alloc.allocate(6);
+      v.buffer[0] = 26;
+      v.buffer[1] = 49;
+      v.buffer[2] = 67;
+      v.buffer[3] = 89;
       v.numElements = 4;
       v.numCapacity = 6;
       // exercise
@@ -865,6 +1003,436 @@ public:
       teardownStandardFixture(v);
    }
    
+   /***************************************
+    * INSTRUMENT
+    ***************************************/
+   
+   // the default policy adds nothing to the vector
+   void test_stats_noneIsFree()
+   {  // setup
+      custom::vector<int, std::allocator<int>, custom::instrument::none> v;
+      // exercise
+      custom::instrument_stats stats = v.stats();
+      // verify
+      struct Bare
+      {
+         int * buffer;
+         size_t numCapacity;
+         size_t numElements;
+         std::allocator<int> alloc;
+      };
+      assertUnit(sizeof(v) == sizeof(Bare));
+      assertUnit(stats.moves == 0);
+      assertUnit(stats.reallocations == 0);
+   }  // teardown
+   
+   // count the reallocations and moves of five push_backs
+   void test_stats_pushback()
+   {  // setup
+      custom::vector<int, std::allocator<int>, custom::instrument::counting> v;
+      // exercise
+      for (int i = 0; i < 5; i++)
+         v.push_back(i);
+      // verify
+      //    capacity 1, 2, 4, 8: 0 + 1 + 2 + 4 moved, 5 pushed
+      custom::instrument_stats stats = v.stats();
+      assertUnit(stats.reallocations == 4);
+      assertUnit(stats.moves == 12);
+      assertUnit(stats.compares == 0);
+      assertUnit(stats.siftLevels == 0);
+      // exercise
+      v.reset_stats();
+      // verify
+      assertUnit(v.stats().moves == 0);
+      assertUnit(v.stats().reallocations == 0);
+   }  // teardown
+   
+   /***************************************
+    * ALLOCATOR
+    ***************************************/
+   
+   // every buffer comes from, and goes back to, the allocator
+   void test_allocator_pushback()
+   {  // setup
+      AllocatorTally tally = { 0, 0, 0 };
+      {
+         custom::vector<int, TrackingAllocator<int>> v(TrackingAllocator<int>(&tally, 1));
+         // exercise
+         for (int i = 0; i < 5; i++)
+            v.push_back(i);
+         // verify
+         //    capacity 1, 2, 4, 8
+         assertUnit(tally.numAllocate == 4);
+         assertUnit(tally.numDeallocate == 3);
+         assertUnit(tally.bytesLive == 8 * sizeof(int));
+         assertUnit(v.size() == 5);
+         assertUnit(v.get_allocator().id == 1);
+      }  // teardown
+      assertUnit(tally.numDeallocate == 4);
+      assertUnit(tally.bytesLive == 0);
+   }
+   
+   // a copy uses the same allocator, unless it is given one
+   void test_allocator_copy()
+   {  // setup
+      AllocatorTally tally = { 0, 0, 0 };
+      {
+         custom::vector<int, TrackingAllocator<int>> vSrc({ 26, 49 }, TrackingAllocator<int>(&tally, 1));
+         // exercise
+         custom::vector<int, TrackingAllocator<int>> vSame(vSrc);
+         custom::vector<int, TrackingAllocator<int>> vOther(vSrc, TrackingAllocator<int>(&tally, 2));
+         // verify
+         assertUnit(vSame.get_allocator().id == 1);
+         assertUnit(vOther.get_allocator().id == 2);
+         assertUnit(vOther.size() == 2);
+         assertUnit(vOther.buffer != vSrc.buffer);
+         assertUnit(tally.numAllocate == 3);
+      }  // teardown
+      assertUnit(tally.bytesLive == 0);
+   }
+   
+   // equal allocators: the buffer itself changes hands
+   void test_allocator_moveEqual()
+   {  // setup
+      AllocatorTally tally = { 0, 0, 0 };
+      {
+         custom::vector<int, TrackingAllocator<int>> vSrc({ 26, 49 }, TrackingAllocator<int>(&tally, 1));
+         custom::vector<int, TrackingAllocator<int>> vDest(TrackingAllocator<int>(&tally, 1));
+         int * p = vSrc.buffer;
+         // exercise
+         vDest = std::move(vSrc);
+         // verify
+         assertUnit(vDest.buffer == p);
+         assertUnit(vSrc.buffer == nullptr);
+         assertUnit(tally.numAllocate == 1);
+      }  // teardown
+      assertUnit(tally.bytesLive == 0);
+   }
+   
+   // unequal allocators that do not propagate: the elements move instead
+   void test_allocator_moveUnequal()
+   {  // setup
+      AllocatorTally tally = { 0, 0, 0 };
+      {
+         custom::vector<int, TrackingAllocator<int>> vSrc({ 26, 49 }, TrackingAllocator<int>(&tally, 1));
+         custom::vector<int, TrackingAllocator<int>> vDest(TrackingAllocator<int>(&tally, 2));
+         int * p = vSrc.buffer;
+         // exercise
+         vDest = std::move(vSrc);
+         // verify
+         assertUnit(vDest.buffer != p);
+         assertUnit(vDest.get_allocator().id == 2);
+         assertUnit(vDest.size() == 2);
+         if (vDest.size() == 2)
+         {
+            assertUnit(vDest[0] == 26);
+            assertUnit(vDest[1] == 49);
+         }
+         assertUnit(vSrc.size() == 0);
+         assertUnit(tally.numAllocate == 2);
+      }  // teardown
+      assertUnit(tally.bytesLive == 0);
+   }
+   
+   /***************************************
+    * STORAGE
+    * Spare capacity is raw memory: no Spy is
+    * default-constructed just to be assigned over
+    ***************************************/
+
+   // reserving room constructs nothing
+   void test_storage_reserve()
+   {  // setup
+      custom::vector<Spy> v;
+      Spy::reset();
+      // exercise
+      v.reserve(10);
+      // verify
+      assertUnit(v.capacity() == 10);
+      assertUnit(Spy::numDefault() == 0);
+      assertUnit(Spy::numDestructor() == 0);
+   }  // teardown
+
+   // a sized vector default-constructs only its elements
+   void test_storage_constructSize()
+   {  // setup
+      Spy::reset();
+      // exercise
+      custom::vector<Spy> v(4);
+      // verify
+      assertUnit(v.size() == 4);
+      assertUnit(Spy::numDefault() == 4);
+      assertUnit(Spy::numAssign() == 0);
+   }  // teardown
+
+   // a filled vector copy-constructs each element
+   void test_storage_constructFill()
+   {  // setup
+      Spy s(99);
+      Spy::reset();
+      // exercise
+      custom::vector<Spy> v(4, s);
+      // verify
+      assertUnit(v.size() == 4);
+      assertUnit(Spy::numCopy() == 4);
+      assertUnit(Spy::numDefault() == 0);
+      assertUnit(Spy::numAssign() == 0);
+   }  // teardown
+
+   // growing moves the live elements (Spy cannot throw on a move) and destroys the old ones
+   void test_storage_pushbackReallocate()
+   {  // setup
+      custom::vector<Spy> v;
+      v.push_back(Spy(26));
+      v.push_back(Spy(49));
+      Spy s(67);
+      Spy::reset();
+      // exercise
+      v.push_back(s);
+      // verify
+      assertUnit(v.size() == 3);
+      assertUnit(v.capacity() == 4);
+      assertUnit(Spy::numCopy() == 1);
+      assertUnit(Spy::numCopyMove() == 2);
+      assertUnit(Spy::numDestructor() == 2);
+      assertUnit(Spy::numDefault() == 0);
+      assertUnit(Spy::numAssign() == 0);
+   }  // teardown
+
+   // only the live elements are destroyed
+   void test_storage_destructor()
+   {  // setup
+      {
+         custom::vector<Spy> v;
+         v.reserve(8);
+         v.push_back(Spy(26));
+         v.push_back(Spy(49));
+         v.push_back(Spy(67));
+         Spy::reset();
+         // exercise
+      }
+      // verify
+      assertUnit(Spy::numDestructor() == 3);
+      assertUnit(Spy::numDelete() == 3);
+   }  // teardown
+
+   // pop_back and resize destroy what they remove
+   void test_storage_remove()
+   {  // setup
+      custom::vector<Spy> v;
+      for (int i = 0; i < 4; i++)
+         v.push_back(Spy(i));
+      Spy::reset();
+      // exercise
+      v.pop_back();
+      v.resize(1);
+      // verify
+      assertUnit(v.size() == 1);
+      assertUnit(v.capacity() == 4);
+      assertUnit(Spy::numDestructor() == 3);
+      assertUnit(Spy::numDelete() == 3);
+      assertUnit(Spy::numDefault() == 0);
+   }  // teardown
+
+   // assigning into a bigger vector assigns the overlap and destroys the rest
+   void test_storage_assignShrink()
+   {  // setup
+      custom::vector<Spy> vSrc;
+      vSrc.push_back(Spy(26));
+      custom::vector<Spy> vDest;
+      for (int i = 0; i < 3; i++)
+         vDest.push_back(Spy(i));
+      Spy::reset();
+      // exercise
+      vDest = vSrc;
+      // verify
+      assertUnit(vDest.size() == 1);
+      assertUnit(vDest[0].get() == 26);
+      assertUnit(Spy::numAssign() == 1);
+      assertUnit(Spy::numDestructor() == 2);
+      assertUnit(Spy::numCopy() == 0);
+   }  // teardown
+
+   /***************************************
+    * MOVE
+    ***************************************/
+
+   // an rvalue is moved in, and moved again when the buffer grows
+   void test_move_pushback()
+   {  // setup
+      custom::vector<Spy> v;
+      Spy::reset();
+      // exercise
+      for (int i = 0; i < 5; i++)
+         v.push_back(Spy(i));
+      // verify
+      assertUnit(v.size() == 5);
+      assertUnit(v[4].get() == 4);
+      assertUnit(Spy::numCopy() == 0);
+      assertUnit(Spy::numAssign() == 0);
+      assertUnit(Spy::numCopyMove() == 5 + 1 + 2 + 4);
+   }  // teardown
+
+   // emplace_back builds the element where it will live
+   void test_move_emplaceback()
+   {  // setup
+      custom::vector<Spy> v;
+      v.reserve(2);
+      Spy::reset();
+      // exercise
+      Spy & s = v.emplace_back(26);
+      // verify
+      assertUnit(&s == &v[0]);
+      assertUnit(s.get() == 26);
+      assertUnit(Spy::numNondefault() == 1);
+      assertUnit(Spy::numCopy() == 0);
+      assertUnit(Spy::numCopyMove() == 0);
+   }  // teardown
+
+   // copying our own element survives the buffer moving
+   void test_move_emplacebackAlias()
+   {  // setup
+      custom::vector<Spy> v;
+      v.push_back(Spy(26));
+      v.push_back(Spy(49));
+      // exercise
+      v.push_back(v[0]);
+      // verify
+      assertUnit(v.size() == 3);
+      assertUnit(v[0].get() == 26);
+      assertUnit(v[2].get() == 26);
+   }  // teardown
+
+   // a move that might throw is not used to grow
+   void test_move_throwingMoveCopies()
+   {  // setup
+      custom::vector<ThrowingMove> v;
+      v.reserve(2);
+      v.push_back(ThrowingMove(26));
+      v.push_back(ThrowingMove(49));
+      ThrowingMove::numCopy = ThrowingMove::numMove = 0;
+      // exercise
+      v.reserve(4);
+      // verify
+      assertUnit(ThrowingMove::numCopy == 2);
+      assertUnit(ThrowingMove::numMove == 0);
+      assertUnit(v[1].value == 49);
+   }  // teardown
+
+   /***************************************
+    * RELOCATE
+    ***************************************/
+
+   // growing moves relocatable elements as bytes, without copying them
+   void test_relocate_memcpy()
+   {  // setup
+      custom::vector<Relocatable> v;
+      v.push_back(Relocatable(26));
+      v.push_back(Relocatable(49));
+      v.push_back(Relocatable(67));
+      Relocatable::numCopy = 0;
+      // exercise
+      v.reserve(10);
+      // verify
+      assertUnit(v.capacity() == 10);
+      assertUnit(Relocatable::numCopy == 0);
+      assertUnit(*v[0].p == 26);
+      assertUnit(*v[1].p == 49);
+      assertUnit(*v[2].p == 67);
+   }  // teardown
+
+   // a mapped buffer keeps its contents when it grows
+   void test_relocate_mremap()
+   {  // setup
+      size_t num = custom::mmap_allocator<int>::threshold / sizeof(int);
+      custom::vector<int, custom::mmap_allocator<int>> v;
+      v.reserve(num);
+      for (size_t i = 0; i < num; i++)
+         v.push_back(int(i));
+      // exercise
+      v.reserve(num * 4);
+      // verify
+      assertUnit(v.capacity() == num * 4);
+      assertUnit(v.size() == num);
+      assertUnit(v[0] == 0);
+      assertUnit(v[num - 1] == int(num - 1));
+   }  // teardown
+
+   // small buffers are never remapped
+   void test_relocate_mmapSmall()
+   {  // setup
+      custom::mmap_allocator<int> a;
+      int * p = a.allocate(10);
+      // exercise
+      int * pNew = a.reallocate(p, 10, 20);
+      // verify
+      assertUnit(pNew == nullptr);
+      assertUnit(!custom::mmap_allocator<int>::isMapped(10));
+      // teardown
+      a.deallocate(p, 10);
+   }
+
+   /***************************************
+    * ALIGN
+    ***************************************/
+
+   // every buffer the vector grows into is on a cache line
+   void test_align_pushback()
+   {  // setup
+      custom::aligned_vector<int, 64> v;
+      bool aligned = true;
+      // exercise
+      for (int i = 0; i < 100; i++)
+      {
+         v.push_back(i);
+         aligned = aligned && (size_t)v.buffer % 64 == 0;
+      }
+      // verify
+      assertUnit(aligned);
+      assertUnit(v.size() == 100);
+      assertUnit(v[0] == 0);
+      assertUnit(v[99] == 99);
+   }  // teardown
+
+   // a few bytes still get a page of their own
+   void test_align_page()
+   {  // setup
+      custom::aligned_vector<char, 4096> v;
+      // exercise
+      v.reserve(10);
+      // verify
+      assertUnit((size_t)v.buffer % 4096 == 0);
+      assertUnit((custom::aligned_allocator<char, 4096>::bytesOf(10) == 4096));
+   }  // teardown
+
+   // big buffers start on a huge page
+   void test_align_hugePage()
+   {  // setup
+      typedef custom::aligned_allocator<int, 128> Alloc;
+      size_t num = Alloc::hugePageSize / sizeof(int);
+      custom::aligned_vector<int, 128> v;
+      // exercise
+      v.reserve(num);
+      v.resize(num);
+      // verify
+      assertUnit(Alloc::isHuge(num));
+      assertUnit(!Alloc::isHuge(num - 1));
+      assertUnit((size_t)v.buffer % Alloc::hugePageSize == 0);
+      assertUnit(v[num - 1] == 0);
+   }  // teardown
+
+   // nothing else may share the last line of a buffer
+   void test_align_roundsUp()
+   {  // setup
+      typedef custom::aligned_allocator<int, 64> Alloc;
+      // exercise
+      // verify
+      assertUnit(Alloc::bytesOf(1) == 64);
+      assertUnit(Alloc::bytesOf(16) == 64);
+      assertUnit(Alloc::bytesOf(17) == 128);
+      assertUnit(Alloc::alignmentOf(17) == 64);
+   }  // teardown
+
    /***************************************
     * ASSIGN COPY
     ***************************************/
@@ -896,14 +1464,14 @@ public:
       //    +----+----+----+----+
       custom::vector<int> vDest;
       setupStandardFixture(vDest);
-      vDest.data[0] = int(99);
-      vDest.data[1] = int(99);
-      vDest.data[2] = int(99);
-      vDest.data[3] = int(99);
+      vDest.buffer[0] = int(99);
+      vDest.buffer[1] = int(99);
+      vDest.buffer[2] = int(99);
+      vDest.buffer[3] = int(99);
       // exercise
       vDest = vSrc;
       // verify
-      assert(vDest.data != vSrc.data);
+      assert(vDest.buffer != vSrc.buffer);
       //      0    1    2    3
       //    +----+----+----+----+
       //    | 26 | 49 | 67 | 89 |
@@ -933,15 +1501,15 @@ public:
       //    | 99 | 99 |
       //    +----+----+
       custom::vector<int> vDest;
-      vDest.data = new int[2];
-      vDest.data[0] = 99;
-      vDest.data[1] = 99;
+      vDest.buffer = vDest.alloc.allocate(2);
+      vDest.buffer[0] = 99;
+      vDest.buffer[1] = 99;
       vDest.numElements = 2;
       vDest.numCapacity = 2;
       // exercise
       vDest = vSrc;
       // verify
-      assert(vDest.data != vSrc.data);
+      assert(vDest.buffer != vSrc.buffer);
       //      0    1    2    3
       //    +----+----+----+----+
       //    | 26 | 49 | 67 | 89 |
@@ -965,9 +1533,9 @@ public:
       //    | 99 | 99 |
       //    +----+----+
       custom::vector<int> vSrc;
-      vSrc.data = new int[2];
-      vSrc.data[0] = 99;
-      vSrc.data[1] = 99;
+      vSrc.buffer = vSrc.alloc.allocate(2);
+      vSrc.buffer[0] = 99;
+      vSrc.buffer[1] = 99;
       vSrc.numElements = 2;
       vSrc.numCapacity = 2;
       //      0    1    2    3
@@ -982,28 +1550,28 @@ public:
       vD = vS;
       vDest = vSrc;
       // verify
-      assert(vDest.data != vSrc.data);
+      assert(vDest.buffer != vSrc.buffer);
       //      0    1
       //    +----+----+
       //    | 99 | 99 |
       //    +----+----+
       assertUnit(vSrc.numCapacity == 2);
       assertUnit(vSrc.numElements == 2);
-      assertUnit(vSrc.data != nullptr);
-      assertUnit(vSrc.data[0] == int(99));
-      assertUnit(vSrc.data[1] == int(99));
+      assertUnit(vSrc.buffer != nullptr);
+      assertUnit(vSrc.buffer[0] == int(99));
+      assertUnit(vSrc.buffer[1] == int(99));
       //      0    1    2    3
       //    +----+----+----+----+
       //    | 99 | 99 |    |    |
       //    +----+----+----+----+
       assertUnit(vDest.numCapacity == 4);
       assertUnit(vDest.numElements == 2);
-      assertUnit(vDest.data != nullptr);
+      assertUnit(vDest.buffer != nullptr);
       
-      if (vDest.data)
+      if (vDest.buffer)
       {
-         assertUnit(vDest.data[0] == int(99));
-         assertUnit(vDest.data[1] == int(99));
+         assertUnit(vDest.buffer[0] == int(99));
+         assertUnit(vDest.buffer[1] == int(99));
       }
       
       // teardown
@@ -1029,7 +1597,7 @@ public:
       int value(99);
       // exercise
       
-      if (v.data)
+      if (v.buffer)
       {
          value = v[1];
       }
@@ -1060,8 +1628,8 @@ public:
       //    +----+----+----+----+
       //    | 26 | 99 | 67 | 89 |
       //    +----+----+----+----+
-      assertUnit(v.data[1] == int(99));
-      v.data[1] = int(49);
+      assertUnit(v.buffer[1] == int(99));
+      v.buffer[1] = int(49);
       assertStandardFixture(v);
       // teardown
       teardownStandardFixture(v);
@@ -1080,7 +1648,7 @@ public:
       int value(99);
       // exercise
       
-      if (v.data)
+      if (v.buffer)
       {
          value = v.front();
       }
@@ -1109,8 +1677,8 @@ public:
       //    +----+----+----+----+
       //    | 99 | 49 | 67 | 89 |
       //    +----+----+----+----+
-      assertUnit(v.data[0] == int(99));
-      v.data[0] = int(26);
+      assertUnit(v.buffer[0] == int(99));
+      v.buffer[0] = int(26);
       assertStandardFixture(v);
       // teardown
       teardownStandardFixture(v);
@@ -1129,7 +1697,7 @@ public:
       int value(99);
       // exercise
       
-      if (v.data)
+      if (v.buffer)
       {
          value = v.back();
       }
@@ -1156,8 +1724,45 @@ public:
       //    +----+----+----+----+
       //    | 26 | 49 | 67 | 99 |
       //    +----+----+----+----+
-      assertUnit(v.data[3] == int(99));
-      v.data[3] = int(89);
+      assertUnit(v.buffer[3] == int(99));
+      v.buffer[3] = int(89);
+      assertStandardFixture(v);
+      // teardown
+      teardownStandardFixture(v);
+   }
+
+   // an empty vector has no buffer to point to
+   void test_data_empty()
+   {  // setup
+      const custom::vector<int> v;
+      // exercise
+      const int * p = v.data();
+      // verify
+      assertUnit(p == nullptr);
+   }  // teardown
+
+   // data() is the first element, and writes go through it
+   void test_data_standard()
+   {  // setup
+      //      0    1    2    3
+      //    +----+----+----+----+
+      //    | 26 | 49 | 67 | 89 |
+      //    +----+----+----+----+
+      custom::vector<int> v;
+      setupStandardFixture(v);
+      // exercise
+      int * p = v.data();
+      p[1] = int(99);
+      // verify
+      //      0    1    2    3
+      //    +----+----+----+----+
+      //    | 26 | 99 | 67 | 89 |
+      //    +----+----+----+----+
+      assertUnit(p == v.buffer);
+      assertUnit(p == &v[0]);
+      assertUnit(v.buffer[1] == int(99));
+      assertUnit(static_cast<const custom::vector<int> &>(v).data() == p);
+      v.buffer[1] = int(49);
       assertStandardFixture(v);
       // teardown
       teardownStandardFixture(v);
@@ -1195,12 +1800,12 @@ public:
       //    +----+----+----+----+
       assertUnit(v.numCapacity == 4);
       assertUnit(v.numElements == 3);
-      assertUnit(v.data != nullptr);
-      if (v.data != nullptr)
+      assertUnit(v.buffer != nullptr);
+      if (v.buffer != nullptr)
       {
-         assertUnit(v.data[0] == 26);
-         assertUnit(v.data[1] == 49);
-         assertUnit(v.data[2] == 67);
+         assertUnit(v.buffer[0] == 26);
+         assertUnit(v.buffer[1] == 49);
+         assertUnit(v.buffer[2] == 67);
       }
       // teardown
       teardownStandardFixture(v);
@@ -1214,9 +1819,9 @@ public:
       //    | 26 | 49 |    |    |
       //    +----+----+----+----+
       custom::vector<int> v;
-      v.data = new int[4];
-      v.data[0] = 26;
-      v.data[1] = 49;
+      v.buffer = v.alloc.allocate(4);
+      v.buffer[0] = 26;
+      v.buffer[1] = 49;
       v.numElements = 2;
       v.numCapacity = 4;
       // exercise
@@ -1228,10 +1833,10 @@ public:
       //    +----+----+----+----+
       assertUnit(v.numCapacity == 4);
       assertUnit(v.numElements == 1);
-      assertUnit(v.data != nullptr);
-      if (v.data != nullptr)
+      assertUnit(v.buffer != nullptr);
+      if (v.buffer != nullptr)
       {
-         assertUnit(v.data[0] == 26);
+         assertUnit(v.buffer[0] == 26);
       }      // teardown
       teardownStandardFixture(v);
    }
@@ -1268,7 +1873,7 @@ public:
       //    +----+----+----+----+
       assertUnit(v.numCapacity == 4);
       assertUnit(v.numElements == 0);
-      assertUnit(v.data != nullptr);
+      assertUnit(v.buffer != nullptr);
       // teardown
       teardownStandardFixture(v);
    }
@@ -1281,9 +1886,9 @@ public:
       //    | 26 | 49 |    |    |
       //    +----+----+----+----+
       custom::vector<int> v;
-      v.data = new int[4];
-      v.data[0] = 26;
-      v.data[1] = 49;
+      v.buffer = v.alloc.allocate(4);
+      v.buffer[0] = 26;
+      v.buffer[1] = 49;
       v.numElements = 2;
       v.numCapacity = 4;
       // exercise
@@ -1295,7 +1900,7 @@ public:
       //    +----+----+----+----+
       assertUnit(v.numCapacity == 4);
       assertUnit(v.numElements == 0);
-      assertUnit(v.data != nullptr);
+      assertUnit(v.buffer != nullptr);
       // teardown
       teardownStandardFixture(v);
    }
@@ -1318,11 +1923,11 @@ public:
       //    +----+
       //    | 99 |
       //    +----+
-      assertUnit(v.data != nullptr);
+      assertUnit(v.buffer != nullptr);
       
-      if (v.data)
+      if (v.buffer)
       {
-         assertUnit(v.data[0] == int(99));
+         assertUnit(v.buffer[0] == int(99));
       }
       
       assertUnit(v.numCapacity == 1);
@@ -1339,10 +1944,10 @@ public:
       //    | 26 | 49 | 67 |    |
       //    +----+----+----+----+
       custom::vector<int> v;
-      v.data = new int[4];
-      v.data[0] = 26;
-      v.data[1] = 49;
-      v.data[2] = 67;
+      v.buffer = v.alloc.allocate(4);
+      v.buffer[0] = 26;
+      v.buffer[1] = 49;
+      v.buffer[2] = 67;
       v.numElements = 3;
       v.numCapacity = 4;
       int s(89);
@@ -1369,10 +1974,10 @@ public:
       //    | 26 | 49 | 67 |
       //    +----+----+----+
       custom::vector<int> v;
-      v.data = new int[3];
-      v.data[0] = 26;
-      v.data[1] = 49;
-      v.data[2] = 67;
+      v.buffer = v.alloc.allocate(3);
+      v.buffer[0] = 26;
+      v.buffer[1] = 49;
+      v.buffer[2] = 67;
       v.numElements = 3;
       v.numCapacity = 3;
       int s(99);
@@ -1385,15 +1990,15 @@ public:
       //    +----+----+----+----+----+----+
       //    | 26 | 49 | 67 | 99 |    |    |
       //    +----+----+----+----+----+----+
-      assertUnit(v.data != nullptr);
+      assertUnit(v.buffer != nullptr);
       
-      if (v.data)
+      if (v.buffer)
       {
-         assertUnit(v.data[0] == int(26));
-         assertUnit(v.data[1] == int(49));
-         assertUnit(v.data[2] == int(67));
+         assertUnit(v.buffer[0] == int(26));
+         assertUnit(v.buffer[1] == int(49));
+         assertUnit(v.buffer[2] == int(67));
          if (v.numElements > 3)
-            assertUnit(v.data[3] == int(99));
+            assertUnit(v.buffer[3] == int(99));
       }
       
       assertUnit(v.numCapacity == 6);
@@ -1417,11 +2022,11 @@ public:
       //    +----+
       //    | 99 |
       //    +----+
-      assertUnit(v.data != nullptr);
+      assertUnit(v.buffer != nullptr);
       
-      if (v.data)
+      if (v.buffer)
       {
-         assertUnit(v.data[0] == int(99));
+         assertUnit(v.buffer[0] == int(99));
       }
       
       assertUnit(v.numCapacity == 1);
@@ -1438,11 +2043,11 @@ public:
       //    | 26 | 49 | 67 |    |
       //    +----+----+----+----+
       custom::vector<int> v;
-      v.data = new int[4];
+      v.buffer = v.alloc.allocate(4);
       
-      v.data[0] = 26;
-      v.data[1] = 49;
-      v.data[2] = 67;
+      v.buffer[0] = 26;
+      v.buffer[1] = 49;
+      v.buffer[2] = 67;
       
       v.numElements = 3;
       v.numCapacity = 4;
@@ -1471,11 +2076,11 @@ public:
       //    | 26 | 49 | 67 |
       //    +----+----+----+
       custom::vector<int> v;
-      v.data = new int[3];
+      v.buffer = v.alloc.allocate(3);
       
-      v.data[0] = 26;
-      v.data[1] = 49;
-      v.data[2] = 67;
+      v.buffer[0] = 26;
+      v.buffer[1] = 49;
+      v.buffer[2] = 67;
       
       v.numElements = 3;
       v.numCapacity = 3;
@@ -1490,14 +2095,14 @@ public:
       //    +----+----+----+----+----+----+
       //    | 26 | 49 | 67 | 99 |    |    |
       //    +----+----+----+----+----+----+
-      assertUnit(v.data != nullptr);
-      if (v.data)
+      assertUnit(v.buffer != nullptr);
+      if (v.buffer)
       {
-         assertUnit(v.data[0] == int(26));
-         assertUnit(v.data[1] == int(49));
-         assertUnit(v.data[2] == int(67));
+         assertUnit(v.buffer[0] == int(26));
+         assertUnit(v.buffer[1] == int(49));
+         assertUnit(v.buffer[2] == int(67));
          if (v.numElements > 3)
-            assertUnit(v.data[3] == int(99));
+            assertUnit(v.buffer[3] == int(99));
       }
       assertUnit(v.numCapacity == 6);
       assertUnit(v.numElements == 4);
@@ -1538,7 +2143,7 @@ public:
       //    | 26 | 49 | 67 | 89 |
       //    +----+----+----+----+
       //      it
-      assertUnit(it.p == &(v.data[0]));
+      assertUnit(it.p == &(v.buffer[0]));
       if (it.p)
       {
          assertUnit(*(it.p) == 26);
@@ -1566,7 +2171,7 @@ public:
       //    | 26 | 49 | 67 | 89 |
       //    +----+----+----+----+
       //                           it
-      assertUnit(it.p == &(v.data[4]));
+      assertUnit(it.p == &(v.buffer[4]));
       assertStandardFixture(v);
       // teardown
       teardownStandardFixture(v);
@@ -1583,7 +2188,7 @@ public:
       custom::vector<int> v;
       setupStandardFixture(v);
       custom::vector<int>::iterator it;
-      it.p = &(v.data[1]);
+      it.p = &(v.buffer[1]);
       // exercise
       ++it;
       // verify
@@ -1609,12 +2214,12 @@ public:
       custom::vector<int> v;
       setupStandardFixture(v);
       custom::vector<int>::iterator it;
-      it.p = &(v.data[1]);
+      it.p = &(v.buffer[1]);
       // exercise
       int value = *it;
       // verify
       assertUnit(value == int(49));
-      assertUnit(it.p == &(v.data[1]));
+      assertUnit(it.p == &(v.buffer[1]));
       assertStandardFixture(v);
       // teardown
       teardownStandardFixture(v);
@@ -1631,7 +2236,7 @@ public:
       custom::vector<int> v;
       setupStandardFixture(v);
       custom::vector<int>::iterator it;
-      it.p = &(v.data[1]);
+      it.p = &(v.buffer[1]);
       // exercise
       *it = int(99);
       // verify
@@ -1640,13 +2245,123 @@ public:
       //    | 26 | 99 | 67 | 89 |
       //    +----+----+----+----+
       //           it
-      assertUnit(v.data[0] == int(26));
-      assertUnit(v.data[1] == int(99));
-      assertUnit(v.data[2] == int(67));
-      assertUnit(v.data[3] == int(89));
+      assertUnit(v.buffer[0] == int(26));
+      assertUnit(v.buffer[1] == int(99));
+      assertUnit(v.buffer[2] == int(67));
+      assertUnit(v.buffer[3] == int(89));
       assertUnit(v.numElements == 4);
       assertUnit(v.numCapacity == 4);
-      assertUnit(it.p == &(v.data[1]));
+      assertUnit(it.p == &(v.buffer[1]));
+      // teardown
+      teardownStandardFixture(v);
+   }
+
+   // iterator jumps and subscripts like a pointer
+   void test_iterator_arithmetic()
+   {  // setup
+      //      0    1    2    3
+      //    +----+----+----+----+
+      //    | 26 | 49 | 67 | 89 |
+      //    +----+----+----+----+
+      //      it
+      custom::vector<int> v;
+      setupStandardFixture(v);
+      custom::vector<int>::iterator it = v.begin();
+      // exercise
+      it += 3;
+      custom::vector<int>::iterator itBack = it - 2;
+      // verify
+      assertUnit(*it == int(89));
+      assertUnit(*itBack == int(49));
+      assertUnit(itBack[1] == int(67));
+      assertUnit(*(1 + itBack) == int(67));
+      assertUnit(it - itBack == 2);
+      assertUnit(v.end() - v.begin() == 4);
+      assertStandardFixture(v);
+      // teardown
+      teardownStandardFixture(v);
+   }
+
+   // iterators order by position
+   void test_iterator_compare()
+   {  // setup
+      custom::vector<int> v;
+      setupStandardFixture(v);
+      // exercise
+      custom::vector<int>::iterator itFirst = v.begin();
+      custom::vector<int>::iterator itLast = v.end() - 1;
+      // verify
+      assertUnit(itFirst < itLast);
+      assertUnit(itLast > itFirst);
+      assertUnit(itFirst <= itFirst);
+      assertUnit(itLast >= itFirst);
+      assertUnit(!(itLast < itFirst));
+      assertStandardFixture(v);
+      // teardown
+      teardownStandardFixture(v);
+   }
+
+   // an iterator converts to a const_iterator; a const vector gives const_iterators
+   void test_iterator_constFromIterator()
+   {  // setup
+      custom::vector<int> v;
+      setupStandardFixture(v);
+      const custom::vector<int> & vConst = v;
+      // exercise
+      custom::vector<int>::const_iterator it = v.begin() + 1;
+      custom::vector<int>::const_iterator itConst = vConst.begin() + 1;
+      // verify
+      assertUnit(it == itConst);
+      assertUnit(*itConst == int(49));
+      assertUnit(v.cend() - v.cbegin() == 4);
+      assertUnit(vConst.end() == v.end());
+      assertUnit((std::is_same<decltype(*itConst), const int &>::value));
+      assertStandardFixture(v);
+      // teardown
+      teardownStandardFixture(v);
+   }
+
+   // std::sort needs random access
+   void test_iterator_sort()
+   {  // setup
+      custom::vector<int> v{ 89, 26, 67, 49 };
+      // exercise
+      std::sort(v.begin(), v.end());
+      // verify
+      //      0    1    2    3
+      //    +----+----+----+----+
+      //    | 26 | 49 | 67 | 89 |
+      //    +----+----+----+----+
+      assertStandardFixture(v);
+   }  // teardown
+
+   // std::lower_bound is a binary search with random access
+   void test_iterator_lowerBound()
+   {  // setup
+      custom::vector<int> v;
+      setupStandardFixture(v);
+      const custom::vector<int> & vConst = v;
+      // exercise
+      custom::vector<int>::const_iterator it = std::lower_bound(vConst.begin(), vConst.end(), 50);
+      // verify
+      assertUnit(it - vConst.begin() == 2);
+      assertUnit(*it == int(67));
+      assertStandardFixture(v);
+      // teardown
+      teardownStandardFixture(v);
+   }
+
+   // the heap algorithms work on a custom::vector
+   void test_iterator_makeHeap()
+   {  // setup
+      custom::vector<int> v;
+      setupStandardFixture(v);
+      // exercise
+      std::make_heap(v.begin(), v.end());
+      // verify
+      assertUnit(std::is_heap(v.begin(), v.end()));
+      assertUnit(v.buffer[0] == int(89));
+      assertUnit(v.numElements == 4);
       // teardown
       teardownStandardFixture(v);
    }
@@ -1663,11 +2378,11 @@ public:
       
       try
       {
-         v.data = new int[4];
-         v.data[0] = 26;
-         v.data[1] = 49;
-         v.data[2] = 67;
-         v.data[3] = 89;
+         v.buffer = v.alloc.allocate(4);
+         v.buffer[0] = 26;
+         v.buffer[1] = 49;
+         v.buffer[2] = 67;
+         v.buffer[3] = 89;
          v.numElements = 4;
          v.numCapacity = 4;
       }
@@ -1686,21 +2401,21 @@ public:
     *************************************************************/
    void assertStandardFixtureParameters(const custom::vector<int>& v, int line, const char* function)
    {
-      assertIndirect(v.data != nullptr);
+      assertIndirect(v.buffer != nullptr);
       assertIndirect(v.numCapacity == 4);
       assertIndirect(v.numElements == 4);
       
       
-      if (v.data != nullptr)
+      if (v.buffer != nullptr)
       {
          if (v.numElements > 0)
-            assertIndirect(v.data[0] == 26);
+            assertIndirect(v.buffer[0] == 26);
          if (v.numElements > 1)
-            assertIndirect(v.data[1] == 49);
+            assertIndirect(v.buffer[1] == 49);
          if (v.numElements > 2)
-            assertIndirect(v.data[2] == 67);
+            assertIndirect(v.buffer[2] == 67);
          if (v.numElements > 3)
-            assertIndirect(v.data[3] == 89);
+            assertIndirect(v.buffer[3] == 89);
       }
    }
    
@@ -1709,7 +2424,7 @@ public:
     *************************************************************/
    void assertEmptyFixtureParameters(const custom::vector<int>& v, int line, const char* function)
    {
-      assertIndirect(v.data == nullptr);
+      assertIndirect(v.buffer == nullptr);
       assertIndirect(v.numCapacity == 0);
       assertIndirect(v.numElements == 0);
    }
@@ -1719,14 +2434,14 @@ public:
     *************************************************************/
    void teardownStandardFixture(custom::vector<int>&v)
    {
-      if (v.data != nullptr && false)
+      if (v.buffer != nullptr && false)
       {
          for (size_t i = 0; i < v.numElements; i++)
-         delete (&v.data[i]);
-         //v.alloc.deallocate(v.data, v.numCapacity);
+         delete (&v.buffer[i]);
+         //v.alloc.deallocate(v.buffer, v.numCapacity);
          
       }
-      v.data = nullptr;
+      v.buffer = nullptr;
       v.numElements = v.numCapacity = 0;
    }
    
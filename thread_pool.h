@@ -0,0 +1,176 @@
+/***********************************************************************
+ * Header:
+ *    THREAD POOL
+ * Summary:
+ *    A fixed set of worker threads pulling tasks off a shared queue.
+ *    Used by the parallel algorithms on our containers.
+ *
+ *    This will contain the class definition of:
+ *        thread_pool            : A class that represents a pool of workers
+ * Author
+ *    Stephen Costigan, Alexander Dohms, Jonathan Colwell, Shaun Crook
+ ************************************************************************/
+
+#pragma once
+
+#include <cassert>
+#include <condition_variable> // for std::condition_variable
+#include <deque>              // for std::deque
+#include <exception>          // for std::exception_ptr
+#include <functional>         // for std::function
+#include <mutex>              // for std::mutex
+#include <thread>             // for std::thread
+#include <vector>             // for std::vector
+
+namespace custom
+{
+
+/*****************************************
+ * THREAD POOL
+ * Start numThreads workers once, hand them tasks with submit(),
+ * and block on wait() until every submitted task has finished.
+ ****************************************/
+class thread_pool
+{
+public:
+
+   //
+   // Construct
+   //
+
+   explicit thread_pool(size_t numThreads = defaultConcurrency());
+   thread_pool(const thread_pool &) = delete;
+   thread_pool & operator = (const thread_pool &) = delete;
+   ~thread_pool();
+
+   //
+   // Work
+   //
+
+   void submit(std::function<void()> task);
+   void wait();
+
+   //
+   // Status
+   //
+
+   size_t size() const { return workers.size(); }
+
+   // the number of hardware threads, never less than one
+   static size_t defaultConcurrency()
+   {
+      size_t num = std::thread::hardware_concurrency();
+      return num == 0 ? 1 : num;
+   }
+
+private:
+   void work();
+
+   std::vector<std::thread>          workers;  // the threads doing the work
+   std::deque<std::function<void()>> tasks;    // work not yet started
+   std::mutex                        lock;     // guards everything below
+   std::condition_variable           cvTask;   // signaled when a task arrives
+   std::condition_variable           cvIdle;   // signaled when a task finishes
+   size_t                            numBusy;  // tasks currently running
+   bool                              stopping; // set by the destructor
+   std::exception_ptr                error;    // first exception thrown by a task
+};
+
+/*****************************************
+ * THREAD POOL :: CONSTRUCTOR
+ * Start the workers. They sleep until there is something to do.
+ ****************************************/
+inline thread_pool :: thread_pool(size_t numThreads) : numBusy(0), stopping(false)
+{
+   if (numThreads == 0)
+      numThreads = 1;
+   workers.reserve(numThreads);
+   for (size_t i = 0; i < numThreads; i++)
+      workers.emplace_back([this] { work(); });
+}
+
+/*****************************************
+ * THREAD POOL :: DESTRUCTOR
+ * Finish the queued work, then join every worker
+ ****************************************/
+inline thread_pool :: ~thread_pool()
+{
+   {
+      std::unique_lock<std::mutex> guard(lock);
+      stopping = true;
+   }
+   cvTask.notify_all();
+   for (auto & worker : workers)
+      worker.join();
+}
+
+/*****************************************
+ * THREAD POOL :: SUBMIT
+ * Queue a task for the next free worker
+ ****************************************/
+inline void thread_pool :: submit(std::function<void()> task)
+{
+   {
+      std::unique_lock<std::mutex> guard(lock);
+      assert(!stopping);
+      tasks.push_back(std::move(task));
+   }
+   cvTask.notify_one();
+}
+
+/*****************************************
+ * THREAD POOL :: WAIT
+ * Block until the queue is drained and nobody is working.
+ * If a task threw, the first exception is rethrown here.
+ ****************************************/
+inline void thread_pool :: wait()
+{
+   std::unique_lock<std::mutex> guard(lock);
+   cvIdle.wait(guard, [this] { return tasks.empty() && numBusy == 0; });
+   if (error)
+   {
+      std::exception_ptr e = error;
+      error = nullptr;
+      std::rethrow_exception(e);
+   }
+}
+
+/*****************************************
+ * THREAD POOL :: WORK
+ * The loop each worker runs until the pool is destroyed
+ ****************************************/
+inline void thread_pool :: work()
+{
+   for (;;)
+   {
+      std::function<void()> task;
+      {
+         std::unique_lock<std::mutex> guard(lock);
+         cvTask.wait(guard, [this] { return stopping || !tasks.empty(); });
+         if (tasks.empty())
+            return;
+         task = std::move(tasks.front());
+         tasks.pop_front();
+         numBusy++;
+      }
+
+      try
+      {
+         task();
+      }
+      catch (...)
+      {
+         std::unique_lock<std::mutex> guard(lock);
+         if (!error)
+            error = std::current_exception();
+      }
+
+      {
+         std::unique_lock<std::mutex> guard(lock);
+         numBusy--;
+      }
+      cvIdle.notify_all();
+   }
+}
+
+} // namespace custom
@@ -2,7 +2,26 @@
  * Header:
  *    UNIT TEST
  * Summary:
- *    The base class to all the unit test classes
+ *    The base class to all the unit test classes. Besides pass and
+ *    fail, it keeps the wall time of every test and can time a piece
+ *    of code until the time is steady, for a suite of performance
+ *    checks built with optimizations on and run on a quiet machine:
+ *
+ *       timing ours   = measure([&]() { pq.push(i++); pq.pop(); });
+ *       timing theirs = measure([&]() { pqStd.push(i++); pqStd.pop(); });
+ *       assertNotSlower(ours, theirs, 1.10);   // at most 10% slower
+ *
+ *    Ceilings are relative to a baseline and never an absolute number
+ *    of nanoseconds. A timing that did not settle fails the ceiling
+ *    rather than passing it. Even so, a wall-clock ceiling does not
+ *    belong in the correctness suites, which run unoptimized and all
+ *    at once; the comparisons against std live in the benchmarks.
+ *
+ *    Suites may run at the same time on different threads, and a suite
+ *    may run its own tests at the same time with runConcurrently().
+ *    The failures and times are kept under a lock and report() writes
+ *    its lines in one piece, so nothing interleaves. Spy counts per
+ *    thread, so a test that runs on one thread sees only its own counts.
  * Author
  *    Br. Helfrich
  ************************************************************************/
@@ -15,6 +34,7 @@
 #undef assertComplexFixture
 #undef assertStandardFixture
 #undef assertEmptyFixture
+#undef assertNotSlower
 
 
 #define assertUnit(condition)     assertUnitParameters(condition, #condition, __LINE__, __FUNCTION__)
@@ -22,19 +42,49 @@
 #define assertComplexFixture(x)   assertComplexFixtureParameters( x, __LINE__, __FUNCTION__)
 #define assertStandardFixture(x)  assertStandardFixtureParameters(x, __LINE__, __FUNCTION__)
 #define assertEmptyFixture(x)     assertEmptyFixtureParameters(   x, __LINE__, __FUNCTION__)
+#define assertNotSlower(measured, baseline, ratio) \
+   assertNotSlowerParameters(measured, baseline, ratio, #measured " vs " #baseline, __LINE__, __FUNCTION__)
 
-#include <iostream>  // for std::cerr
-#include <string>    // for std::string
-#include <vector>    // for std::vector
-#include <map>       // for std::map
+#include <chrono>     // for std::chrono::steady_clock
+#include <cmath>      // for std::sqrt
+#include <functional> // for std::function
+#include <iostream>   // for std::cerr
+#include <sstream>    // for std::ostringstream
+#include <string>     // for std::string
+#include <vector>     // for std::vector
+#include <map>        // for std::map
+#include <mutex>      // for std::mutex
+#include <thread>     // for std::this_thread
+#include "thread_pool.h"     // for running tests concurrently
+#include "allocationScope.h" // so asserting does not count as allocating
 
 
 class UnitTest
 {
 public:
    UnitTest() { reset(); }
+
+   // what measure() found: the mean time of one call of the body,
+   // its standard deviation, and whether it settled in time
+   struct timing
+   {
+      double nsPerOp;
+      double nsStddev;
+      size_t numSamples;
+      bool   stable;
+   };
+
+   // report() lists every test that took at least this long. Set it
+   // to 0.0 to see them all.
+   static double & reportSecondsOver()
+   {
+      static double seconds = 0.1;
+      return seconds;
+   }
    
 private:
+   typedef std::chrono::steady_clock clock;
+
    // a test failure is a failure string and a line number
    struct Failure
    {
@@ -45,6 +95,63 @@ private:
    // each test has a name (the key) and the list of failures(value).
    std::map<std::string, std::vector<Failure>> tests;
 
+   // the wall time of each test, and when each thread last asserted
+   std::map<std::string, double> seconds;
+   std::map<std::thread::id, clock::time_point> lastMark;
+
+   // guards tests, seconds, and lastMark
+   std::mutex lock;
+
+   // one report() at a time, whatever suite it is from
+   static std::mutex & outputLock()
+   {
+      static std::mutex m;
+      return m;
+   }
+
+   /*************************************************************
+    * MARK
+    * Charge the time since this thread last asserted to this test.
+    * Tests on a thread run one after another and assert at the end,
+    * so that is its setup and exercise (and the teardown of the test
+    * before it).
+    *************************************************************/
+   void mark(const std::string & sFunc)
+   {
+      clock::time_point now = clock::now();
+      std::lock_guard<std::mutex> guard(lock);
+      auto it = lastMark.find(std::this_thread::get_id());
+      if (it != lastMark.end())
+         seconds[sFunc] += std::chrono::duration<double>(now - it->second).count();
+      lastMark[std::this_thread::get_id()] = now;
+   }
+
+   // a test is starting on this thread: the clock starts now
+   void startMark()
+   {
+      clock::time_point now = clock::now();
+      std::lock_guard<std::mutex> guard(lock);
+      lastMark[std::this_thread::get_id()] = now;
+   }
+
+   // a failure, or for a pass just the placeholder
+   void record(const std::string & sFunc, bool condition,
+               const char * conditionString, int line)
+   {
+      std::lock_guard<std::mutex> guard(lock);
+      if (!condition)
+      {
+         // add a failure to the list of failures
+         Failure failure{std::string(conditionString), line};
+         tests[sFunc].push_back(failure);
+      }
+      else
+      {
+         // this ensures there is a placeholder for the successful test
+         tests[sFunc];
+      }
+   }
+
 protected:
    /*************************************************************
     * RESET
@@ -52,7 +159,32 @@ protected:
     *************************************************************/
    void reset()
    {
-      tests.clear();
+      {
+         std::lock_guard<std::mutex> guard(lock);
+         tests.clear();
+         seconds.clear();
+         lastMark.clear();
+      }
+      startMark();
+   }
+
+   /*************************************************************
+    * RUN CONCURRENTLY
+    * Run each test on a worker pool, as many at once as there are
+    * cores. Only for tests that share nothing but the suite: no
+    * globals, and every Spy they count made on their own thread.
+    *************************************************************/
+   void runConcurrently(std::initializer_list<std::function<void()>> bodies)
+   {
+      custom::thread_pool pool;
+      for (const std::function<void()> & body : bodies)
+         pool.submit([this, &body]()
+         {
+            startMark();
+            body();
+         });
+      pool.wait();
+      startMark();
    }
    
    /*************************************************************
@@ -61,23 +193,37 @@ protected:
     *************************************************************/
    void report(const char * name)
    {    
+      std::ostringstream out;
+      std::lock_guard<std::mutex> guard(lock);
+
       // enumerate the failures, if there are any
       for (auto & test : tests)
          if (!test.second.empty())
          {
-            std::cerr << "\t" << test.first << "()\n";
+            out << "\t" << test.first << "()\n";
             for (auto & failure : test.second)
-               std::cerr << "\t\tline:"   << failure.lineNumber
+               out << "\t\tline:"   << failure.lineNumber
                          << " condition:" << failure.failure << "\n";
          }
 
+      // then the slow ones
+      double secondsTotal = 0.0;
+      for (auto & test : seconds)
+      {
+         secondsTotal += test.second;
+         if (test.second >= reportSecondsOver())
+            out << "\t" << test.first << "() took "
+                      << (int)(test.second * 1000.0 + 0.5) << "ms\n";
+      }
+
       // Name the test case
-      std::cerr << name << ":\t";
+      out << name << ":\t";
 
       // handle the no test case
       if (tests.empty())
       {
-         std::cerr << "There were no tests]\n";
+         out << "There were no tests]\n";
+         write(out.str());
          return;
       }
 
@@ -88,12 +234,14 @@ protected:
       double successRate = (double)numSuccess / (double)tests.size();
 
       // display the summary
-      std::cerr.setf(std::ios::fixed | std::ios::showpoint);
-      std::cerr.precision(1);
-      std::cerr << "There were "
+      out.setf(std::ios::fixed | std::ios::showpoint);
+      out.precision(1);
+      out << "There were "
          << tests.size()
          << " tests run for a success rate of: "
-         << (successRate * 100.0) << "%\n";
+         << (successRate * 100.0) << "%"
+         << " in " << (int)(secondsTotal * 1000.0 + 0.5) << "ms\n";
+      write(out.str());
 
    }
    
@@ -104,19 +252,10 @@ protected:
    void assertUnitParameters(bool condition, const char* conditionString,
                              int line, const char* func)
    {
+      AllocationScope::Pause paused;
       std::string sFunc(func);
-
-      if (!condition)
-      {
-         // add a failure to the list of failures
-         Failure failure{std::string(conditionString), line};
-         tests[sFunc].push_back(failure);
-      }
-      else
-      {
-         // this ensures there is a placeholder for the successful test
-         tests[sFunc];
-      }
+      mark(sFunc);
+      record(sFunc, condition, conditionString, line);
    }
    
    
@@ -129,19 +268,113 @@ protected:
                                      int lineOriginal, const char* funcOriginal,
                                      int lineCheck, const char* funcCheck)
    {
+      AllocationScope::Pause paused;
       std::string sFunc(funcOriginal);
-      
-      if (!condition)
+      mark(sFunc);
+      record(sFunc, condition, conditionString, lineOriginal);
+   }
+
+   /*************************************************************
+    * MEASURE
+    * Time body() until the mean is known to within precision
+    * (the standard error over the mean) or maxSeconds runs out.
+    * Each sample is a batch of calls long enough for the clock,
+    * about a millisecond. The batches that find that length also
+    * warm up the caches, and are not counted. There are always at
+    * least minSamples, however long a batch takes.
+    *************************************************************/
+   template <class Body>
+   timing measure(Body body, double precision = 0.01, double maxSeconds = 1.0)
+   {
+      const double minBatch = 1.0e6;     // ns
+      const size_t minSamples = 5;
+      clock::time_point start = clock::now();
+
+      // find how many calls make a batch
+      size_t numCalls = 1;
+      double ns = 0.0;
+      for (;;)
       {
-         // add a failure to the list of failures
-         Failure failure{std::string(conditionString), lineOriginal};
-         tests[sFunc].push_back(failure);
+         ns = timeBatch(body, numCalls);
+         if (ns >= minBatch || numCalls >= (size_t(1) << 30))
+            break;
+         numCalls *= ns > 0.0 && minBatch / ns < 16.0 ? (size_t)(minBatch / ns) + 1 : 16;
       }
-      else
+
+      // Welford's running mean and variance of ns per call
+      timing t = { 0.0, 0.0, 0, false };
+      double sumSquares = 0.0;
+      while (t.numSamples < minSamples ||
+             std::chrono::duration<double>(clock::now() - start).count() < maxSeconds)
       {
-         // this ensures there is a placeholder for the successful test
-         tests[sFunc];
+         double x = timeBatch(body, numCalls) / (double)numCalls;
+         t.numSamples++;
+         double delta = x - t.nsPerOp;
+         t.nsPerOp += delta / (double)t.numSamples;
+         sumSquares += delta * (x - t.nsPerOp);
+         if (t.numSamples >= minSamples)
+         {
+            t.nsStddev = std::sqrt(sumSquares / (double)(t.numSamples - 1));
+            double stdError = t.nsStddev / std::sqrt((double)t.numSamples);
+            if (stdError <= precision * t.nsPerOp)
+            {
+               t.stable = true;
+               break;
+            }
+         }
       }
+      return t;
+   }
+
+   /*************************************************************
+    * NOT SLOWER
+    * Whether measured takes at most ratio times the baseline. A
+    * timing that never settled, or has no samples, proves nothing,
+    * so it is never within the ceiling.
+    *************************************************************/
+   static bool notSlower(const timing & measured, const timing & baseline, double ratio)
+   {
+      return measured.stable && measured.numSamples > 0 &&
+             baseline.stable && baseline.numSamples > 0 &&
+             measured.nsPerOp <= ratio * baseline.nsPerOp;
+   }
+
+   /*************************************************************
+    * ASSERT NOT SLOWER PARAMETERS
+    * Fail if measured takes more than ratio times the baseline,
+    * or if either timing is not one to compare
+    *************************************************************/
+   void assertNotSlowerParameters(const timing & measured, const timing & baseline, double ratio,
+                                  const char * names, int line, const char * func)
+   {
+      std::ostringstream condition;
+      condition << names << ": ";
+      if (!measured.stable || measured.numSamples == 0)
+         condition << "the measured time did not settle in " << measured.numSamples << " samples";
+      else if (!baseline.stable || baseline.numSamples == 0)
+         condition << "the baseline time did not settle in " << baseline.numSamples << " samples";
+      else
+         condition << measured.nsPerOp << "ns is more than "
+                   << ratio << " x " << baseline.nsPerOp << "ns";
+      assertUnitParameters(notSlower(measured, baseline, ratio),
+                           condition.str().c_str(), line, func);
+   }
+
+private:
+   // the whole report at once, so two suites never interleave
+   static void write(const std::string & text)
+   {
+      std::lock_guard<std::mutex> guard(outputLock());
+      std::cerr << text;
+   }
+
+   template <class Body>
+   static double timeBatch(Body & body, size_t numCalls)
+   {
+      clock::time_point begin = clock::now();
+      for (size_t i = 0; i < numCalls; i++)
+         body();
+      return std::chrono::duration<double, std::nano>(clock::now() - begin).count();
    }
 };
 
@@ -15,6 +15,7 @@
  *    This will contain the class definition of:
  *        vector                 : A class that represents a Vector
  *        vector::iterator       : An interator through Vector
+ *        vector::const_iterator : A read-only interator through Vector
  * Author
  *    Stephen Costigan, Alexander Dohms, Jonathan Colwell, Shaun Crook
  ************************************************************************/
@@ -22,32 +23,67 @@
 #pragma once
 
 #include <cassert>  // because I am paranoid
+#include <algorithm> // for std::min
 #include <new>      // std::bad_alloc
+#include <stdexcept> // std::out_of_range
 #include <memory>   // for std::allocator
+#include <memory_resource> // for std::pmr::polymorphic_allocator
+#include <initializer_list> // for std::initializer_list
+#include <utility>  // for std::move
+#include <cstring>  // for std::memcpy
+#include <type_traits> // for std::is_trivially_copyable
+#include "instrument.h" // for default_instrument
+#include "growth.h"     // for growth::factor_2
+#include "contiguous_iterator.h" // for contiguous_iterator
 
 
 namespace custom
 {
 
 /*****************************************
- * VECTOR
- * Just like the std :: vector <T> class
+ * IS TRIVIALLY RELOCATABLE
+ * Can a T be moved to a new address with memcpy, leaving
+ * the old bytes behind without calling the destructor?
+ * True for anything trivially copyable. Specialize it
+ * for types that own memory through a plain pointer.
  ****************************************/
 template <typename T>
-class vector
+struct is_trivially_relocatable : std::is_trivially_copyable<T> {};
+
+/*****************************************
+ * VECTOR
+ * Just like the std :: vector <T> class.
+ * All memory comes from the allocator A, through
+ * std::allocator_traits, so any standard allocator works.
+ * The Instrument policy counts moves and reallocations;
+ * by default it counts nothing and takes no space.
+ * The Growth policy picks the new capacity when a
+ * push_back finds the buffer full.
+ ****************************************/
+template <typename T, typename A = std::allocator<T>, typename Instrument = default_instrument,
+          typename Growth = growth::factor_2>
+class vector : private Instrument
 {
+   typedef std::allocator_traits<A> traits;
+
 public:
+   typedef T      value_type;
+   typedef A      allocator_type;
+   typedef size_t size_type;
    
    // 
    // Construct
    //
 
    vector();
-   vector(size_t numElements                );
-   vector(size_t numElements, const T & t   );
-   vector(const std::initializer_list<T>& l );
+   explicit vector(const A & a);
+   vector(size_t numElements,                 const A & a = A());
+   vector(size_t numElements, const T & t,    const A & a = A());
+   vector(const std::initializer_list<T>& l,  const A & a = A());
    vector(const vector &  rhs);
+   vector(const vector &  rhs, const A & a);
    vector(      vector && rhs);
+   vector(      vector && rhs, const A & a);
    ~vector();
 
    //
@@ -56,9 +92,9 @@ public:
 
    void swap(vector& rhs)
    {
-       T* tempdata = rhs.data;
-       rhs.data = data;
-       data = tempdata;
+       T* tempdata = rhs.buffer;
+       rhs.buffer = buffer;
+       buffer = tempdata;
 
        size_t tempElements = rhs.numElements;
        rhs.numElements = numElements;
@@ -67,17 +103,34 @@ public:
        size_t tempCapacity = rhs.numCapacity;
        rhs.numCapacity = numCapacity;
        numCapacity = tempCapacity;
+
+       // swapping buffers between unequal allocators is undefined,
+       // just like std::vector
+       if (traits::propagate_on_container_swap::value)
+       {
+           using std::swap;
+           swap(alloc, rhs.alloc);
+       }
+       else
+           assert(alloc == rhs.alloc);
    }
    vector & operator = (const vector & rhs);
    vector& operator = (vector&& rhs);
 
+   A get_allocator() const { return alloc; }
+
    //
    // Iterator
    //
 
-   class iterator;
-   iterator       begin() { return iterator(data); }
-   iterator       end() { return iterator(data + numElements); }
+   typedef contiguous_iterator<T>       iterator;
+   typedef contiguous_iterator<const T> const_iterator;
+   iterator       begin()        { return iterator(buffer);                     }
+   iterator       end()          { return iterator(buffer + numElements);       }
+   const_iterator begin()  const { return const_iterator(buffer);               }
+   const_iterator end()    const { return const_iterator(buffer + numElements); }
+   const_iterator cbegin() const { return begin();                              }
+   const_iterator cend()   const { return end();                                }
 
    //
    // Access
@@ -89,6 +142,8 @@ public:
    const T& front() const;
          T& back();
    const T& back() const;
+         T* data()               { return buffer; } // nullptr until there is a buffer
+   const T* data() const         { return buffer; }
 
    //
    // Insert
@@ -96,6 +151,8 @@ public:
 
    void push_back(const T& t);
    void push_back(T&& t);
+   template <class ... Args>
+   T &  emplace_back(Args&& ... args);
    void reserve(size_t newCapacity);
    void resize(size_t newElements);
    void resize(size_t newElements, const T& t);
@@ -106,13 +163,16 @@ public:
 
    void clear()
    {
+       destroy(0, numElements);
        numElements = 0;
-       delete[] data;
    }
    void pop_back()
    {
        if(numElements > 0)
-        numElements--;
+       {
+           traits::destroy(alloc, buffer + --numElements);
+           shrinkIfSparse();
+       }
    }
    void shrink_to_fit();
 
@@ -123,6 +183,13 @@ public:
    size_t  size()          const { return numElements;}
    size_t  capacity()      const { return numCapacity;}
    bool    empty()         const { return size() == 0;}
+
+   //
+   // Instrument
+   //
+
+   instrument_stats stats() const { return Instrument::getStats(); }
+   void    reset_stats()          { Instrument::resetStats();      }
    
    // adjust the size of the buffer
    
@@ -133,21 +200,180 @@ public:
 #else
 private:
 #endif
+
+   T *  allocate(size_t num);             // get raw room for num elements
+   void deallocate(T * p, size_t num);    // free a buffer from allocate()
+   void destroy(size_t first, size_t last); // destroy the elements [first, last)
+   void reallocate(size_t newCapacity);   // move the elements to a new buffer
+   void relocateTo(T * dataNew, size_t newCapacity); // ... that the caller allocated
+   void freeAll();                        // destroy everything, free the buffer
+   void copyFrom(const vector & rhs);     // copy the elements, keep our allocator
+   void moveFrom(vector & rhs);           // move the elements, keep our allocator
+   void shrinkIfSparse();                 // give memory back if Growth says so
+
+   // grow the buffer where it is if the allocator knows how (mmap_allocator
+   // does), otherwise return nullptr and the caller copies
+   template <class Alloc>
+   static auto reallocateInPlace(Alloc & a, T * p, size_t oldNum, size_t newNum, int)
+      -> decltype(a.reallocate(p, oldNum, newNum))
+   {
+      return a.reallocate(p, oldNum, newNum);
+   }
+   template <class Alloc>
+   static T * reallocateInPlace(Alloc &, T *, size_t, size_t, long)
+   {
+      return nullptr;
+   }
+
+   // the capacity Growth wants after a pop_back(), if it has a
+   // shrink(); otherwise the capacity we have
+   template <class G>
+   static auto shrinkTo(size_t capacity, size_t size, int)
+      -> decltype(G::shrink(capacity, size, sizeof(T)))
+   {
+      return G::shrink(capacity, size, sizeof(T));
+   }
+   template <class G>
+   static size_t shrinkTo(size_t capacity, size_t, long)
+   {
+      return capacity;
+   }
    
-   T *  data;                 // user data, a dynamically-allocated array
+   T *  buffer;               // user data; only [0, numElements) is constructed
    size_t  numCapacity;       // the capacity of the array
    size_t  numElements;       // the number of items currently used
+   A    alloc;                // where the buffer came from
 };
 
+/*****************************************
+ * VECTOR :: ALLOCATE
+ * Get raw room for num elements from the allocator.
+ * Nothing is constructed: only the first numElements
+ * slots of a buffer ever hold a live T.
+ ****************************************/
+template <typename T, typename A, typename Instrument, typename Growth>
+T * vector <T, A, Instrument, Growth> :: allocate(size_t num)
+{
+    if (num == 0)
+        return nullptr;
+    return traits::allocate(alloc, num);
+}
+
+/*****************************************
+ * VECTOR :: DEALLOCATE
+ * Give a buffer back. Its elements must already be destroyed.
+ ****************************************/
+template <typename T, typename A, typename Instrument, typename Growth>
+void vector <T, A, Instrument, Growth> :: deallocate(T * p, size_t num)
+{
+    if (p != nullptr)
+        traits::deallocate(alloc, p, num);
+}
+
+/*****************************************
+ * VECTOR :: DESTROY
+ * Call the destructor on the live elements [first, last)
+ ****************************************/
+template <typename T, typename A, typename Instrument, typename Growth>
+void vector <T, A, Instrument, Growth> :: destroy(size_t first, size_t last)
+{
+    for (size_t i = first; i < last; i++)
+        traits::destroy(alloc, buffer + i);
+}
+
+/*****************************************
+ * VECTOR :: REALLOCATE
+ * Move the live elements into a buffer of newCapacity and
+ * free the old one. If T's move constructor might throw,
+ * they are copied instead: then, if a copy throws, the new
+ * buffer is thrown away and *this is untouched.
+ * Trivially relocatable elements are moved as raw bytes,
+ * by the allocator if it can, or else with one memcpy.
+ ****************************************/
+template <typename T, typename A, typename Instrument, typename Growth>
+void vector <T, A, Instrument, Growth> :: reallocate(size_t newCapacity)
+{
+    assert(newCapacity >= numElements);
+
+    if (is_trivially_relocatable<T>::value)
+    {
+        T * dataNew = nullptr;
+        if (buffer != nullptr && newCapacity != 0)
+            dataNew = reallocateInPlace(alloc, buffer, numCapacity, newCapacity, 0);
+        if (dataNew == nullptr)
+        {
+            dataNew = allocate(newCapacity);
+            if (numElements != 0)
+                std::memcpy((void *)dataNew, (const void *)buffer, numElements * sizeof(T));
+            deallocate(buffer, numCapacity);
+        }
+        this->onReallocate();
+        this->onMove(numElements);
+
+        buffer = dataNew;
+        numCapacity = newCapacity;
+        return;
+    }
+
+    T * dataNew = allocate(newCapacity);
+    try
+    {
+        relocateTo(dataNew, newCapacity);
+    }
+    catch (...)
+    {
+        deallocate(dataNew, newCapacity);
+        throw;
+    }
+}
+
+/*****************************************
+ * VECTOR :: RELOCATE TO
+ * Move (or, if the move might throw, copy) the live elements
+ * into dataNew and make it our buffer. If that throws, what
+ * was built in dataNew is destroyed and *this is untouched;
+ * dataNew itself still belongs to the caller.
+ ****************************************/
+template <typename T, typename A, typename Instrument, typename Growth>
+void vector <T, A, Instrument, Growth> :: relocateTo(T * dataNew, size_t newCapacity)
+{
+    size_t i = 0;
+    try
+    {
+        for (; i < numElements; i++)
+            traits::construct(alloc, dataNew + i, std::move_if_noexcept(buffer[i]));
+    }
+    catch (...)
+    {
+        while (i > 0)
+            traits::destroy(alloc, dataNew + --i);
+        throw;
+    }
+
+    destroy(0, numElements);
+    deallocate(buffer, numCapacity);
+    this->onReallocate();
+    this->onMove(numElements);
+
+    buffer = dataNew;
+    numCapacity = newCapacity;
+}
+
 /*****************************************
  * VECTOR :: DEFAULT constructors
  * Default constructor: set the number of elements,
  * construct each element, and copy the values over
  ****************************************/
-template <typename T>
-vector <T> :: vector(): numElements(0), numCapacity(0)
+template <typename T, typename A, typename Instrument, typename Growth>
+vector <T, A, Instrument, Growth> :: vector()
+    : buffer(nullptr), numCapacity(0), numElements(0), alloc()
+{
+}
+
+template <typename T, typename A, typename Instrument, typename Growth>
+vector <T, A, Instrument, Growth> :: vector(const A & a)
+    : buffer(nullptr), numCapacity(0), numElements(0), alloc(a)
 {
-   data = nullptr;
 }
 
 /*****************************************
@@ -155,29 +381,53 @@ vector <T> :: vector(): numElements(0), numCapacity(0)
  * non-default constructor: set the number of elements,
  * construct each element, and copy the values over
  ****************************************/
-template <typename T>
-vector <T> :: vector(size_t num, const T & t) 
+template <typename T, typename A, typename Instrument, typename Growth>
+vector <T, A, Instrument, Growth> :: vector(size_t num, const T & t, const A & a)
+    : buffer(nullptr), numCapacity(0), numElements(0), alloc(a)
 {
-    data = new T[num];
+    buffer = allocate(num);
     numCapacity = num;
-    numElements = num;
 
-    for (int i = 0; i < num; i++)
-        data[i] = t;
+    try
+    {
+        for (; numElements < num; numElements++)
+            traits::construct(alloc, buffer + numElements, t);
+    }
+    catch (...)
+    {
+        clear();
+        deallocate(buffer, numCapacity);
+        throw;
+    }
+    this->onMove(num);
 }
 
 /*****************************************
  * VECTOR :: INITIALIZATION LIST constructors
  * Create a vector with an initialization list.
  ****************************************/
-template <typename T>
-vector <T> :: vector(const std::initializer_list<T> & l) 
+template <typename T, typename A, typename Instrument, typename Growth>
+vector <T, A, Instrument, Growth> :: vector(const std::initializer_list<T> & l, const A & a)
+    : buffer(nullptr), numCapacity(0), numElements(0), alloc(a)
 {
+    buffer = allocate(l.size());
     numCapacity = l.size();
-    numElements = 0;
-    data = new T[numCapacity];
-    for (T const item : l)
-        data[numElements++] = item;
+
+    try
+    {
+        for (const T & item : l)
+        {
+            traits::construct(alloc, buffer + numElements, item);
+            numElements++;
+        }
+    }
+    catch (...)
+    {
+        clear();
+        deallocate(buffer, numCapacity);
+        throw;
+    }
+    this->onMove(numElements);
 }
 
 /*****************************************
@@ -185,94 +435,136 @@ vector <T> :: vector(const std::initializer_list<T> & l)
  * non-default constructor: set the number of elements,
  * construct each element, and copy the values over
  ****************************************/
-template <typename T>
-vector <T> :: vector(size_t num) 
+template <typename T, typename A, typename Instrument, typename Growth>
+vector <T, A, Instrument, Growth> :: vector(size_t num, const A & a)
+    : buffer(nullptr), numCapacity(0), numElements(0), alloc(a)
 {
-    if (num == 0) {
-        data = nullptr;
-        return;
+    buffer = allocate(num);
+    numCapacity = num;
+
+    try
+    {
+        for (; numElements < num; numElements++)
+            traits::construct(alloc, buffer + numElements);
+    }
+    catch (...)
+    {
+        clear();
+        deallocate(buffer, numCapacity);
+        throw;
     }
-    data = new T[num];
-    resize(num);
 }
 
 /*****************************************
  * VECTOR :: COPY CONSTRUCTOR
  * Allocate the space for numElements and
- * call the copy constructor on each element
+ * call the copy constructor on each element.
+ * The allocator decides what allocator the copy gets.
  ****************************************/
-template <typename T>
-vector <T> :: vector (const vector & rhs) 
+template <typename T, typename A, typename Instrument, typename Growth>
+vector <T, A, Instrument, Growth> :: vector (const vector & rhs)
+    : buffer(nullptr), numCapacity(0), numElements(0),
+      alloc(traits::select_on_container_copy_construction(rhs.alloc))
 {
-    if (rhs.data == nullptr) {
-        data = nullptr;
-        return;
-    }
-    
-    *this = rhs;
+    copyFrom(rhs);
+}
+
+template <typename T, typename A, typename Instrument, typename Growth>
+vector <T, A, Instrument, Growth> :: vector (const vector & rhs, const A & a)
+    : buffer(nullptr), numCapacity(0), numElements(0), alloc(a)
+{
+    copyFrom(rhs);
 }
 
 /*****************************************
  * VECTOR :: MOVE CONSTRUCTOR
  * Steal the values from the RHS and set it to zero.
+ * The allocator moves along with the buffer.
  ****************************************/
-template <typename T>
-vector <T> :: vector (vector && rhs)
+template <typename T, typename A, typename Instrument, typename Growth>
+vector <T, A, Instrument, Growth> :: vector (vector && rhs)
+    : alloc(std::move(rhs.alloc))
 {
-    data = rhs.data;
-    rhs.data = nullptr;
+    buffer = rhs.buffer;
+    rhs.buffer = nullptr;
 
     numElements = rhs.numElements;
     rhs.numElements = 0;
 
-    if (rhs.numCapacity > numCapacity)
-        numCapacity = rhs.numCapacity;
+    numCapacity = rhs.numCapacity;
     rhs.numCapacity = 0;
 }
 
+/*****************************************
+ * VECTOR :: MOVE CONSTRUCTOR with allocator
+ * We can only steal the buffer if our allocator can free it.
+ * Otherwise move the elements one at a time.
+ ****************************************/
+template <typename T, typename A, typename Instrument, typename Growth>
+vector <T, A, Instrument, Growth> :: vector (vector && rhs, const A & a)
+    : buffer(nullptr), numCapacity(0), numElements(0), alloc(a)
+{
+    if (alloc == rhs.alloc)
+        swap(rhs);
+    else
+        moveFrom(rhs);
+}
+
 /*****************************************
  * VECTOR :: DESTRUCTOR
  * Call the destructor for each element from 0..numElements
  * and then free the memory
  ****************************************/
-template <typename T>
-vector <T> :: ~vector()
+template <typename T, typename A, typename Instrument, typename Growth>
+vector <T, A, Instrument, Growth> :: ~vector()
 {
-    data = nullptr;
+    destroy(0, numElements);
+    deallocate(buffer, numCapacity);
+    buffer = nullptr;
     numCapacity = 0;
-    if (numElements > 0) {
-        numElements = 0; // Set to 0
-    }
-    delete[] data;
+    numElements = 0;
 }
 
 /***************************************
  * VECTOR :: RESIZE
  * This method will adjust the size to newElements.
  * This will either grow or shrink newElements.
+ * New elements are constructed in place; removed
+ * elements are destroyed.
  *     INPUT  : newCapacity the size of the new buffer
  *     OUTPUT :
  **************************************/
-template <typename T>
-void vector <T> :: resize(size_t newElements)
+template <typename T, typename A, typename Instrument, typename Growth>
+void vector <T, A, Instrument, Growth> :: resize(size_t newElements)
 {
+    if (newElements < numElements)
+    {
+        destroy(newElements, numElements);
+        numElements = newElements;
+        return;
+    }
+
     reserve(newElements);
 
-    for (int i = numElements; i < newElements; i++) {
-        data[i] = 0;
-    }
-    numElements = newElements;
+    for (; numElements < newElements; numElements++)
+        traits::construct(alloc, buffer + numElements);
 }
 
-template <typename T>
-void vector <T> :: resize(size_t newElements, const T & t)
+template <typename T, typename A, typename Instrument, typename Growth>
+void vector <T, A, Instrument, Growth> :: resize(size_t newElements, const T & t)
 {
+    if (newElements < numElements)
+    {
+        destroy(newElements, numElements);
+        numElements = newElements;
+        return;
+    }
+
     reserve(newElements);
 
-    for (int i = numElements; i < newElements; i++) {
-        data[i] = t;
-    }
-    numElements = newElements;
+    this->onMove(newElements - numElements);
+    for (; numElements < newElements; numElements++)
+        traits::construct(alloc, buffer + numElements, t);
 }
 
 /***************************************
@@ -283,83 +575,96 @@ void vector <T> :: resize(size_t newElements, const T & t)
  *     INPUT  : newCapacity the size of the new buffer
  *     OUTPUT :
  **************************************/
-template <typename T>
-void vector <T> :: reserve(size_t newCapacity)
+template <typename T, typename A, typename Instrument, typename Growth>
+void vector <T, A, Instrument, Growth> :: reserve(size_t newCapacity)
 {
     if (newCapacity <= numCapacity)
         return;
 
-    T* dataNew = new T[newCapacity];
-
-    for (int i = 0; i < numElements; i++) {
-        dataNew[i] = data[i];
-    }
-    delete[] data;
-
-    data = dataNew;
-    numCapacity = newCapacity;
+    reallocate(newCapacity);
 }
 
 /***************************************
  * VECTOR :: SHRINK TO FIT
- * Get rid of any extra capacity
+ * Get rid of any extra capacity. The allocator has to be
+ * told the true size of a buffer when it is freed, so
+ * the elements go into a buffer of exactly the right size.
  *     INPUT  :
  *     OUTPUT :
  **************************************/
-template <typename T>
-void vector <T> :: shrink_to_fit()
+template <typename T, typename A, typename Instrument, typename Growth>
+void vector <T, A, Instrument, Growth> :: shrink_to_fit()
 {
-    if (numElements == 0) {
-        numCapacity = 0;
-        data = NULL;
+    if (numElements == numCapacity)
         return;
-    }
 
-    numCapacity = numElements;
+    reallocate(numElements);
 }
 
 
+/***************************************
+ * VECTOR :: SHRINK IF SPARSE
+ * After a pop_back(), move into the smaller buffer the Growth
+ * policy asks for, if it asks. This is only to save memory,
+ * so if the move throws we keep the buffer we have; the
+ * reallocation leaves *this untouched when it throws.
+ **************************************/
+template <typename T, typename A, typename Instrument, typename Growth>
+void vector <T, A, Instrument, Growth> :: shrinkIfSparse()
+{
+    size_t newCapacity = shrinkTo<Growth>(numCapacity, numElements, 0);
+    if (newCapacity >= numCapacity)
+        return;
+
+    try
+    {
+        reallocate(newCapacity);
+    }
+    catch (...)
+    {
+    }
+}
 
 /*****************************************
  * VECTOR :: SUBSCRIPT
  * Read-Write access
  ****************************************/
-template <typename T>
-T & vector <T> :: operator [] (size_t index)
+template <typename T, typename A, typename Instrument, typename Growth>
+T & vector <T, A, Instrument, Growth> :: operator [] (size_t index)
 {
-    return data[index];
+    return buffer[index];
 }
 
 /******************************************
  * VECTOR :: SUBSCRIPT
  * Read-Write access
  *****************************************/
-template <typename T>
-const T & vector <T> :: operator [] (size_t index) const
+template <typename T, typename A, typename Instrument, typename Growth>
+const T & vector <T, A, Instrument, Growth> :: operator [] (size_t index) const
 {
-    return data[index];
+    return buffer[index];
 }
 
 /*****************************************
  * VECTOR :: FRONT
  * Read-Write access
  ****************************************/
-template <typename T>
-T & vector <T> :: front()
+template <typename T, typename A, typename Instrument, typename Growth>
+T & vector <T, A, Instrument, Growth> :: front()
 {
    
-    return data[0];
+    return buffer[0];
 }
 
 /******************************************
  * VECTOR :: FRONT
  * Read-Write access
  *****************************************/
-template <typename T>
-const T & vector <T> :: front() const
+template <typename T, typename A, typename Instrument, typename Growth>
+const T & vector <T, A, Instrument, Growth> :: front() const
 {
     if(size() > 0)
-        return data[0]; 
+        return buffer[0]; 
     throw std::out_of_range("std:out_of_range");
 }
 
@@ -367,20 +672,20 @@ const T & vector <T> :: front() const
  * VECTOR :: FRONT
  * Read-Write access
  ****************************************/
-template <typename T>
-T & vector <T> :: back()
+template <typename T, typename A, typename Instrument, typename Growth>
+T & vector <T, A, Instrument, Growth> :: back()
 {
-    return data[numElements - 1];
+    return buffer[numElements - 1];
 }
 
 /******************************************
  * VECTOR :: FRONT
  * Read-Write access
  *****************************************/
-template <typename T>
-const T & vector <T> :: back() const
+template <typename T, typename A, typename Instrument, typename Growth>
+const T & vector <T, A, Instrument, Growth> :: back() const
 {
-    return data[numElements - 1];
+    return buffer[numElements - 1];
 }
 
 /***************************************
@@ -391,156 +696,222 @@ const T & vector <T> :: back() const
  *     INPUT  : 't' the new element to be added
  *     OUTPUT : *this
  **************************************/
-template <typename T>
-void vector <T> :: push_back (const T & t)
+template <typename T, typename A, typename Instrument, typename Growth>
+void vector <T, A, Instrument, Growth> :: push_back (const T & t)
 {
-    if (capacity() == 0)
-        reserve(1);
-
-    if (size() == capacity())
-        reserve(this->numCapacity * 2);
-
-    data[numElements++] = t;
+    emplace_back(t);
 }
 
-template <typename T>
-void vector <T> ::push_back(T && t)
+template <typename T, typename A, typename Instrument, typename Growth>
+void vector <T, A, Instrument, Growth> ::push_back(T && t)
 {
-    if (capacity() == 0)
-        reserve(1);
+    emplace_back(std::move(t));
+}
 
-    if (size() == capacity())
-        reserve(this->numCapacity * 2);
+/***************************************
+ * VECTOR :: EMPLACE BACK
+ * Construct a new element at the end, in place, from args.
+ * The args may refer to one of our own elements, so when
+ * the buffer has to grow, the new element is built before
+ * the old elements are moved out from under it.
+ *     INPUT  : args for T's constructor
+ *     OUTPUT : the new element
+ **************************************/
+template <typename T, typename A, typename Instrument, typename Growth>
+template <class ... Args>
+T & vector <T, A, Instrument, Growth> :: emplace_back(Args&& ... args)
+{
+    if (size() < capacity())
+        traits::construct(alloc, buffer + numElements, std::forward<Args>(args)...);
+    else if (is_trivially_relocatable<T>::value)
+    {
+        // build it off to the side; it can be moved in as bytes
+        alignas(T) unsigned char element[sizeof(T)];
+        traits::construct(alloc, (T *)element, std::forward<Args>(args)...);
+        try
+        {
+            reserve(Growth::next(numCapacity, sizeof(T)));
+        }
+        catch (...)
+        {
+            traits::destroy(alloc, (T *)element);
+            throw;
+        }
+        std::memcpy((void *)(buffer + numElements), (const void *)element, sizeof(T));
+    }
+    else
+    {
+        // build it in the new buffer before the old one goes away
+        size_t newCapacity = Growth::next(numCapacity, sizeof(T));
+        T * dataNew = allocate(newCapacity);
+        try
+        {
+            traits::construct(alloc, dataNew + numElements, std::forward<Args>(args)...);
+        }
+        catch (...)
+        {
+            deallocate(dataNew, newCapacity);
+            throw;
+        }
+        try
+        {
+            relocateTo(dataNew, newCapacity);
+        }
+        catch (...)
+        {
+            traits::destroy(alloc, dataNew + numElements);
+            deallocate(dataNew, newCapacity);
+            throw;
+        }
+    }
 
-    data[numElements++] = t;
-   
+    numElements++;
+    this->onMove();
+    return buffer[numElements - 1];
 }
 
 /***************************************
  * VECTOR :: ASSIGNMENT
  * This operator will copy the contents of the
- * rhs onto *this, growing the buffer as needed
+ * rhs onto *this, growing the buffer as needed.
+ * If the allocator says so, it is copied too; then
+ * our old buffer has to go back to our old allocator.
  *     INPUT  : rhs the vector to copy from
  *     OUTPUT : *this
  **************************************/
-template <typename T>
-vector <T> & vector <T> :: operator = (const vector & rhs)
+template <typename T, typename A, typename Instrument, typename Growth>
+vector <T, A, Instrument, Growth> & vector <T, A, Instrument, Growth> :: operator = (const vector & rhs)
 {
-    this->numElements = 0;
-
-    if (rhs.capacity() == 0) {
-        numCapacity = 0;
-        data = nullptr;
+    if (this == &rhs)
         return *this;
-    }
-    data = new T[rhs.numCapacity];
 
-    if (numCapacity < rhs.numElements)
-        resize(rhs.numElements);
-   
-    numElements = rhs.numElements;
-
-    for (int i = 0; i < numElements; ++i)
-        data[i] = rhs.data[i];
+    if (traits::propagate_on_container_copy_assignment::value)
+    {
+        if (alloc != rhs.alloc)
+            freeAll();
+        alloc = rhs.alloc;
+    }
 
+    copyFrom(rhs);
     return *this;
 }
-template <typename T>
-vector <T>& vector <T> :: operator = (vector&& rhs)
+
+/***************************************
+ * VECTOR :: FREE ALL
+ * Destroy every element and give the buffer back
+ **************************************/
+template <typename T, typename A, typename Instrument, typename Growth>
+void vector <T, A, Instrument, Growth> :: freeAll()
 {
-    this->numElements = 0;
+    destroy(0, numElements);
+    deallocate(buffer, numCapacity);
+    buffer = nullptr;
+    numCapacity = numElements = 0;
+}
 
-    if (rhs.capacity() == 0) {
-        numCapacity = 0;
-        data = nullptr;
-        return *this;
+/***************************************
+ * VECTOR :: COPY FROM
+ * Copy the rhs's elements into our buffer, only getting
+ * a new buffer if ours is too small. Elements we already
+ * have are assigned; the rest are copy-constructed.
+ **************************************/
+template <typename T, typename A, typename Instrument, typename Growth>
+void vector <T, A, Instrument, Growth> :: copyFrom(const vector & rhs)
+{
+    if (rhs.numElements > numCapacity) {
+        T* dataNew = allocate(rhs.numElements);
+        size_t i = 0;
+        try
+        {
+            for (; i < rhs.numElements; i++)
+                traits::construct(alloc, dataNew + i, rhs.buffer[i]);
+        }
+        catch (...)
+        {
+            while (i > 0)
+                traits::destroy(alloc, dataNew + --i);
+            deallocate(dataNew, rhs.numElements);
+            throw;
+        }
+        freeAll();
+        buffer = dataNew;
+        numCapacity = numElements = rhs.numElements;
     }
-    data = new T[rhs.numCapacity];
-    numElements = rhs.numElements;
-
-    if (numCapacity < rhs.numElements)
-        resize(rhs.numElements);
+    else
+    {
+        size_t numAssign = std::min(numElements, rhs.numElements);
+        for (size_t i = 0; i < numAssign; ++i)
+            buffer[i] = rhs.buffer[i];
+        destroy(rhs.numElements, numElements);
+        for (size_t i = numElements; i < rhs.numElements; ++i)
+            traits::construct(alloc, buffer + i, rhs.buffer[i]);
+        numElements = rhs.numElements;
+    }
+    this->onMove(numElements);
+}
 
-    for (int i = 0; i < numElements; ++i)
-        data[i] = std::move(rhs.data[i]);
+/***************************************
+ * VECTOR :: MOVE FROM
+ * Move the rhs's elements into our buffer one at a time,
+ * for when our allocator cannot free the rhs's buffer
+ **************************************/
+template <typename T, typename A, typename Instrument, typename Growth>
+void vector <T, A, Instrument, Growth> :: moveFrom(vector & rhs)
+{
+    if (rhs.numElements > numCapacity) {
+        freeAll();
+        buffer = allocate(rhs.numElements);
+        numCapacity = rhs.numElements;
+    }
+    else
+        clear();
 
-    return *this;
+    for (; numElements < rhs.numElements; numElements++)
+        traits::construct(alloc, buffer + numElements, std::move(rhs.buffer[numElements]));
+    this->onMove(numElements);
+    rhs.clear();
 }
 
-/**************************************************
- * VECTOR ITERATOR
- * An iterator through vector.  You only need to
- * support the following:
- *   1. Constructors (default and copy)
- *   2. Not equals operator
- *   3. Increment (prefix and postfix)
- *   4. Dereference
- * This particular iterator is a bi-directional meaning
- * that ++ and -- both work.  Not all iterators are that way.
- *************************************************/
-template <typename T>
-class vector <T> :: iterator
+/***************************************
+ * VECTOR :: MOVE ASSIGNMENT
+ * Free our buffer and steal the rhs's. That is only
+ * possible if our allocator takes over (propagates) or
+ * can free what the rhs's allocator gave out (equal).
+ * Otherwise move the elements one at a time.
+ **************************************/
+template <typename T, typename A, typename Instrument, typename Growth>
+vector <T, A, Instrument, Growth>& vector <T, A, Instrument, Growth> :: operator = (vector&& rhs)
 {
-public:
-   // constructors, destructors, and assignment operator
-    iterator()                          { this->p = 0; }
-    iterator(T* p)                      { this->p = p; }
-    iterator(const iterator& rhs)       { this->p = rhs.p; }
-    iterator& operator = (const iterator& rhs)
+    if (this == &rhs)
+        return *this;
+
+    if (!traits::propagate_on_container_move_assignment::value && alloc != rhs.alloc)
     {
-        this->p = rhs.p;
+        moveFrom(rhs);
         return *this;
     }
-   
-   // equals, not equals operator
-   bool operator != (const iterator & rhs) const { return rhs.p != p; }
-   bool operator == (const iterator & rhs) const { return rhs.p == p; }
-   
-   // dereference operator
-   T & operator * ()
-   {
-       return *p;
-   }
-   
-   // prefix increment
-   iterator & operator ++ ()
-   {
-       p++;
-       return *this;
-   }
-   
-   // postfix increment
-   iterator operator ++ (int postfix)
-   {
-       iterator i = p;
-       p++;
-       return i;
-   }
-   
-   // prefix decrement
-   iterator & operator -- ()
-   {
-       if (p > 0)
-           p--;
-       return *this;
-   }
-   
-   // postfix decrement
-   iterator operator -- (int postfix)
-   {
-       iterator i = p;
-       if (p > 0)
-           p--;
-       return i;
-   }
-   
-#ifdef DEBUG // make this visible to the unit tests
-public:
-#else
-private:
-#endif
-   T * p;
-};
 
+    freeAll();
+    if (traits::propagate_on_container_move_assignment::value)
+        alloc = std::move(rhs.alloc);
+
+    buffer = rhs.buffer;
+    rhs.buffer = nullptr;
+
+    numElements = rhs.numElements;
+    rhs.numElements = 0;
+
+    numCapacity = rhs.numCapacity;
+    rhs.numCapacity = 0;
+
+    return *this;
+}
+
+namespace pmr
+{
+   // a vector whose memory comes from a std::pmr::memory_resource
+   template <typename T, typename Instrument = default_instrument>
+   using vector = custom::vector <T, std::pmr::polymorphic_allocator<T>, Instrument>;
+}
 
 } // namespace custom